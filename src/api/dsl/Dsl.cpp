@@ -261,8 +261,11 @@ PlanPtr Query::compile(std::unique_ptr<QueryContext> qc) {
 
   // check the index are correct values and convert 1-based sort keys into 0-based keys for internal usage
   std::vector<size_t> zbSorts;
+  std::vector<bool> descs;
   vector_reserve(zbSorts, sorts_.size(), "Dsl.compile.zbSorts");
-  for (size_t index : sorts_) {
+  descs.reserve(sorts_.size());
+  for (size_t i = 0; i < sorts_.size(); ++i) {
+    auto index = sorts_.at(i);
     auto zbIndex = index - 1;
     if (index == 0 || index > numOutputFields) {
       LOG(ERROR) << "sort by column is out of range: " << index;
@@ -270,6 +273,7 @@ PlanPtr Query::compile(std::unique_ptr<QueryContext> qc) {
     }
 
     zbSorts.push_back(zbIndex);
+    descs.push_back(i < sortTypes_.size() && sortTypes_.at(i) == SortType::DESC);
   }
 
   // build block level compute phase
@@ -340,8 +344,9 @@ PlanPtr Query::compile(std::unique_ptr<QueryContext> qc) {
     .keys(std::move(zbKeys))
     .compute(std::move(fields))
     .aggregate(numAggColumns, std::move(aggColumns))
-    .sort(std::move(zbSorts), sortType_ == SortType::DESC)
-    .limit(limit_);
+    .sort(std::move(zbSorts), std::move(descs))
+    .limit(limit_)
+    .bind();
 
   // partial aggrgation, keys and agg methods
   auto node = std::make_unique<NodePhase>(std::move(block));
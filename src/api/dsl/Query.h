@@ -78,7 +78,7 @@ public:
                     selects_{ std::move(q.selects_) },
                     groups_{ std::move(q.groups_) },
                     sorts_{ std::move(q.sorts_) },
-                    sortType_{ q.sortType_ },
+                    sortTypes_{ std::move(q.sortTypes_) },
                     limit_{ q.limit_ } {}
   Query(Query&&) = default;
   Query(const Query&) = delete;
@@ -123,8 +123,16 @@ public:
   }
 
   Query& sortby(std::vector<size_t> sorts, SortType type = SortType::ASC) {
-    sorts_ = sorts;
-    sortType_ = type;
+    sortTypes_.assign(sorts.size(), type);
+    sorts_ = std::move(sorts);
+    return *this;
+  }
+
+  // sort by multiple columns with its own order each
+  Query& sortby(std::vector<size_t> sorts, std::vector<SortType> types) {
+    N_ENSURE_EQ(sorts.size(), types.size(), "every sort column expects a sort type");
+    sorts_ = std::move(sorts);
+    sortTypes_ = std::move(types);
     return *this;
   }
 
@@ -154,7 +162,7 @@ public:
 
   // sorting information
   std::vector<size_t> sorts_;
-  SortType sortType_;
+  std::vector<SortType> sortTypes_;
 
   // limit the results to return
   size_t limit_;
@@ -15,9 +15,11 @@
  */
 
 #include <fmt/format.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <map>
 
 #include "Test.hpp"
 
@@ -29,6 +31,7 @@
 #include "common/Folly.h"
 #include "common/Likely.h"
 #include "common/Memory.h"
+#include "execution/core/NodeExecutor.h"
 #include "execution/core/ServerExecutor.h"
 #include "execution/meta/TableService.h"
 #include "meta/NBlock.h"
@@ -36,6 +39,10 @@
 #include "surface/MockSurface.h"
 #include "type/Serde.h"
 
+DECLARE_bool(STREAM_QUERY);
+DECLARE_uint64(STREAM_BLOCKS);
+DECLARE_uint64(TOP_SORT_SCALE);
+
 namespace nebula {
 namespace api {
 namespace test {
@@ -665,6 +672,97 @@ TEST(ApiTest, TestAccessControl) {
   }
 }
 
+TEST(ApiTest, TestStreamingMerge) {
+  auto data = genData();
+
+  auto ms = TableService::singleton();
+  auto tableName = std::get<0>(data);
+  auto start = std::get<1>(data);
+  auto end = std::get<2>(data);
+
+  // run the same aggregation with or without streaming partial results
+  auto run = [&](bool streaming) {
+    gflags::FlagSaver saver;
+    FLAGS_STREAM_QUERY = streaming;
+    // every finished block is sent as a partial result
+    FLAGS_STREAM_BLOCKS = 1;
+
+    auto query = table(tableName, ms)
+                   .where(col("_time_") > start && col("_time_") < end)
+                   .select(
+                     col("event"),
+                     count(col("value")).as("total"))
+                   .groupby({ 1 });
+
+    auto plan = query.compile(QueryContext::def());
+    plan->setWindow({ start, end });
+    plan->setTableVersion("v1");
+
+    folly::CPUThreadPoolExecutor pool{ 8 };
+    auto result = ServerExecutor(nebula::meta::NNode::local().toString()).execute(pool, plan);
+
+    // all nodes finished, the result is complete
+    const auto& stats = plan->ctx().stats();
+    EXPECT_EQ(stats.nodesDone, stats.nodesQuery);
+    LOG(INFO) << "streaming=" << streaming << ", " << stats.toString();
+
+    std::map<std::string, int32_t> totals;
+    while (result->hasNext()) {
+      const auto& row = result->next();
+      totals[std::string(row.readString("event"))] = row.readInt("total");
+    }
+
+    return std::make_pair(totals, stats.blocksScan);
+  };
+
+  auto expected = run(false);
+  auto streamed = run(true);
+  EXPECT_GT(expected.first.size(), 0);
+  EXPECT_EQ(streamed.first, expected.first);
+  EXPECT_EQ(streamed.second, expected.second);
+}
+
+TEST(ApiTest, TestStreamingTopSort) {
+  auto data = genData();
+
+  auto ms = TableService::singleton();
+  auto tableName = std::get<0>(data);
+  auto start = std::get<1>(data);
+  auto end = std::get<2>(data);
+
+  gflags::FlagSaver saver;
+  FLAGS_STREAM_BLOCKS = 1;
+  FLAGS_TOP_SORT_SCALE = 2;
+
+  constexpr auto limit = 3;
+  auto query = table(tableName, ms)
+                 .where(col("_time_") > start && col("_time_") < end)
+                 .select(
+                   col("event"),
+                   count(col("value")).as("total"))
+                 .groupby({ 1 })
+                 .sortby({ 2 }, SortType::DESC)
+                 .limit(limit);
+
+  auto plan = query.compile(QueryContext::def());
+  plan->setWindow({ start, end });
+  plan->setTableVersion("v1");
+
+  // a remote node executor cuts every chunk it streams by top sort
+  folly::CPUThreadPoolExecutor pool{ 8 };
+  nebula::execution::core::NodeExecutor executor(nebula::execution::BlockManager::init());
+  size_t chunks = 0;
+  auto sink = [&chunks](nebula::surface::RowCursorPtr cursor, const nebula::execution::QueryStats&) {
+    EXPECT_LE(cursor->size(), limit * FLAGS_TOP_SORT_SCALE);
+    ++chunks;
+    return true;
+  };
+
+  EXPECT_TRUE(executor.stream(pool, plan, sink));
+
+  EXPECT_GT(chunks, 0);
+}
+
 } // namespace test
 } // namespace api
 } // namespace nebula
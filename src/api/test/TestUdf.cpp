@@ -30,9 +30,12 @@
 #include "api/udf/Pct.h"
 #include "api/udf/Prefix.h"
 #include "api/udf/Tpm.h"
+#include "memory/keyed/HashFlat.h"
 #include "surface/DataSurface.h"
 #include "surface/MockSurface.h"
+#include "surface/StaticData.h"
 #include "surface/eval/ValueEval.h"
+#include "type/Serde.h"
 
 namespace nebula {
 namespace api {
@@ -157,6 +160,51 @@ TEST(UDFTest, TestILike) {
   }
 }
 
+TEST(UDFTest, TestLikePattern) {
+  // reference: recursive char by char matcher
+  std::function<bool(std::string_view, std::string_view)> ref = [&ref](std::string_view s, std::string_view p) -> bool {
+    if (p.empty()) {
+      return s.empty();
+    }
+
+    if (p[0] == '%') {
+      for (size_t i = 0; i <= s.size(); ++i) {
+        if (ref(s.substr(i), p.substr(1))) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    return !s.empty() && s[0] == p[0] && ref(s.substr(1), p.substr(1));
+  };
+
+  std::vector<std::string> sources{
+    "",
+    "a",
+    "abcabc",
+    "the quick brown fox jumps over the lazy dog, error: connection refused by remote peer",
+    "ERROR: disk full - retry error count exceeded the limit of 32 attempts"
+  };
+  std::vector<std::string> patterns{
+    "", "%", "%%", "a", "a%", "%a", "%a%", "a%a", "abc%abc", "%bc%ab%",
+    "%error%", "%error%refused%", "the%dog%peer", "%retry%error%limit%", "%limit", "%32 attempts"
+  };
+
+  for (const auto& p : patterns) {
+    nebula::api::udf::LikePattern cs(p);
+    for (const auto& s : sources) {
+      EXPECT_EQ(cs.match(s), ref(s, p)) << s << " like " << p;
+    }
+  }
+
+  // case insensitive on long source to go through vector folding and search
+  nebula::api::udf::LikePattern ci("%ERROR%Count%LIMIT of 32%", false);
+  EXPECT_TRUE(ci.match(sources.at(4)));
+  EXPECT_FALSE(ci.match(sources.at(3)));
+}
+
 TEST(UDFTest, TestPrefix) {
   std::vector<std::tuple<std::string, std::string, bool>> data{
     { "abcdefg", "abc", true },
@@ -677,8 +725,9 @@ TEST(UDFTest, TestHist) {
   // we will ask itself for finalize
   auto jsonStr = (std::string)(th1->finalize());
   nebula::common::ExtendableSlice slice(1024);
-  EXPECT_EQ(th1->serialize(slice, 12), 287);
-  EXPECT_EQ(th1->load(slice, 12), 287);
+  // 12 buckets: [count varint, sum double], 180 values land in the overflow bucket
+  EXPECT_EQ(th1->serialize(slice, 12), 110);
+  EXPECT_EQ(th1->load(slice, 12), 110);
   CType::NativeType load = th1->finalize();
   EXPECT_EQ(load, jsonStr);
 }
@@ -727,6 +776,15 @@ TEST(UDFTest, TestTpm) {
   //   "[{\"name\":\"C\",\"value\":2},{\"name\":\"D\",\"value\":2}]}]}]}";
   CType::NativeType json = sketch->finalize();
 
+  // binary serde keeps the same tree, children order of hash frames may differ
+  {
+    nebula::common::ExtendableSlice slice(1024);
+    auto size = sketch->serialize(slice, 8);
+    auto loaded = tpm.sketch();
+    EXPECT_EQ(loaded->load(slice, 8), size);
+    EXPECT_EQ(loaded->finalize().size(), json.size());
+  }
+
 #define VERIFY_C_D                                        \
   EXPECT_EQ(c["name"], "C");                              \
   EXPECT_EQ(c["value"], 2);                               \
@@ -840,6 +898,73 @@ TEST(UDFTest, TestCardinality) {
   LOG(INFO) << "cardinality: " << cardinality_est;
 }
 
+TEST(UDFTest, TestInlineReduce) {
+  using nebula::type::Kind;
+  using SumType = nebula::api::udf::Sum<Kind::INTEGER>;
+  using AvgType = nebula::api::udf::Avg<Kind::INTEGER>;
+  using MinType = nebula::api::udf::Min<Kind::INTEGER>;
+  using CountType = nebula::api::udf::Count<Kind::INTEGER>;
+
+  // key by event, aggregate on id
+  auto schema = nebula::type::TypeSerializer::from("ROW<event:string, s:int, a:int, m:int, c:int>");
+  auto v = std::make_shared<nebula::api::dsl::ConstExpression<int32_t>>(0);
+  nebula::surface::eval::Fields f;
+  f.reserve(5);
+  f.emplace_back(nebula::surface::eval::constant(0));
+  f.emplace_back(std::make_unique<SumType>("s", v->asEval()));
+  f.emplace_back(std::make_unique<AvgType>("a", v->asEval()));
+  f.emplace_back(std::make_unique<MinType>("m", v->asEval()));
+  f.emplace_back(std::make_unique<CountType>("c", v->asEval()));
+  for (size_t i = 1; i < f.size(); ++i) {
+    EXPECT_NE(f.at(i)->reduce(), nebula::surface::eval::Reduce::NONE);
+  }
+
+  constexpr auto groups = 3;
+  constexpr auto rows = 30;
+  nebula::memory::keyed::HashFlat hf(schema, f);
+  for (auto i = 0; i < rows; ++i) {
+    nebula::surface::StaticRow row{ 0, i, fmt::format("e{0}", i % groups), nullptr, false, 0, 0, 0 };
+    EXPECT_EQ(hf.update(row), i >= groups);
+  }
+  EXPECT_EQ(hf.getRows(), groups);
+
+  // inline states are loaded into sketches to finalize, group g has values g, g+3, ..., g+27
+  const auto verify = [](const nebula::surface::RowData& r, int times) {
+    const auto g = r.readString(0).back() - '0';
+    const int64_t sum = (g * 10 + 135) * times;
+    EXPECT_EQ(std::static_pointer_cast<SumType::BaseAggregator>(r.getAggregator(1))->finalize(), sum);
+    EXPECT_EQ(std::static_pointer_cast<AvgType::BaseAggregator>(r.getAggregator(2))->finalize(), g + 13);
+    EXPECT_EQ(std::static_pointer_cast<MinType::BaseAggregator>(r.getAggregator(3))->finalize(), g);
+    EXPECT_EQ(std::static_pointer_cast<CountType::BaseAggregator>(r.getAggregator(4))->finalize(), 10 * times);
+  };
+
+  for (auto i = 0; i < groups; ++i) {
+    verify(hf.row(i), 1);
+  }
+
+  // states go over the wire as they are and mix with another hash flat in binary
+  auto size = hf.prepareSerde();
+  auto buffer = static_cast<NByte*>(nebula::common::Pool::getDefault().allocate(size));
+  EXPECT_EQ(size, hf.serialize(buffer));
+  nebula::memory::keyed::FlatBuffer wire(schema, f, buffer, size);
+  EXPECT_EQ(wire.getRows(), groups);
+
+  nebula::memory::keyed::HashFlat merged(schema, f);
+  for (auto k = 0; k < 2; ++k) {
+    for (size_t i = 0; i < wire.getRows(); ++i) {
+      merged.update(wire, i);
+    }
+  }
+
+  EXPECT_EQ(merged.getRows(), groups);
+  for (auto i = 0; i < groups; ++i) {
+    verify(wire.row(i), 1);
+    verify(merged.row(i), 2);
+  }
+
+  nebula::common::Pool::getDefault().free(buffer, size);
+}
+
 } // namespace test
 } // namespace api
 } // namespace nebula
\ No newline at end of file
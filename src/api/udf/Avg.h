@@ -55,8 +55,8 @@ class Avg : public BaseType {
 public:
   using InputType = typename BaseType::InputType;
   using NativeType = typename BaseType::NativeType;
-  using StoreType = typename std::conditional_t<std::is_floating_point_v<InputType>, double,
-                                                std::conditional_t<std::is_same_v<InputType, int128_t>, int128_t, int64_t>>;
+  // the same store type as its inline state
+  using StoreType = typename nebula::surface::eval::Reducer<nebula::surface::eval::Reduce::AVG, Traits::Type, IK>::StoreType;
   using BaseAggregator = typename BaseType::BaseAggregator;
 
 public:
@@ -119,7 +119,9 @@ public:
                std::move(expr),
                []() -> std::shared_ptr<Aggregator> {
                  return std::make_shared<Aggregator>();
-               }) {}
+               }) {
+    this->reduce(nebula::surface::eval::Reduce::AVG);
+  }
 
   virtual ~Avg() = default;
 };
@@ -16,8 +16,6 @@
 
 #pragma once
 
-#include <lz4.h>
-
 #include "common/HyperLogLog.h"
 #include "surface/eval/UDF.h"
 
@@ -35,15 +33,11 @@
  * 
  * In the version 1 implementation, it only supports #1.
  *
- * HLL in chosen precision might be large (default log-size 20 implies 1MB store for each sketch).
+ * HLL in chosen precision might be large (default log-size 16 implies 64KB store for each sketch).
  * In a group by aggregation scenario, we may have thousands of this for each key.
- * This imposes a risk for heavy memory usage exhausting the resources.
- * There are two options to address this concern:
- * 1. when working on local node, we can use auto-growing hash set to replace it,
- *    unless the set outgrows the store size (1MB). This makes HLL used only when it's needed.
- * 2. we reserve by the log-size because we want to support some level of scale, but it's not flexible
- *    so we should looking for algo to make it dynamic grow instead of allocating fixed memory.
- * 3. the major concern is to serialize data across boundary, we should use compress to reduce its size.
+ * To avoid exhausting memory, the HLL store grows with the data it sees:
+ * it keeps exact hashes for small sets, then sparse registers, and only allocates dense registers
+ * when a group is large enough. Serialized binary follows the same store to stay compact.
  */
 namespace nebula {
 namespace api {
@@ -92,65 +86,22 @@ public:
       return (NativeType)log_->estimate();
     }
 
-    // serialize into a buffer
+    // serialize into a buffer as compact binary of its current store
     inline virtual size_t serialize(nebula::common::ExtendableSlice& slice, size_t offset) override {
-      auto data = log_->data();
-      auto src = data.data();
-      size_t size = data.size();
-
-      // wish half sized compression
-      std::vector<char> buffer(size / 2, 0);
-      size_t bytes = LZ4_compress_default(src, buffer.data(), size, size / 2);
-      VLOG(1) << "Compressed HLL from " << size
-              << " to " << bytes
+      VLOG(1) << "Serialize HLL in mode " << (int)log_->mode()
               << ", min=" << log_->minIdx()
               << ", max=" << log_->maxIdx();
-      if (bytes > 0) {
-        src = buffer.data();
-        size = bytes;
-      }
-
-      const auto origin = offset;
-
-      offset += slice.write(offset, bytes > 0);
-      offset += slice.write(offset, size);
-      offset += slice.write(offset, src, size);
-      offset += slice.write(offset, log_->minIdx());
-      offset += slice.write(offset, log_->maxIdx());
-      return offset - origin;
+      return log_->serialize(slice, offset);
     }
 
     // deserialize from a given buffer, and bin size
     inline virtual size_t load(nebula::common::ExtendableSlice& slice, size_t offset) override {
-      const auto origin = offset;
-      auto flag = slice.read<bool>(offset);
-      offset += sizeof(flag);
-      auto size = slice.read<size_t>(offset);
-      offset += sizeof(size);
-
-      // here incurs a copy from string_view to string object
-      auto bytes = slice.read(offset, size);
-      offset += size;
-
-      // read min/max id
-      auto minIdx = slice.read<uint32_t>(offset);
-      offset += sizeof(minIdx);
-      auto maxIdx = slice.read<uint32_t>(offset);
-      offset += sizeof(maxIdx);
-
-      // if is compressed, we decompress it
-      if (flag) {
-        const auto raw = log_->size();
-        std::vector<char> buffer(raw, 0);
-        auto ret = (uint32_t)LZ4_decompress_safe(bytes.data(), buffer.data(), size, raw);
-        N_ENSURE_EQ(ret, raw, "raw data size mismatches.");
-        std::string_view bin(buffer.data(), raw);
-        log_->set(bin, minIdx, maxIdx);
-      } else {
-        log_->set(bytes, minIdx, maxIdx);
-      }
-
-      return offset - origin;
+      return log_->load(slice, offset);
+    }
+
+    // dense registers are mostly zeros, worth compression when shipped
+    inline virtual bool compressible() const override {
+      return true;
     }
 
     inline virtual bool fit(size_t) override {
@@ -161,7 +112,7 @@ public:
     bool est_;
     uint32_t logSize_;
 
-    // mutual exclusive - converted when needed
+    // adaptive store - converted when needed
     std::unique_ptr<nebula::common::HyperLogLog> log_;
   };
 
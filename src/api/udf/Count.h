@@ -86,7 +86,9 @@ public:
                nebula::surface::eval::constant(1),
                []() -> std::shared_ptr<Aggregator> {
                  return std::make_shared<Aggregator>();
-               }) {}
+               }) {
+    this->reduce(nebula::surface::eval::Reduce::COUNT);
+  }
   virtual ~Count() = default;
 };
 
@@ -19,8 +19,9 @@
 #include <atomic>
 #include <fmt/format.h>
 #include <folly/stats/Histogram.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
-#include <rapidjson/document.h>
 #include "surface/eval/UDF.h"
 
 namespace nebula {
@@ -44,8 +45,6 @@ public:
 
 public:
   class Aggregator : public BaseAggregator {
-    static constexpr auto SIZE_SIZE = sizeof(size_t);
-
   public:
     explicit Aggregator(InputType min, InputType max, size_t bucketNum)
       : min_{ min },
@@ -61,7 +60,7 @@ public:
     }
 
     inline virtual void mix(const nebula::surface::eval::Sketch& another) override {
-      auto right = static_cast<const Aggregator&>(another);
+      const auto& right = static_cast<const Aggregator&>(another);
       histogram_.merge(right.histogram_);
     }
 
@@ -70,40 +69,39 @@ public:
       return json_;
     }
 
-    // serialize into a buffer
+    // serialize into a buffer as [#buckets][varint count, sum if count > 0]...
+    // bucket bounds are decided by the aggregator itself, no need to ship them.
     inline virtual size_t serialize(nebula::common::ExtendableSlice& slice, size_t offset) override {
-      auto jsonStr = jsonfy(false);
-      auto bin = slice.write(offset, jsonStr.size());
-      auto size = slice.write(offset + bin, jsonStr.data(), jsonStr.size());
-      return bin + size;
+      const auto origin = offset;
+      const auto numBuckets = histogram_.getNumBuckets();
+      offset += slice.writeVarint(offset, numBuckets);
+      for (size_t i = 0; i < numBuckets; ++i) {
+        const auto& bucket = histogram_.getBucketByIndex(i);
+        offset += slice.writeVarint(offset, bucket.count);
+        if (bucket.count > 0) {
+          offset += slice.write(offset, (double)bucket.sum);
+        }
+      }
+
+      return offset - origin;
     }
 
     inline virtual size_t load(nebula::common::ExtendableSlice& slice, size_t offset) override {
-      auto size = slice.read<size_t>(offset);
-      auto jsonStr = std::string(slice.read(offset + SIZE_SIZE, size));
+      const auto origin = offset;
       histogram_ = folly::Histogram<InputType>(bucketSize_, min_, max_);
-      rapidjson::Document document;
-      if (document.Parse(jsonStr.c_str()).HasParseError()) {
-        throw NException(fmt::format("Error parsing histogram json: {0}", jsonStr));
-      }
-      for (auto& bucket : document["b"].GetArray()) {
-        int64_t idx = 0;
+      uint64_t numBuckets = 0;
+      offset += slice.readVarint(offset, numBuckets);
+      for (uint64_t i = 0; i < numBuckets; ++i) {
         uint64_t bucketCount = 0;
-        InputType bucketSum = 0;
-        for (auto& v : bucket.GetArray()) {
-          if (idx == 2) {
-            bucketCount = v.GetInt64();
-          } else if (idx == 3) {
-            bucketSum = v.GetDouble();
-          }
-          idx++;
-        }
+        offset += slice.readVarint(offset, bucketCount);
         if (bucketCount != 0) {
-          histogram_.addRepeatedValue(bucketSum / bucketCount, bucketCount);
+          const auto bucketSum = slice.read<double>(offset);
+          offset += sizeof(double);
+          histogram_.addRepeatedValue(static_cast<InputType>(bucketSum / bucketCount), bucketCount);
         }
       }
 
-      return size + SIZE_SIZE;
+      return offset - origin;
     }
 
     inline virtual bool fit(size_t) override {
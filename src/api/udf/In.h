@@ -53,7 +53,11 @@ public:
 
         return values->find(source.value()) != values->end();
       },
-      buildEvalBlock(expr, values, true)) {}
+      buildEvalBlock(expr, values, true)) {
+    if constexpr (IK == nebula::type::Kind::VARCHAR) {
+      this->kernel(buildEvalVector(expr, values, true));
+    }
+  }
 
   In(const std::string& name,
      std::shared_ptr<nebula::api::dsl::Expression> expr,
@@ -72,11 +76,23 @@ public:
       },
       buildEvalBlock(expr, values, false)) {
     N_ENSURE(!in, "this constructor is designed for NOT IN clauase");
+    if constexpr (IK == nebula::type::Kind::VARCHAR) {
+      this->kernel(buildEvalVector(expr, values, false));
+    }
   }
 
   virtual ~In() = default;
 
 private:
+  // strings are looked up in vector, once per distinct value if the column is dictionary encoded
+  static nebula::surface::eval::EvalVector buildEvalVector(std::shared_ptr<nebula::api::dsl::Expression> expr,
+                                                           SetType values,
+                                                           bool in) {
+    return nebula::surface::eval::buildStringKernel(expr->asEval(), [values, in](std::string_view v) -> bool {
+      return (values->find(v) != values->end()) == in;
+    });
+  }
+
   static EvalBlock buildEvalBlock(std::shared_ptr<nebula::api::dsl::Expression> expr,
                                   SetType values,
                                   bool in) {
@@ -16,6 +16,8 @@
 
 #include "Like.h"
 
+#include "common/Chars.h"
+
 /**
  * Define expressions used in the nebula DSL.
  * Please use other UDF (special cases) for performance if possible: 
@@ -26,45 +28,74 @@ namespace nebula {
 namespace api {
 namespace udf {
 
-bool match(const char* sp, const size_t ss, size_t si,
-           const char* pp, const size_t ps, size_t pi,
-           bool cs) {
-  // function pointer defition
-  bool (*eqf)(char a, char b) = cs ? &eq : &ieq;
-
-  // when pattern still have words
-  while (pi < ps) {
-    char ch = *(pp + pi);
-
-    // if not %, source has to match this
-    if (N_LIKELY(ch != '%')) {
-      if (!(*eqf)(ch, *(sp + si))) {
-        return false;
-      }
-
-      // move both source and pattern
-      ++si;
-    } else {
-      // if current is a matcher char. it can match anything in source
-      size_t pos = si + 1;
-
-      // assuming this % match current char in source
-      while (pos <= ss) {
-        if (match(sp, ss, pos, pp, ps, pi + 1, cs)) {
-          return true;
-        }
-
-        ++pos;
-      }
+using nebula::common::Chars;
+
+LikePattern::LikePattern(const std::string& pattern, bool caseSensitive)
+  : cs_{ caseSensitive }, exact_{ true } {
+  // literal segments are folded to lower case in advance for case insensitive match
+  std::string p = pattern;
+  if (!cs_) {
+    Chars::lower(pattern.data(), pattern.size(), p.data());
+  }
+
+  const auto first = p.find('%');
+  if (first == std::string::npos) {
+    head_ = std::move(p);
+    return;
+  }
+
+  exact_ = false;
+  head_ = p.substr(0, first);
+  const auto last = p.rfind('%');
+  tail_ = p.substr(last + 1);
+
+  // split drops empty segments, so only literals between first and last % are left in order
+  if (last > first + 1) {
+    inners_ = Chars::split<true>(p.data() + first + 1, last - first - 1, '%');
+  }
+}
+
+bool LikePattern::match(std::string_view source) const {
+  const auto size = source.size();
+  const auto hs = head_.size();
+  const auto ts = tail_.size();
+  if (exact_) {
+    return size == hs && Chars::prefix(source.data(), size, head_.data(), hs, !cs_);
+  }
+
+  // anchored head and tail can't overlap
+  if (size < hs + ts
+      || !Chars::prefix(source.data(), size, head_.data(), hs, !cs_)
+      || !Chars::prefix(source.data() + size - ts, ts, tail_.data(), ts, !cs_)) {
+    return false;
+  }
+
+  if (inners_.empty()) {
+    return true;
+  }
+
+  // search inner segments in the middle, folded into a per thread buffer if case insensitive
+  auto middle = source.substr(hs, size - hs - ts);
+  if (!cs_) {
+    static thread_local std::string folded;
+    folded.resize(middle.size());
+    Chars::lower(middle.data(), middle.size(), folded.data());
+    middle = folded;
+  }
+
+  size_t pos = 0;
+  for (const auto& segment : inners_) {
+    pos = Chars::find(middle, segment, pos);
+    if (pos == std::string_view::npos) {
+      return false;
     }
 
-    // if reaching here, so far we can match, even a % may not match anything.
-    ++pi;
+    pos += segment.size();
   }
 
-  // when pattern is all done, can't have remaining source for a match
-  return si == ss;
+  return true;
 }
+
 } // namespace udf
 } // namespace api
 } // namespace nebula
\ No newline at end of file
@@ -17,6 +17,9 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "surface/eval/UDF.h"
 
@@ -27,48 +30,64 @@ namespace nebula {
 namespace api {
 namespace udf {
 
-// char equals
-static inline bool eq(char a, char b) {
-  return a == b;
-}
-
-// char equlas ignoring case
-static inline bool ieq(char a, char b) {
-  return a == b || std::tolower(a) == std::tolower(b);
-}
-
 // This UDF is doing the pattern match
 // Not sure if this is standard SQL like spec
 // It only accepts % as pattern matcher
 // when pattern see %, treat it as macro, no escape support here.
-bool match(const char* sp, const size_t ss, size_t si,
-           const char* pp, const size_t ps, size_t pi,
-           bool caseSensitive = true);
+//
+// A pattern is compiled once into literal segments split by %,
+// the first and last segment are anchored at the start and end of the source,
+// segments in between are searched in order from left to right.
+class LikePattern {
+public:
+  LikePattern(const std::string& pattern, bool caseSensitive = true);
+
+  bool match(std::string_view) const;
+
+private:
+  bool cs_;
+  // pattern has no % at all - exact match
+  bool exact_;
+  // literal segment before the first % and after the last %
+  std::string head_;
+  std::string tail_;
+  // non-empty literal segments between the first and last %
+  std::vector<std::string> inners_;
+};
 
 using UdfLikeBase = nebula::surface::eval::UDF<nebula::type::Kind::BOOLEAN, nebula::type::Kind::VARCHAR>;
 class Like : public UdfLikeBase {
+  using Matcher = std::function<bool(std::string_view)>;
+
 public:
   Like(const std::string& name,
        std::unique_ptr<nebula::surface::eval::ValueEval> expr,
        const std::string& pattern,
        bool caseSensitive = true,
        bool unlike = false)
+    : Like(name, std::move(expr), [p = LikePattern(pattern, caseSensitive), unlike](std::string_view v) -> bool {
+        auto m = p.match(v);
+        return unlike ? !m : m;
+      }) {}
+  virtual ~Like() = default;
+
+private:
+  Like(const std::string& name,
+       std::unique_ptr<nebula::surface::eval::ValueEval> expr,
+       Matcher matcher)
     : UdfLikeBase(
       name,
       std::move(expr),
-      [pattern, caseSensitive, unlike](const std::optional<InputType>& source)
-        -> std::optional<NativeType> {
+      [matcher](const std::optional<InputType>& source) -> std::optional<NativeType> {
         if (N_UNLIKELY(source == std::nullopt)) {
           return std::nullopt;
         }
 
-        auto v = source.value();
-        auto m = match(v.data(), v.size(), 0,
-                       pattern.data(), pattern.size(), 0,
-                       caseSensitive);
-        return unlike ? !m : m;
-      }) {}
-  virtual ~Like() = default;
+        return matcher(source.value());
+      }) {
+    // a column is matched in vector, once per distinct value if it's dictionary encoded
+    this->kernel(nebula::surface::eval::buildStringKernel(input(), std::move(matcher)));
+  }
 };
 
 } // namespace udf
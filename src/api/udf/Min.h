@@ -84,7 +84,9 @@ public:
                std::move(expr),
                []() -> std::shared_ptr<Aggregator> {
                  return std::make_shared<Aggregator>();
-               }) {}
+               }) {
+    this->reduce(nebula::surface::eval::Reduce::MIN);
+  }
   virtual ~Min() = default;
 };
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <folly/stats/TDigest.h>
 #include <rapidjson/stringbuffer.h>
@@ -58,38 +59,31 @@ public:
     virtual ~Aggregator() = default;
     // aggregate an value in
     inline virtual void merge(InputType v) override {
-      if (N_LIKELY(buffer_.size() < BUFFER_SIZE)) {
-        buffer_.emplace_back(double(v));
-        return;
+      buffer_.emplace_back(double(v));
+      if (N_UNLIKELY(buffer_.size() >= BUFFER_SIZE)) {
+        flush();
       }
-
-      flush();
     }
 
-    // aggregate another aggregator
-    // TODO(cao): the current merge signature is strange requiring an array incuring copy
-    // We may use our own version of TDigest implementation
-    // with better interface to merge single item by pointer or reference
+    // aggregate another aggregator by reference without copying it
     inline virtual void mix(const nebula::surface::eval::Sketch& another) override {
-      auto right = static_cast<const Aggregator&>(another);
+      const auto& right = static_cast<const Aggregator&>(another);
 
       // merge buffer
-      auto rightBufferSize = right.buffer_.size();
-      if (rightBufferSize > 0) {
-        if (rightBufferSize > buffer_.size()) {
-          std::swap(buffer_, right.buffer_);
-        }
-
-        for (auto v : right.buffer_) {
-          buffer_.emplace_back(v);
-        }
-
-        right.buffer_.clear();
+      buffer_.insert(buffer_.end(), right.buffer_.begin(), right.buffer_.end());
+      if (buffer_.size() >= BUFFER_SIZE) {
+        flush();
       }
 
       // only merge object only when it has value
       if (right.digest_.count() > 0) {
-        digest_ = digest_.merge(std::array<folly::TDigest, 1>{ right.digest_ });
+        if (digest_.count() == 0) {
+          digest_ = right.digest_;
+        } else {
+          // folly merges a contiguous range of digests
+          std::array<folly::TDigest, 2> digests{ std::move(digest_), right.digest_ };
+          digest_ = folly::TDigest::merge(digests);
+        }
       }
     }
 
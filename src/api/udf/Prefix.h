@@ -34,6 +34,8 @@ namespace udf {
 // when pattern see %, treat it as macro, no escape support here.
 using UdfPrefixBase = nebula::surface::eval::UDF<nebula::type::Kind::BOOLEAN, nebula::type::Kind::VARCHAR>;
 class Prefix : public UdfPrefixBase {
+  using Matcher = std::function<bool(std::string_view)>;
+
 public:
   Prefix(
     const std::string& name,
@@ -41,16 +43,7 @@ public:
     const std::string& prefix,
     bool caseSensitive = true,
     bool opposite = false)
-    : UdfPrefixBase(
-      name,
-      std::move(expr),
-      [prefix, caseSensitive, opposite](const std::optional<InputType>& source)
-        -> std::optional<NativeType> {
-        if (N_UNLIKELY(source == std::nullopt)) {
-          return std::nullopt;
-        }
-
-        auto v = source.value();
+    : Prefix(name, std::move(expr), [prefix, caseSensitive, opposite](std::string_view v) -> bool {
         auto p = nebula::common::Chars::prefix(
           v.data(), v.size(),
           prefix.data(), prefix.size(),
@@ -58,6 +51,24 @@ public:
         return opposite ? !p : p;
       }) {}
   virtual ~Prefix() = default;
+
+private:
+  Prefix(const std::string& name,
+         std::unique_ptr<nebula::surface::eval::ValueEval> expr,
+         Matcher matcher)
+    : UdfPrefixBase(
+      name,
+      std::move(expr),
+      [matcher](const std::optional<InputType>& source) -> std::optional<NativeType> {
+        if (N_UNLIKELY(source == std::nullopt)) {
+          return std::nullopt;
+        }
+
+        return matcher(source.value());
+      }) {
+    // a column is matched in vector, once per distinct value if it's dictionary encoded
+    this->kernel(nebula::surface::eval::buildStringKernel(input(), std::move(matcher)));
+  }
 };
 
 } // namespace udf
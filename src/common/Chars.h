@@ -16,7 +16,13 @@
 
 #pragma once
 
+#include <cstring>
 #include <glog/logging.h>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #include "Hash.h"
 
@@ -127,6 +133,140 @@ public:
     return a == b || std::tolower(a) == std::tolower(b);
   }
 
+  // ASCII lower case of a char without branch, same as std::tolower in "C" locale
+  static inline char lower(char c) {
+    return c | (((unsigned char)(c - 'A') < 26) << 5);
+  }
+
+// SIMD helpers: fold upper case ASCII letters of a vector to lower case
+#if defined(__AVX2__)
+  static inline __m256i lower(__m256i v) {
+    // signed compare: (c - 'A' - 128) < (26 - 128) iff c in ['A', 'Z']
+    const auto shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - 'A')));
+    const auto upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + 26)), shifted);
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+  }
+#endif
+
+#if defined(__SSE2__)
+  static inline __m128i lower(__m128i v) {
+    const auto shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'A')));
+    const auto upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(0x80 + 26)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+  }
+#endif
+
+  // fold a string to ASCII lower case into dest which has at least size bytes
+  static void lower(const char* src, size_t size, char* dest) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+      auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), lower(v));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+      auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), lower(v));
+    }
+#endif
+    for (; i < size; ++i) {
+      dest[i] = lower(src[i]);
+    }
+  }
+
+  // two strings of the same size have the same value ignoring case
+  static bool iequal(const char* a, const char* b, size_t size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+      auto va = lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+      auto vb = lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) != -1) {
+        return false;
+      }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+      auto va = lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+      auto vb = lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) {
+        return false;
+      }
+    }
+#endif
+    for (; i < size; ++i) {
+      if (lower(a[i]) != lower(b[i])) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // find first position of word in text starting from given position, npos if not found.
+  // vector version compares first and last char of the word at 16/32 positions at once,
+  // and only verifies the whole word at candidate positions.
+  static size_t find(std::string_view text, std::string_view word, size_t from = 0) {
+    const auto n = text.size();
+    const auto m = word.size();
+    if (m == 0) {
+      return from <= n ? from : std::string_view::npos;
+    }
+
+    if (from > n || n - from < m) {
+      return std::string_view::npos;
+    }
+
+    const char* s = text.data();
+    const char* w = word.data();
+    size_t i = from;
+
+// check every candidate position flagged in the bit mask
+#define VERIFY_CANDIDATES(MASK)                                        \
+  while (MASK != 0) {                                                  \
+    const auto pos = i + __builtin_ctz(MASK);                          \
+    if (m <= 2 || std::memcmp(s + pos + 1, w + 1, m - 2) == 0) {       \
+      return pos;                                                      \
+    }                                                                  \
+    MASK &= MASK - 1;                                                  \
+  }
+
+#if defined(__AVX2__)
+    {
+      const auto first = _mm256_set1_epi8(w[0]);
+      const auto last = _mm256_set1_epi8(w[m - 1]);
+      for (; i + m + 31 <= n; i += 32) {
+        auto bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        auto bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + m - 1));
+        uint32_t mask = _mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(first, bf), _mm256_cmpeq_epi8(last, bl)));
+        VERIFY_CANDIDATES(mask)
+      }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+      const auto first = _mm_set1_epi8(w[0]);
+      const auto last = _mm_set1_epi8(w[m - 1]);
+      for (; i + m + 15 <= n; i += 16) {
+        auto bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        auto bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+        uint32_t mask = _mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl)));
+        VERIFY_CANDIDATES(mask)
+      }
+    }
+#endif
+
+#undef VERIFY_CANDIDATES
+
+    // remaining tail or no vector support
+    return text.find(word, i);
+  }
+
   // shortcut: two string views have the same value ignoring case
   static inline bool same(std::string_view v1, std::string_view v2, bool ignoreCase = true) {
     return v1.size() == v2.size() && prefix(v1.data(), v1.size(), v2.data(), v2.size(), ignoreCase);
@@ -146,14 +286,11 @@ public:
       return false;
     }
 
-    bool (*eqf)(char a, char b) = ignoreCase ? &ieq : &eq;
-    for (size_t i = 0; i < t_size; ++i) {
-      if (!(*eqf)(*(src + i), *(target + i))) {
-        return false;
-      }
+    if (!ignoreCase) {
+      return std::memcmp(src, target, t_size) == 0;
     }
 
-    return true;
+    return iequal(src, target, t_size);
   }
 
   static std::string digest(const char* str, size_t size) {
@@ -21,6 +21,7 @@
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <fstream>
 #include <iostream>
+#include <memory>
 
 /**
  * Value conversion utility
@@ -47,6 +48,24 @@ static void ungzip(const std::string& source, const std::string& dest) {
   output.close();
 }
 
+// an input stream inflating gzip data of a source stream on the fly,
+// so a compressed file can be parsed while it is read without a full copy.
+class GzipStream : public std::istream {
+public:
+  explicit GzipStream(std::unique_ptr<std::istream> source)
+    : std::istream(nullptr), source_{ std::move(source) } {
+    buf_.push(boost::iostreams::gzip_decompressor());
+    buf_.push(*source_);
+    rdbuf(&buf_);
+  }
+
+  virtual ~GzipStream() = default;
+
+private:
+  std::unique_ptr<std::istream> source_;
+  boost::iostreams::filtering_streambuf<boost::iostreams::input> buf_;
+};
+
 static inline size_t filesize(const std::string& file) {
   return std::ifstream(file, std::ifstream::ate | std::ifstream::binary).tellg();
 }
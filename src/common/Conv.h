@@ -17,6 +17,10 @@
 #pragma once
 
 #include <folly/Conv.h>
+#include <string>
+#include <string_view>
+
+#include "Format.h"
 
 /**
  * Value conversion utility
@@ -33,5 +37,23 @@ T safe_to(const S& s) {
   }
 }
 
+// zero copy version of unformat + safe_to on a text field,
+// it copies the text only when it has format chars (see unformat) to remove.
+template <typename T>
+T unformat_to(std::string_view text) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    for (auto ch : text) {
+      if (ch == ',' || ch == ' ' || (std::is_integral_v<T> && ch == '.')) {
+        std::string copy(text);
+        unformat<T>(copy);
+        return safe_to<T>(copy);
+      }
+    }
+  }
+
+  auto value = folly::tryTo<T>(folly::StringPiece(text.data(), text.size()));
+  return value.hasValue() ? value.value() : T();
+}
+
 } // namespace common
 } // namespace nebula
\ No newline at end of file
@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
 #include <forward_list>
+#include <functional>
 #include <glog/logging.h>
 #include <mutex>
 #include <numeric>
@@ -450,5 +454,137 @@ private:
 #undef DATA_LOCK
 };
 
+// A consistent hash ring with bounded loads over a snapshot of nodes.
+// paper ref: https://arxiv.org/abs/1608.01350
+//
+// Different from HashRing above, it doesn't own resources nor track data keys,
+// so it's cheap to rebuild from current node list every time we need to place some keys.
+// 1. Number of placements of a node is proportional to its weight (e.g. memory capacity).
+// 2. Every node is capped at ceil((1 + epsilon) * weight share * total keys),
+//    a key is hosted by the first node clockwise from its hash which still has room.
+// Since placements only depend on node ID and weight, a node change only moves ~1/N keys.
+template <typename NT>
+class BoundedRing final {
+  // average number of placements per node
+  static constexpr size_t VNODES = 160;
+
+  struct Bucket {
+    const NT* node;
+    std::string id;
+    size_t capacity;
+    size_t load;
+  };
+
+  using TPlacement = Placement<Bucket>;
+
+public:
+  // nodes are referenced (not owned) by the ring, they need to outlive it.
+  // numKeys is total keys (including already charged) the ring is expected to host.
+  BoundedRing(const std::vector<NT>& nodes,
+              const std::function<std::string(const NT&)>& id,
+              const std::function<size_t(const NT&)>& weight,
+              size_t numKeys,
+              double epsilon = 0.25) {
+    const auto numNodes = nodes.size();
+    std::vector<size_t> weights;
+    weights.reserve(numNodes);
+    for (const auto& n : nodes) {
+      weights.push_back(weight(n));
+    }
+
+    // no weight given at all, every node is equal
+    auto total = std::accumulate(weights.begin(), weights.end(), 0ul);
+    if (total == 0) {
+      std::fill(weights.begin(), weights.end(), 1);
+      total = numNodes;
+    }
+
+    buckets_.reserve(numNodes);
+    nebula::common::vector_reserve(placements_, numNodes * VNODES + numNodes, "BoundedRing::BoundedRing");
+    for (size_t i = 0; i < numNodes; ++i) {
+      const auto share = (double)weights.at(i) / total;
+      const auto capacity = std::max<size_t>(1, std::ceil((1 + epsilon) * share * numKeys));
+      buckets_.push_back({ &nodes.at(i), id(nodes.at(i)), capacity, 0 });
+
+      // a node gets at least one placement even its weight is tiny
+      auto& bucket = buckets_.back();
+      index_.emplace(bucket.id, i);
+      const auto count = std::max<size_t>(1, std::lround(share * numNodes * VNODES));
+      for (size_t p = 0; p < count; ++p) {
+        const auto label = fmt::format("{0}#{1}", bucket.id, p);
+        placements_.emplace_back(Hasher::hash64(label.data(), label.size()), &bucket);
+      }
+    }
+
+    // sort placements by hash, break ties by node ID to stay independent of node order
+    std::sort(placements_.begin(), placements_.end(), [](const auto& p1, const auto& p2) -> bool {
+      return p1.hash < p2.hash || (p1.hash == p2.hash && p1.node->id < p2.node->id);
+    });
+  }
+  ~BoundedRing() = default;
+
+public:
+  // count a key already hosted by given node into its load
+  // return false if the node is not on the ring.
+  bool charge(const std::string& nodeId) {
+    auto found = index_.find(nodeId);
+    if (found == index_.end()) {
+      return false;
+    }
+
+    buckets_.at(found->second).load++;
+    return true;
+  }
+
+  // place a key on the ring and return the node hosting it, nullptr if the ring is empty.
+  const NT* attach(const std::string& key) {
+    const auto size = placements_.size();
+    if (N_UNLIKELY(size == 0)) {
+      return nullptr;
+    }
+
+    // first placement at or after the key hash owns it - (prev, hash]
+    const auto h = Hasher::hash64(key.data(), key.size());
+    const auto start = std::lower_bound(placements_.begin(), placements_.end(), h, [](const auto& p, size_t v) {
+                         return p.hash < v;
+                       })
+                       - placements_.begin();
+
+    // walk clockwise to skip all nodes reaching their capacity.
+    // total capacity is larger than expected keys, if caller over-charges nodes, fall back to the owner.
+    for (size_t i = 0; i < size; ++i) {
+      auto bucket = placements_.at((start + i) % size).node;
+      if (bucket->load < bucket->capacity) {
+        bucket->load++;
+        return bucket->node;
+      }
+    }
+
+    auto owner = placements_.at(start % size).node;
+    owner->load++;
+    return owner->node;
+  }
+
+  // number of keys hosted by given node
+  inline size_t load(const std::string& nodeId) const {
+    auto found = index_.find(nodeId);
+    return found == index_.end() ? 0 : buckets_.at(found->second).load;
+  }
+
+  // max number of keys given node can host
+  inline size_t capacity(const std::string& nodeId) const {
+    auto found = index_.find(nodeId);
+    return found == index_.end() ? 0 : buckets_.at(found->second).capacity;
+  }
+
+private:
+  // every node is a bucket, placements point to them so it never grows after construction
+  std::vector<Bucket> buckets_;
+  // node ID to its bucket index
+  unordered_map<std::string, size_t> index_;
+  // all placements in the ring sorted by hash
+  std::vector<TPlacement> placements_;
+};
+
 } // namespace common
 } // namespace nebula
\ No newline at end of file
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 
 #include "Hash.h"
@@ -32,6 +34,12 @@ namespace common {
  * @brief HyperLogLog cardinality estimator
  * @date Created 2013/3/20
  * @author Hideaki Ohno
+ *
+ * The store adapts to number of distinct values seen so far, so that small sets cost little memory:
+ * - EXACT: hashes of all values are kept, estimate is the exact number of distinct hashes.
+ * - SPARSE: only non-zero registers are kept as index to rank map.
+ * - DENSE: all registers are allocated as the original algorithm.
+ * It only grows from left to right when the current store is more expensive than the next one.
  */
 class HyperLogLog final {
   using byte_t = uint8_t;
@@ -39,6 +47,12 @@ class HyperLogLog final {
   static constexpr double NEG_POW_2_32 = -4294967296.0; ///< -(2^32)
 
 public:
+  enum class Mode : byte_t {
+    EXACT = 0,
+    SPARSE = 1,
+    DENSE = 2
+  };
+
   // b bit width (register size will be 2 to the b power).
   // This value must be in the range[4,30].
   // Default value is 16
@@ -58,7 +72,7 @@ public:
     : width_{ width },
       left_{ static_cast<byte_t>(32 - width) },
       size_{ static_cast<uint32_t>(1 << width) },
-      data_(size_, 0),
+      mode_{ Mode::EXACT },
       minIdx_{ size_ },
       maxIdx_{ 0 } {
 
@@ -116,34 +130,32 @@ public:
 
   // add binary to the store
   void add(const char* data, size_t size) {
-
     // uint32_t hash = Murmur3::hash(data, size);
-    uint32_t hash = (uint32_t)nebula::common::Hasher::hash64(data, size);
-    uint32_t index = hash >> left_;
-    byte_t rank = leadingZeros((hash << width_), left_);
-    if (rank > data_[index]) {
-      data_[index] = rank;
-
-      // update the range that seeing values
-      if (index > maxIdx_) {
-        maxIdx_ = index;
-      }
-
-      if (index < minIdx_) {
-        minIdx_ = index;
-      }
-    }
+    addHash((uint32_t)nebula::common::Hasher::hash64(data, size));
   }
 
   // Estimates cardinality value.
   double estimate() const {
+    if (mode_ == Mode::EXACT) {
+      return hashes_.size();
+    }
+
+    // every register not seen in sparse store is 0
     double sum = 0.0;
     uint32_t zeros = 0;
-    for (uint32_t i = 0; i < size_; ++i) {
-      auto v = data_[i];
-      sum += 1.0 / (1 << v);
-      if (v == 0) {
-        ++zeros;
+    if (mode_ == Mode::SPARSE) {
+      zeros = size_ - sparse_.size();
+      sum = zeros;
+      for (const auto& r : sparse_) {
+        sum += 1.0 / (1ul << r.second);
+      }
+    } else {
+      for (uint32_t i = 0; i < size_; ++i) {
+        auto v = data_[i];
+        sum += 1.0 / (1ul << v);
+        if (v == 0) {
+          ++zeros;
+        }
       }
     }
 
@@ -163,20 +175,45 @@ public:
   // TODO(cao): merge degrades accuracy fast when size is not big enough
   void merge(const HyperLogLog& other) {
     N_ENSURE(size_ == other.size_, "can't merge different sized hll.");
-    for (uint32_t i = other.minIdx_; i < other.maxIdx_; ++i) {
-      if (data_[i] < other.data_[i]) {
-        data_[i] = other.data_[i];
+    switch (other.mode_) {
+    case Mode::EXACT: {
+      for (auto hash : other.hashes_) {
+        addHash(hash);
+      }
+      break;
+    }
+    case Mode::SPARSE: {
+      if (mode_ == Mode::EXACT) {
+        toSparse();
+      }
+
+      for (const auto& r : other.sparse_) {
+        update(r.first, r.second);
       }
+      break;
     }
+    case Mode::DENSE: {
+      toDense();
+      for (uint32_t i = other.minIdx_; i <= other.maxIdx_ && i < size_; ++i) {
+        if (data_[i] < other.data_[i]) {
+          data_[i] = other.data_[i];
+        }
+      }
 
-    // new range seeing values
-    minIdx_ = std::min(minIdx_, other.minIdx_);
-    maxIdx_ = std::max(maxIdx_, other.maxIdx_);
+      // new range seeing values
+      minIdx_ = std::min(minIdx_, other.minIdx_);
+      maxIdx_ = std::max(maxIdx_, other.maxIdx_);
+      break;
+    }
+    }
   }
 
   // Clears all internal registers.
   inline void clear() {
-    std::fill(data_.begin(), data_.end(), 0);
+    mode_ = Mode::EXACT;
+    hashes_ = {};
+    sparse_ = {};
+    data_ = {};
     minIdx_ = size_;
     maxIdx_ = 0;
   }
@@ -186,6 +223,10 @@ public:
     return size_;
   }
 
+  inline Mode mode() const {
+    return mode_;
+  }
+
   inline uint32_t minIdx() const {
     return minIdx_;
   }
@@ -200,13 +241,17 @@ public:
     std::swap(left_, rhs.left_);
     std::swap(size_, rhs.size_);
     std::swap(alpha_, rhs.alpha_);
+    std::swap(mode_, rhs.mode_);
     std::swap(minIdx_, rhs.minIdx_);
     std::swap(maxIdx_, rhs.maxIdx_);
+    std::swap(hashes_, rhs.hashes_);
+    std::swap(sparse_, rhs.sparse_);
     std::swap(data_, rhs.data_);
   }
 
   // Dump the current status to a stream
   void serialize(std::ostream& os) {
+    toDense();
     // width recording
     os.write((char*)&width_, sizeof(byte_t));
     os.write((char*)data_.data(), size_);
@@ -218,32 +263,211 @@ public:
     byte_t width = 0;
     is.read((char*)&width, sizeof(byte_t));
     HyperLogLog tempHLL(width);
+    tempHLL.toDense();
     is.read((char*)(tempHLL.data_.data()), tempHLL.size_);
     N_ENSURE(!is.fail(), "Failed to deserialize.");
+    tempHLL.minIdx_ = 0;
+    tempHLL.maxIdx_ = tempHLL.size_ - 1;
 
     swap(tempHLL);
   }
 
-public:
-  // most of the time the matrix is pretty sparse
-  // we want to compress it for storing.
-  inline std::string_view data() const {
-    // you should compress at least half
-    return std::string_view((char*)data_.data(), size_);
+  // write compact binary of current store: [width][mode][store]
+  // - EXACT: number of hashes and delta varints of sorted hashes.
+  // - SPARSE: number of registers and (delta varint of index, rank) of sorted registers.
+  // - DENSE: range of seen registers and raw bytes of the range.
+  size_t serialize(ExtendableSlice& slice, size_t offset) const {
+    const auto origin = offset;
+    offset += slice.write(offset, width_);
+    offset += slice.write(offset, static_cast<byte_t>(mode_));
+    switch (mode_) {
+    case Mode::EXACT: {
+      std::vector<uint32_t> hashes{ hashes_.begin(), hashes_.end() };
+      std::sort(hashes.begin(), hashes.end());
+      offset += slice.writeVarint(offset, hashes.size());
+      uint32_t last = 0;
+      for (auto hash : hashes) {
+        offset += slice.writeVarint(offset, hash - last);
+        last = hash;
+      }
+      break;
+    }
+    case Mode::SPARSE: {
+      std::vector<std::pair<uint32_t, byte_t>> registers;
+      registers.reserve(sparse_.size());
+      for (const auto& r : sparse_) {
+        registers.emplace_back(r.first, r.second);
+      }
+      std::sort(registers.begin(), registers.end());
+      offset += slice.writeVarint(offset, registers.size());
+      uint32_t last = 0;
+      for (const auto& r : registers) {
+        offset += slice.writeVarint(offset, r.first - last);
+        offset += slice.write(offset, r.second);
+        last = r.first;
+      }
+      break;
+    }
+    case Mode::DENSE: {
+      // no register seen yet if range is empty
+      const auto empty = minIdx_ > maxIdx_;
+      const uint32_t begin = empty ? 0 : minIdx_;
+      const uint32_t count = empty ? 0 : maxIdx_ - minIdx_ + 1;
+      offset += slice.writeVarint(offset, begin);
+      offset += slice.writeVarint(offset, count);
+      offset += slice.write(offset, (const char*)data_.data() + begin, count);
+      break;
+    }
+    }
+
+    return offset - origin;
   }
 
-  // decompress the compressed binary into matrix
-  inline void set(const std::string_view& sv, uint32_t minIdx, uint32_t maxIdx) {
-    N_ENSURE_EQ(sv.size(), size_, "unexpected size of data to restore");
-    std::memcpy((char*)data_.data(), sv.data(), sv.size());
-    minIdx_ = minIdx;
-    maxIdx_ = maxIdx;
+  // reset the store from binary written by serialize, return number of bytes consumed
+  size_t load(const ExtendableSlice& slice, size_t offset) {
+    const auto origin = offset;
+    auto width = slice.read<byte_t>(offset++);
+    N_ENSURE_EQ(width, width_, "can't load different sized hll.");
+    auto mode = static_cast<Mode>(slice.read<byte_t>(offset++));
+    clear();
+
+    uint64_t count = 0;
+    switch (mode) {
+    case Mode::EXACT: {
+      offset += slice.readVarint(offset, count);
+      hashes_.reserve(count);
+      uint64_t hash = 0;
+      for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta = 0;
+        offset += slice.readVarint(offset, delta);
+        hash += delta;
+        hashes_.insert(static_cast<uint32_t>(hash));
+      }
+      break;
+    }
+    case Mode::SPARSE: {
+      mode_ = Mode::SPARSE;
+      offset += slice.readVarint(offset, count);
+      sparse_.reserve(count);
+      uint64_t index = 0;
+      for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta = 0;
+        offset += slice.readVarint(offset, delta);
+        index += delta;
+        update(static_cast<uint32_t>(index), slice.read<byte_t>(offset++));
+      }
+      break;
+    }
+    case Mode::DENSE: {
+      toDense();
+      uint64_t minIdx = 0;
+      offset += slice.readVarint(offset, minIdx);
+      offset += slice.readVarint(offset, count);
+      N_ENSURE_LE(minIdx + count, size_, "corrupted hll registers");
+      std::memcpy(data_.data() + minIdx, slice.ptr() + offset, count);
+      offset += count;
+      if (count > 0) {
+        minIdx_ = minIdx;
+        maxIdx_ = minIdx + count - 1;
+      }
+      break;
+    }
+    default:
+      throw NException("unknown hll store");
+    }
+
+    return offset - origin;
+  }
+
+private:
+  // number of exact hashes and sparse registers allowed before growing into next store.
+  // a hash or a sparse register costs about 4 or 8 bytes in hash container while a dense register is 1 byte.
+  inline uint32_t exactLimit() const {
+    return size_ >> 6;
+  }
+
+  inline uint32_t sparseLimit() const {
+    return size_ >> 4;
+  }
+
+  inline void addHash(uint32_t hash) {
+    if (mode_ == Mode::EXACT) {
+      hashes_.insert(hash);
+      if (N_UNLIKELY(hashes_.size() > exactLimit())) {
+        toSparse();
+      }
+      return;
+    }
+
+    update(hash >> left_, leadingZeros((hash << width_), left_));
+  }
+
+  // update register of given index with a rank if it's larger
+  inline void update(uint32_t index, byte_t rank) {
+    if (mode_ == Mode::DENSE) {
+      if (rank <= data_[index]) {
+        return;
+      }
+      data_[index] = rank;
+    } else {
+      auto& r = sparse_[index];
+      if (rank <= r) {
+        return;
+      }
+      r = rank;
+    }
+
+    // update the range that seeing values
+    if (index > maxIdx_) {
+      maxIdx_ = index;
+    }
+
+    if (index < minIdx_) {
+      minIdx_ = index;
+    }
+
+    if (N_UNLIKELY(mode_ == Mode::SPARSE && sparse_.size() > sparseLimit())) {
+      toDense();
+    }
+  }
+
+  // replay all exact hashes into registers
+  void toSparse() {
+    if (mode_ != Mode::EXACT) {
+      return;
+    }
+
+    mode_ = Mode::SPARSE;
+    unordered_set<uint32_t> hashes;
+    std::swap(hashes, hashes_);
+    for (auto hash : hashes) {
+      addHash(hash);
+    }
+  }
+
+  void toDense() {
+    if (mode_ == Mode::DENSE) {
+      return;
+    }
+
+    toSparse();
+    mode_ = Mode::DENSE;
+    data_.assign(size_, 0);
+    for (const auto& r : sparse_) {
+      data_[r.first] = r.second;
+    }
+    sparse_ = {};
   }
 
 private:
   byte_t width_;
   byte_t left_;
   uint32_t size_;
+
+  // store of current mode, only one of them is used
+  Mode mode_;
+  unordered_set<uint32_t> hashes_;
+  unordered_map<uint32_t, byte_t> sparse_;
   std::vector<byte_t> data_;
 
   double alpha_;
@@ -18,6 +18,9 @@
 
 #include <algorithm>
 #include <lz4.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 #include "Bits.h"
 
@@ -29,6 +32,106 @@ Pool& Pool::getDefault() {
   return pool;
 }
 
+#ifdef __linux__
+static constexpr size_t PAGE_SIZE_4K = 4096;
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// mapped chunks are always in whole pages
+static inline size_t pages(size_t size) {
+  return (size + PAGE_SIZE_4K - 1) & ~(PAGE_SIZE_4K - 1);
+}
+
+static inline void hugePages(void* p, size_t size) {
+  if (size >= HUGE_PAGE_SIZE) {
+    // a hint only, ignore failures when THP is not enabled
+    ::madvise(p, size, MADV_HUGEPAGE);
+  }
+}
+
+static void* map(size_t size) {
+  auto len = pages(size);
+  auto p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (N_UNLIKELY(p == MAP_FAILED)) {
+    throw std::bad_alloc();
+  }
+
+  hugePages(p, len);
+  return p;
+}
+#endif
+
+void* Pool::allocate(size_t size) {
+  allocated_.fetch_add(size, std::memory_order_relaxed);
+#ifdef __linux__
+  if (size >= LARGE_CHUNK) {
+    return map(size);
+  }
+#endif
+
+  auto p = std::calloc(size, 1);
+  if (N_UNLIKELY(!p && size > 0)) {
+    throw std::bad_alloc();
+  }
+
+  return p;
+}
+
+void Pool::free(void* p, size_t size) {
+  freed_.fetch_add(size, std::memory_order_relaxed);
+#ifdef __linux__
+  if (size >= LARGE_CHUNK) {
+    ::munmap(p, pages(size));
+    return;
+  }
+#endif
+
+  std::free(p);
+}
+
+void* Pool::extend(void* p, size_t size, size_t newSize) {
+  N_ENSURE_GT(newSize, size, "new size should be larger than original size");
+  const auto delta = newSize - size;
+
+#ifdef __linux__
+  if (newSize >= LARGE_CHUNK) {
+    NByte* newP = nullptr;
+    if (size >= LARGE_CHUNK) {
+      // remap pages in place or move them without copy, new pages are zeroed
+      auto r = ::mremap(p, pages(size), pages(newSize), MREMAP_MAYMOVE);
+      if (N_UNLIKELY(r == MAP_FAILED)) {
+        free(p, size);
+        throw std::bad_alloc();
+      }
+
+      newP = static_cast<NByte*>(r);
+      hugePages(newP, pages(newSize));
+    } else {
+      // crossing from heap chunk to mapped pages
+      newP = static_cast<NByte*>(map(newSize));
+      if (size > 0) {
+        std::memcpy(newP, p, size);
+      }
+
+      std::free(p);
+    }
+
+    extended_.fetch_add(delta, std::memory_order_relaxed);
+    return newP;
+  }
+#endif
+
+  // extend the memory if possible
+  NByte* newP = (NByte*)std::realloc(p, newSize);
+  if (N_UNLIKELY(!newP)) {
+    free(p, size);
+    throw std::bad_alloc();
+  }
+
+  extended_.fetch_add(delta, std::memory_order_relaxed);
+  std::memset(newP + size, 0, delta);
+  return newP;
+}
+
 // append a bytes array of length bytes to position
 size_t ExtendableSlice::write(size_t position, const NByte* data, size_t length) {
   if (N_UNLIKELY(length == 0)) {
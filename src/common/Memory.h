@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <folly/compression/Compression.h>
 #include <glog/logging.h>
 #include <iostream>
@@ -47,50 +48,46 @@ namespace nebula {
 namespace common {
 
 // maintain a memory pool tracking memory chunks
-// it gurantees memory are set to 0 for all allocated chunks through `memset`.
+// it gurantees memory are set to 0 for all allocated chunks without explicit `memset`:
+// small chunks come from calloc, large chunks are mapped pages zeroed by kernel on first touch,
+// which also grow in place through mremap rather than copy and prefer transparent huge pages.
+// Accounting is atomic since the default pool is shared by all threads.
 class Pool {
 public:
-  virtual ~Pool() = default;
+  // chunks no smaller than this size are served by mapped pages
+  static constexpr size_t LARGE_CHUNK = 1024 * 1024;
 
-  inline void* allocate(size_t size) {
-    allocated_ += size;
-    return std::memset(std::malloc(size), 0, size);
-  }
+  virtual ~Pool() = default;
 
-  inline void free(void* p, size_t size) {
-    freed_ += size;
-    std::free(p);
-  }
+  // allocate a zeroed memory chunk
+  void* allocate(size_t size);
 
-  void* extend(void* p, size_t size, size_t newSize) {
-    N_ENSURE_GT(newSize, size, "new size should be larger than original size");
+  // free a chunk, size has to be the same as allocated or extended
+  void free(void* p, size_t size);
 
-    // extend the memory if possible
-    NByte* newP = (NByte*)std::realloc(p, newSize);
-    if (N_UNLIKELY(!newP)) {
-      free(p, size);
-      throw std::bad_alloc();
-    }
+  // extend a chunk to new size with zeroed tail, existing data is kept
+  void* extend(void* p, size_t size, size_t newSize);
 
-    auto delta = newSize - size;
-    extended_ += delta;
-    std::memset(newP + size, 0, delta);
-    return newP;
+  // bytes held by live chunks
+  inline size_t live() const {
+    return allocated_.load(std::memory_order_relaxed)
+           + extended_.load(std::memory_order_relaxed)
+           - freed_.load(std::memory_order_relaxed);
   }
 
   std::string report() const {
-    return fmt::format("Allocated:{0}, Extended:{1}, Freed:{2}", allocated_, extended_, freed_);
+    return fmt::format("Allocated:{0}, Extended:{1}, Freed:{2}, Live:{3}",
+                       allocated_.load(), extended_.load(), freed_.load(), live());
   }
 
   static Pool& getDefault();
 
 private:
-  // TODO(cao): a start point of pool impl, need a better pool management
   Pool() : allocated_{ 0 }, extended_{ 0 }, freed_{ 0 } {}
 
-  size_t allocated_;
-  size_t extended_;
-  size_t freed_;
+  std::atomic<size_t> allocated_;
+  std::atomic<size_t> extended_;
+  std::atomic<size_t> freed_;
 };
 
 enum class SliceType {
@@ -201,6 +198,35 @@ public:
     return writeSize(position, value, std::max(size, alignment));
   }
 
+  // write an unsigned integer as varint (7 bits per byte, protobuf convention)
+  // return number of bytes written, at most 10 bytes for 64 bits value
+  inline size_t writeVarint(size_t position, uint64_t value) {
+    NByte bytes[10];
+    size_t len = 0;
+    while (value >= 0x80) {
+      bytes[len++] = static_cast<NByte>((value & 0x7F) | 0x80);
+      value >>= 7;
+    }
+
+    bytes[len++] = static_cast<NByte>(value);
+    return write(position, bytes, len);
+  }
+
+  // read a varint at given position into value, return number of bytes consumed
+  inline size_t readVarint(size_t position, uint64_t& value) const {
+    value = 0;
+    size_t len = 0;
+    uint8_t b;
+    do {
+      N_ENSURE_LT(len, 10, "corrupted varint");
+      b = static_cast<uint8_t>(this->ptr_[position + len]);
+      value |= static_cast<uint64_t>(b & 0x7F) << (7 * len);
+      ++len;
+    } while (b & 0x80);
+
+    return len;
+  }
+
   // NOTE: (found a g++ bug)
   // It declares the method is not mark as const if we change the signature as
   // auto read(size_t position) -> typename std::enable_if<std::is_scalar<T>::value, T&>::type const {
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fmt/format.h>
 #include <iostream>
 #include <queue>
@@ -24,6 +25,7 @@
 #include <rapidjson/writer.h>
 
 #include "Hash.h"
+#include "Memory.h"
 
 namespace nebula {
 namespace common {
@@ -217,6 +219,81 @@ public:
     return buffer.GetString();
   }
 
+  // compact binary format used to ship the tree across nodes:
+  // [varint #names][varint len, bytes]... [varint #nodes] then nodes in pre-order as
+  // [varint name id][varint count][varint #children], depth is implied by the order.
+  // every distinct frame name is written once no matter how many times it appears in the tree.
+  size_t serialize(ExtendableSlice& slice, size_t offset) const {
+    static_assert(std::is_same_v<T, std::string> || std::is_integral_v<T>, "binary tree supports string or integral");
+    const auto origin = offset;
+
+    // assign name ids in pre-order
+    std::vector<const FT*> nodes;
+    unordered_map<T, uint64_t> ids;
+    std::vector<const T*> names;
+    std::vector<const FT*> stack{ root_.get() };
+    while (!stack.empty()) {
+      auto node = stack.back();
+      stack.pop_back();
+      nodes.push_back(node);
+      if (ids.emplace(node->data, names.size()).second) {
+        names.push_back(&node->data);
+      }
+
+      // reverse pushed children so they are visited in their own order
+      const auto top = stack.size();
+      for (auto& child : node->children) {
+        stack.push_back(child.get());
+      }
+      std::reverse(stack.begin() + top, stack.end());
+    }
+
+    offset += slice.writeVarint(offset, names.size());
+    for (auto name : names) {
+      if constexpr (std::is_same_v<T, std::string>) {
+        offset += slice.writeVarint(offset, name->size());
+        offset += slice.write(offset, name->data(), name->size());
+      } else {
+        offset += slice.write(offset, *name);
+      }
+    }
+
+    offset += slice.writeVarint(offset, nodes.size());
+    for (auto node : nodes) {
+      offset += slice.writeVarint(offset, ids.at(node->data));
+      offset += slice.writeVarint(offset, node->count);
+      offset += slice.writeVarint(offset, node->children.size());
+    }
+
+    return offset - origin;
+  }
+
+  // reset current tree from the binary written by serialize, return number of bytes consumed
+  size_t load(const ExtendableSlice& slice, size_t offset) {
+    const auto origin = offset;
+    uint64_t numNames = 0;
+    offset += slice.readVarint(offset, numNames);
+    std::vector<T> names;
+    names.reserve(numNames);
+    for (uint64_t i = 0; i < numNames; ++i) {
+      if constexpr (std::is_same_v<T, std::string>) {
+        uint64_t len = 0;
+        offset += slice.readVarint(offset, len);
+        names.emplace_back(slice.read(offset, len));
+        offset += len;
+      } else {
+        names.push_back(slice.read<T>(offset));
+        offset += sizeof(T);
+      }
+    }
+
+    uint64_t numNodes = 0;
+    offset += slice.readVarint(offset, numNodes);
+    N_ENSURE_GT(numNodes, 0, "stack tree has a root at least");
+    root_ = load(slice, offset, names, 0);
+    return offset - origin;
+  }
+
   // print as lines of strings in alphabatic order - debug/test purpose only
   friend std::ostream& operator<<(std::ostream& os, const StackTree& tree) noexcept {
     std::queue<FT*> q;
@@ -311,6 +388,22 @@ private:
     root_ = parse(root, 0);
   }
 
+  // load a node and all its children in pre-order, offset moves forward
+  static std::unique_ptr<FT> load(const ExtendableSlice& slice, size_t& offset, const std::vector<T>& names, size_t depth) {
+    uint64_t id = 0, count = 0, children = 0;
+    offset += slice.readVarint(offset, id);
+    offset += slice.readVarint(offset, count);
+    offset += slice.readVarint(offset, children);
+    N_ENSURE_LT(id, names.size(), "name id out of dictionary");
+
+    auto node = std::make_unique<FT>(names.at(id), depth, count);
+    for (uint64_t i = 0; i < children; ++i) {
+      node->add(load(slice, offset, names, depth + 1));
+    }
+
+    return node;
+  }
+
   static FT* visit(FT* current, const T& data) {
     current = current->addIfNotFound(data, current->depth + 1);
     ++current->count;
@@ -1065,6 +1065,41 @@ TEST(CommonTest, TestCharsLast) {
   EXPECT_EQ(nebula::common::Chars::last(str5), "xyz");
 }
 
+TEST(CommonTest, TestCharsFindAndLower) {
+  using nebula::common::Chars;
+  // small alphabet with both cases to hit many candidate positions of the vector search
+  static constexpr char ALPHABET[] = "abcABC xyz";
+  auto rand = nebula::common::Evidence::rand(0, sizeof(ALPHABET) - 2);
+  auto gen = [&rand](size_t size) {
+    std::string s(size, ' ');
+    for (size_t i = 0; i < size; ++i) {
+      s[i] = ALPHABET[rand()];
+    }
+    return s;
+  };
+
+  for (auto i = 0; i < 2000; ++i) {
+    auto text = gen(i % 100);
+    auto word = gen(i % 5 + 1);
+    for (size_t from = 0; from <= text.size(); from += 7) {
+      EXPECT_EQ(Chars::find(text, word, from), std::string_view(text).find(word, from));
+    }
+
+    // lower case is the same as std::tolower in default locale
+    std::string lowered(text.size(), ' ');
+    Chars::lower(text.data(), text.size(), lowered.data());
+    for (size_t k = 0; k < text.size(); ++k) {
+      EXPECT_EQ(lowered[k], (char)std::tolower(text[k]));
+    }
+
+    EXPECT_TRUE(Chars::iequal(text.data(), lowered.data(), text.size()));
+  }
+
+  EXPECT_EQ(Chars::find("hello", "", 2), 2);
+  EXPECT_EQ(Chars::find("hello", "lo", 4), std::string_view::npos);
+  EXPECT_FALSE(Chars::iequal("Nebula@", "nebula`", 7));
+}
+
 TEST(CommonTest, TestRange) {
   nebula::common::PRange r1;
   EXPECT_EQ(r1.offset, 0);
@@ -1551,6 +1586,44 @@ TEST(CommonTest, TestStackTree) {
   }
 }
 
+TEST(CommonTest, TestStackTreeBinary) {
+  nebula::common::StackTree<std::string, true> stack;
+  stack.merge(std::vector<std::string>{ "A", "B", "C" });
+  stack.merge(std::vector<std::string>{ "A", "B", "D" });
+  stack.merge(std::vector<std::string>{ "A", "X", "B" });
+  for (auto i = 0; i < 300; ++i) {
+    stack.merge(std::vector<std::string>{ "A", "X", fmt::format("F{0}", i % 7) });
+  }
+
+  // names are written once, counts over 127 take two bytes
+  nebula::common::ExtendableSlice slice(16);
+  auto size = stack.serialize(slice, 3);
+  nebula::common::StackTree<std::string, true> loaded;
+  EXPECT_EQ(loaded.load(slice, 3), size);
+  EXPECT_LT(size, stack.jsonfy().size());
+
+  std::stringstream expected;
+  expected << stack;
+  std::stringstream actual;
+  actual << loaded;
+  EXPECT_EQ(actual.str(), expected.str());
+
+  // varint round trip at boundaries
+  size_t offset = 0;
+  const uint64_t values[] = { 0, 127, 128, 16383, 16384, std::numeric_limits<uint64_t>::max() };
+  for (auto v : values) {
+    offset += slice.writeVarint(offset, v);
+  }
+
+  EXPECT_EQ(offset, 1 + 1 + 2 + 2 + 3 + 10);
+  offset = 0;
+  for (auto v : values) {
+    uint64_t value = 0;
+    offset += slice.readVarint(offset, value);
+    EXPECT_EQ(value, v);
+  }
+}
+
 TEST(CommonTest, TestIStream) {
   std::string_view view = "abc\nxyz";
   nebula::common::IStream stream(view);
@@ -172,6 +172,79 @@ TEST(HashRingTest, TestAddOneNodeEachTime) {
   }
 }
 
+TEST(HashRingTest, TestBoundedRing) {
+  // node ID and memory weight
+  using Node = std::pair<std::string, size_t>;
+  const auto id = [](const Node& n) { return n.first; };
+  const auto weight = [](const Node& n) { return n.second; };
+
+  std::vector<Node> nodes;
+  for (auto i = 0; i < 10; ++i) {
+    nodes.emplace_back(fmt::format("NODE-{0}", i), i < 5 ? 32 : 64);
+  }
+
+  const auto DATA_ITEMS = 10000;
+  const auto place = [&](const std::vector<Node>& cluster) {
+    BoundedRing<Node> ring(cluster, id, weight, DATA_ITEMS);
+    unordered_map<std::string, std::string> placement;
+    for (auto i = 0; i < DATA_ITEMS; ++i) {
+      auto key = fmt::format("DATA-{0}", i);
+      auto node = ring.attach(key);
+      EXPECT_NE(node, nullptr);
+      placement.emplace(key, node->first);
+    }
+
+    // no node exceeds its bound and bigger nodes take more keys
+    for (const auto& n : cluster) {
+      EXPECT_LE(ring.load(n.first), ring.capacity(n.first));
+    }
+    EXPECT_GT(ring.load("NODE-9"), ring.load("NODE-0"));
+    return placement;
+  };
+
+  const auto moved = [](const auto& p1, const auto& p2) {
+    size_t count = 0;
+    for (const auto& kv : p1) {
+      if (p2.at(kv.first) != kv.second) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  // placement doesn't depend on node order
+  auto base = place(nodes);
+  auto reversed = nodes;
+  std::reverse(reversed.begin(), reversed.end());
+  EXPECT_EQ(moved(base, place(reversed)), 0);
+
+  // losing a node only moves its share plus a few spilled by the bound
+  auto lost = nodes;
+  lost.erase(lost.begin() + 7);
+  auto count = moved(base, place(lost));
+  LOG(INFO) << "keys moved after losing a node: " << count;
+  EXPECT_LT(count, DATA_ITEMS / 4);
+
+  // adding a node takes about its share from others
+  auto scaled = nodes;
+  scaled.emplace_back("NODE-10", 64);
+  count = moved(base, place(scaled));
+  LOG(INFO) << "keys moved after adding a node: " << count;
+  EXPECT_LT(count, DATA_ITEMS / 4);
+
+  // charged keys count into the bound, a full node pushes keys to its neighbors
+  BoundedRing<Node> ring(nodes, id, weight, DATA_ITEMS);
+  const auto cap = ring.capacity("NODE-3");
+  for (size_t i = 0; i < cap; ++i) {
+    EXPECT_TRUE(ring.charge("NODE-3"));
+  }
+  EXPECT_FALSE(ring.charge("NODE-X"));
+  for (auto i = 0; i < DATA_ITEMS - (int)cap; ++i) {
+    EXPECT_NE(ring.attach(fmt::format("DATA-{0}", i))->first, "NODE-3");
+  }
+  EXPECT_EQ(ring.load("NODE-3"), cap);
+}
+
 } // namespace test
 } // namespace common
 } // namespace nebula
\ No newline at end of file
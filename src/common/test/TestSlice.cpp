@@ -40,6 +40,47 @@ TEST(SliceTest, TestWriteEmptySlice) {
 #undef WRITE_TO_EMTPY_SLICE
 }
 
+TEST(SliceTest, TestPoolLargeChunk) {
+  auto& pool = nebula::common::Pool::getDefault();
+  const auto live = pool.live();
+
+  // grow a chunk from heap into mapped pages and keep growing
+  constexpr size_t small = 4096;
+  auto p = static_cast<NByte*>(pool.allocate(small));
+  for (size_t i = 0; i < small; ++i) {
+    EXPECT_EQ(p[i], 0);
+    p[i] = i % 127;
+  }
+
+  size_t size = small;
+  for (auto newSize : { Pool::LARGE_CHUNK, 3 * Pool::LARGE_CHUNK, 8 * Pool::LARGE_CHUNK + 7 }) {
+    p = static_cast<NByte*>(pool.extend(p, size, newSize));
+
+    // existing data is kept and extended part is zeroed
+    for (size_t i = 0; i < small; ++i) {
+      EXPECT_EQ(p[i], i % 127);
+    }
+
+    for (size_t i = size; i < newSize; i += 997) {
+      EXPECT_EQ(p[i], 0);
+    }
+
+    p[newSize - 1] = 1;
+    size = newSize;
+  }
+
+  EXPECT_EQ(pool.live(), live + size);
+  pool.free(p, size);
+  EXPECT_EQ(pool.live(), live);
+
+  // large allocation is zeroed
+  auto q = static_cast<NByte*>(pool.allocate(Pool::LARGE_CHUNK * 2));
+  EXPECT_EQ(q[0], 0);
+  EXPECT_EQ(q[Pool::LARGE_CHUNK * 2 - 1], 0);
+  pool.free(q, Pool::LARGE_CHUNK * 2);
+  EXPECT_EQ(pool.live(), live);
+}
+
 } // namespace test
 } // namespace common
 } // namespace nebula
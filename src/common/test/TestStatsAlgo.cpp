@@ -500,6 +500,61 @@ TEST(HyperLogLogTest, TestHLLSerde) {
   EXPECT_EQ(card1, card2);
 }
 
+TEST(HyperLogLogTest, TestHLLAdaptive) {
+  using Mode = HyperLogLog::Mode;
+  // exact up to 1024 hashes, sparse up to 4096 registers for 64K registers
+  const auto fill = [](HyperLogLog& hll, size_t from, size_t to) {
+    for (auto i = from; i < to; ++i) {
+      auto str = std::to_string(i);
+      hll.add(str.data(), str.size());
+    }
+  };
+
+  HyperLogLog exact(16), sparse(16), dense(16), single(16);
+  fill(exact, 0, 1000);
+  fill(sparse, 1000, 3000);
+  fill(dense, 3000, 100000);
+  fill(single, 0, 100000);
+  EXPECT_EQ(exact.mode(), Mode::EXACT);
+  EXPECT_EQ(sparse.mode(), Mode::SPARSE);
+  EXPECT_EQ(dense.mode(), Mode::DENSE);
+  EXPECT_EQ(exact.estimate(), 1000);
+  EXPECT_NEAR(sparse.estimate(), 2000, 40);
+
+  // every store round trips through compact binary
+  ExtendableSlice slice(1024);
+  size_t offset = 0;
+  for (auto hll : { &exact, &sparse, &dense }) {
+    auto size = hll->serialize(slice, offset);
+    HyperLogLog copy(16);
+    EXPECT_EQ(copy.load(slice, offset), size);
+    EXPECT_EQ(copy.mode(), hll->mode());
+    EXPECT_EQ(copy.estimate(), hll->estimate());
+    offset += size;
+  }
+
+  // a small set costs a few bytes per value rather than all registers
+  HyperLogLog tiny(16);
+  fill(tiny, 0, 10);
+  EXPECT_LT(tiny.serialize(slice, 0), 64);
+
+  // merge in any order of stores ends up with the same registers as a single store
+  HyperLogLog merged(16);
+  merged.merge(exact);
+  EXPECT_EQ(merged.mode(), Mode::EXACT);
+  merged.merge(sparse);
+  EXPECT_EQ(merged.mode(), Mode::SPARSE);
+  merged.merge(dense);
+  EXPECT_EQ(merged.mode(), Mode::DENSE);
+  EXPECT_EQ(merged.estimate(), single.estimate());
+
+  HyperLogLog reversed(16);
+  reversed.merge(dense);
+  reversed.merge(sparse);
+  reversed.merge(exact);
+  EXPECT_EQ(reversed.estimate(), single.estimate());
+}
+
 } // namespace test
 } // namespace common
 } // namespace nebula
\ No newline at end of file
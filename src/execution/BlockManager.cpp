@@ -16,6 +16,10 @@
 
 #include "BlockManager.h"
 
+#include <chrono>
+#include <limits>
+#include <gflags/gflags.h>
+
 #include "common/Folly.h"
 #include "common/Wrap.h"
 #include "type/Tree.h"
@@ -23,6 +27,9 @@
 /**
  * Nebula execution in block managment.
  */
+DEFINE_uint64(NODE_STATE_CHANGES, 100000, "max number of local block changes kept for incremental state sync");
+DEFINE_uint64(NODE_PRUNING_SYNC_MS, 5000, "node pruning trusts remote node states synced within this many milliseconds");
+
 namespace nebula {
 namespace execution {
 
@@ -35,6 +42,8 @@ using nebula::meta::NNode;
 using nebula::meta::Table;
 using nebula::surface::eval::BlockEval;
 using nebula::surface::eval::Histogram;
+using nebula::surface::eval::IntHistogram;
+using nebula::surface::eval::RealHistogram;
 using nebula::surface::eval::ValueEval;
 using nebula::type::Kind;
 using nebula::type::Schema;
@@ -44,6 +53,14 @@ using nebula::type::TypeNode;
 std::mutex BlockManager::smux;
 std::shared_ptr<BlockManager> BlockManager::inst = nullptr;
 
+// epoch is unique for every process so that a restarted node is never taken as the same state
+BlockManager::BlockManager()
+  : blocks_{ 0 },
+    epoch_{ (uint64_t)std::chrono::system_clock::now().time_since_epoch().count() },
+    generation_{ 1 } {
+  data_.emplace(NNode::inproc(), TableStates{});
+}
+
 std::shared_ptr<BlockManager> BlockManager::init() {
   std::lock_guard<std::mutex> lock(BlockManager::smux);
   if (inst == nullptr) {
@@ -74,6 +91,160 @@ const std::vector<NNode> BlockManager::query(const std::string& table) {
   return nodes;
 }
 
+// Block metadata synced from a node presented as a block,
+// so that block level evaluation of a filter applies to a remote block by its histograms.
+// Partition values and bloom filters are not synced, any value is probably in the block.
+class MetaBlock : public nebula::surface::eval::Block {
+public:
+  MetaBlock(const Table& table, const Schema& schema, const nebula::meta::BlockState& state)
+    : table_{ table }, schema_{ schema }, state_{ state } {}
+  virtual ~MetaBlock() = default;
+
+  inline Schema schema() const override {
+    return schema_;
+  }
+
+  inline size_t getRows() const override {
+    return state_.numRows;
+  }
+
+  TypeNode columnType(const std::string& col) const override {
+    return schema_->find(col);
+  }
+
+  // a partition column has no histogram, and a column may be missing in an older block,
+  // they get a histogram covering the full range of the column type.
+  std::shared_ptr<Histogram> histogram(const std::string& col) const override {
+    const auto kind = schema_->find(col)->k();
+    if (!table_.column(col).partition.valid()) {
+      for (const auto& h : state_.histograms) {
+        if (h->name == col) {
+          if (matches(kind, h)) {
+            return h;
+          }
+
+          break;
+        }
+      }
+    }
+
+    switch (kind) {
+#define FULL_RANGE(KIND, HT)                                                 \
+  case Kind::KIND: {                                                         \
+    using T = nebula::type::TypeTraits<Kind::KIND>::CppType;                 \
+    const auto min = std::numeric_limits<T>::lowest();                       \
+    const auto max = std::numeric_limits<T>::max();                          \
+    return std::make_shared<HT>(col, state_.numRows, min, max, 0);           \
+  }
+      FULL_RANGE(TINYINT, IntHistogram)
+      FULL_RANGE(SMALLINT, IntHistogram)
+      FULL_RANGE(INTEGER, IntHistogram)
+      FULL_RANGE(BIGINT, IntHistogram)
+      FULL_RANGE(REAL, RealHistogram)
+      FULL_RANGE(DOUBLE, RealHistogram)
+#undef FULL_RANGE
+    default:
+      return std::make_shared<Histogram>(col, state_.numRows);
+    }
+  }
+
+  std::vector<std::any> partitionValues(const std::string&) const override {
+    return {};
+  }
+
+  bool probably(const std::string&, std::any) const override {
+    return true;
+  }
+
+private:
+  static bool matches(Kind kind, const std::shared_ptr<Histogram>& h) {
+    switch (kind) {
+    case Kind::TINYINT:
+    case Kind::SMALLINT:
+    case Kind::INTEGER:
+    case Kind::BIGINT:
+      return std::dynamic_pointer_cast<IntHistogram>(h) != nullptr;
+    case Kind::REAL:
+    case Kind::DOUBLE:
+      return std::dynamic_pointer_cast<RealHistogram>(h) != nullptr;
+    default:
+      return true;
+    }
+  }
+
+private:
+  const Table& table_;
+  const Schema& schema_;
+  const nebula::meta::BlockState& state_;
+};
+
+std::vector<NNode> BlockManager::prune(const Table& table,
+                                       const PlanPtr plan,
+                                       const std::vector<NNode>& nodes) const {
+  const auto& window = plan->getWindow();
+  const auto& version = plan->tableVersion();
+  const auto& filter = plan->fetch<PhaseType::COMPUTE>().filter();
+  const auto schema = table.schema();
+
+  const auto now = SyncClock::now();
+  const auto maxAge = std::chrono::milliseconds(FLAGS_NODE_PRUNING_SYNC_MS);
+
+  std::vector<NNode> result;
+  vector_reserve(result, nodes.size(), "BlockManager::prune");
+  for (const auto& node : nodes) {
+    // table state snapshot of the node, keep the node if we know nothing about it:
+    // the table may be ingested or a live block may grow since last sync.
+    std::shared_ptr<TableState> state = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(dmux_);
+      auto synced = synced_.find(node);
+      if (synced != synced_.end() && now - synced->second > maxAge) {
+        result.push_back(node);
+        continue;
+      }
+
+      auto states = data_.find(node);
+      if (states == data_.end()) {
+        result.push_back(node);
+        continue;
+      }
+
+      auto ts = states->second.find(table.name());
+      if (ts == states->second.end()) {
+        result.push_back(node);
+        continue;
+      }
+
+      state = ts->second;
+    }
+
+    // rows, window and histograms of live blocks are behind their data
+    if (state->live()) {
+      result.push_back(node);
+      continue;
+    }
+
+    // local blocks are evaluated on data directly
+    for (const auto& b : state->blocks(window, version)) {
+      const auto& data = b->data();
+      auto eval = BlockEval::PARTIAL;
+      if (data != nullptr) {
+        auto pin = data->pin();
+        eval = filter.eval(*data);
+      } else {
+        eval = filter.eval(MetaBlock{ table, schema, b->state() });
+      }
+
+      if (eval != BlockEval::NONE) {
+        result.push_back(node);
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
 static constexpr auto BATCH_SIZE = 100;
 folly::Future<FilteredBlocks> batch(folly::ThreadPoolExecutor& pool,
                                     const ValueEval& filter,
@@ -87,7 +258,15 @@ folly::Future<FilteredBlocks> batch(folly::ThreadPoolExecutor& pool,
       for (size_t i = 0; i < size; ++i) {
         auto ptr = input[i];
 
+        auto pin = ptr->pin();
         auto eval = filter.eval(*ptr);
+
+        // a live batch may get new rows before it's computed which are not covered by this eval,
+        // so they can't skip the row filter. (NONE only misses rows appended after the query started)
+        if (eval == BlockEval::ALL && !ptr->sealed()) {
+          eval = BlockEval::PARTIAL;
+        }
+
         if (eval != BlockEval::NONE) {
           blocks.emplace_back(ptr, eval);
         }
@@ -186,12 +365,21 @@ bool BlockManager::add(std::shared_ptr<io::BatchBlock> block) {
   ++blocks_;
 
   auto itr = data_.find(node);
-  if (itr != data_.end()) {
-    return addBlock(itr->second, block);
+  if (itr == data_.end()) {
+    itr = data_.emplace(node, TableStates{}).first;
   }
 
-  data_.emplace(node, TableStates{});
-  return addBlock(data_.at(node), block);
+  if (!addBlock(itr->second, block)) {
+    return false;
+  }
+
+  if (node.isInProc()) {
+    record(block->table(), block->spec(), block);
+  } else {
+    synced_[node] = SyncClock::now();
+  }
+
+  return true;
 }
 
 size_t BlockManager::add(BlockList& range) {
@@ -208,9 +396,34 @@ size_t BlockManager::add(BlockList& range) {
   return numAdded;
 }
 
+bool BlockManager::replace(std::shared_ptr<BatchBlock> block) {
+  N_ENSURE(block->residence().isInProc(), "only local blocks can be replaced.");
+  std::lock_guard<std::mutex> lock(dmux_);
+  auto& self = local();
+  const auto& table = block->table();
+  const auto& spec = block->spec();
+  auto state = self.find(table);
+  if (state == self.end()) {
+    ++blocks_;
+    addBlock(self, block);
+    record(table, spec, block);
+    return true;
+  }
+
+  // counter - note that this may be used for appromimate only, not for accurate internal state
+  const auto count = state->second->replace(block);
+  blocks_ = blocks_ + 1 - count;
+  if (count > 0) {
+    record(table, spec, nullptr);
+  }
+
+  record(table, spec, block);
+  return true;
+}
+
 // remove all blocks that share the given spec
-// NOTE: thread-unsafe~!
 size_t BlockManager::removeBySpec(const std::string& table, const std::string& spec) {
+  std::lock_guard<std::mutex> lock(dmux_);
   size_t count = 0;
   auto& self = local();
   auto state = self.find(table);
@@ -221,9 +434,110 @@ size_t BlockManager::removeBySpec(const std::string& table, const std::string& s
   // decrement blocks counter
   blocks_ -= count;
 
+  if (count > 0) {
+    record(table, spec, nullptr);
+  }
+
   return count;
 }
 
+void BlockManager::record(const std::string& table, const std::string& spec, std::shared_ptr<BatchBlock> block) {
+  changes_.push_back(BlockChange{ ++generation_, table, spec, block });
+  while (changes_.size() > FLAGS_NODE_STATE_CHANGES) {
+    changes_.pop_front();
+  }
+}
+
+std::pair<SyncPoint, bool> BlockManager::visit(
+  SyncPoint from,
+  std::function<void(const std::string&, const std::string&)> removed,
+  std::function<void(const BatchBlock&)> added) const {
+  std::lock_guard<std::mutex> lock(dmux_);
+  const SyncPoint sync{ epoch_, generation_ };
+
+  // all changes after the generation of the same process have to be in the log
+  const auto since = from.second;
+  const auto covered = from.first == epoch_
+                       && since > 0
+                       && since <= generation_
+                       && (changes_.empty() ? since == generation_ : since + 1 >= changes_.front().generation);
+  if (!covered) {
+    for (const auto& ts : local()) {
+      ts.second->iterate(added);
+    }
+
+    return { sync, false };
+  }
+
+  // walk changes backwards, a block is alive only if its spec is not removed later
+  TableSpecSet specs;
+  std::vector<std::shared_ptr<BatchBlock>> blocks;
+  for (auto itr = changes_.rbegin(); itr != changes_.rend() && itr->generation > since; ++itr) {
+    auto key = std::make_pair(itr->table, itr->spec);
+    if (specs.find(key) != specs.end()) {
+      continue;
+    }
+
+    auto block = itr->block.lock();
+    if (block == nullptr) {
+      specs.emplace(std::move(key));
+      continue;
+    }
+
+    blocks.push_back(block);
+  }
+
+  for (const auto& spec : specs) {
+    removed(spec.first, spec.second);
+  }
+
+  for (auto itr = blocks.rbegin(); itr != blocks.rend(); ++itr) {
+    added(**itr);
+  }
+
+  return { sync, true };
+}
+
+void BlockManager::apply(const NNode& node,
+                         const TableSpecSet& removed,
+                         const std::vector<std::shared_ptr<BatchBlock>>& added,
+                         SyncPoint sync) {
+  std::lock_guard<std::mutex> lock(dmux_);
+  auto& states = data_[node];
+
+  // remove specs table by table so that table metrics are rebuilt once
+  nebula::common::unordered_map<std::string, nebula::common::unordered_set<std::string>> specs;
+  for (const auto& ts : removed) {
+    specs[ts.first].emplace(ts.second);
+  }
+
+  for (const auto& ts : specs) {
+    auto state = states.find(ts.first);
+    if (state != states.end()) {
+      state->second->remove(ts.second);
+    }
+  }
+
+  for (const auto& block : added) {
+    addBlock(states, block);
+  }
+
+  // a table has no blocks left in the node
+  std::vector<std::string> empties;
+  for (const auto& ts : states) {
+    if (ts.second->numBlocks() == 0) {
+      empties.push_back(ts.first);
+    }
+  }
+
+  for (const auto& table : empties) {
+    states.erase(table);
+  }
+
+  syncs_[node] = sync;
+  synced_[node] = SyncClock::now();
+}
+
 std::shared_ptr<Histogram> BlockManager::hist(const std::string& table, size_t col) const {
   std::lock_guard<std::mutex> lock(dmux_);
 
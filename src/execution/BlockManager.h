@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <forward_list>
 #include <mutex>
 
@@ -50,6 +53,21 @@ using TableStates = nebula::common::unordered_map<std::string, std::shared_ptr<T
 using FilteredBlocks = std::vector<nebula::memory::EvaledBlock>;
 using StringSet = nebula::common::unordered_set<std::string>;
 
+// sync point of a node state: epoch identifies a node process and generation counts its block changes
+using SyncPoint = std::pair<uint64_t, uint64_t>;
+using SyncClock = std::chrono::steady_clock;
+
+// version of a table's block set: sync point of every node holding the table, sorted by node
+using BlockVersion = std::vector<std::pair<std::string, SyncPoint>>;
+
+// a change of local blocks, a removal of all blocks of the spec if block is not set
+struct BlockChange {
+  uint64_t generation;
+  std::string table;
+  std::string spec;
+  std::weak_ptr<io::BatchBlock> block;
+};
+
 // distribution of table data in the cluster
 struct TableStats {
   TableStats(const std::string& table)
@@ -77,6 +95,13 @@ public:
   // query all nodes that hold data for given table
   const std::vector<nebula::meta::NNode> query(const std::string&);
 
+  // keep nodes having any block that may pass the filter of given plan,
+  // evaluated on block metadata synced from each node.
+  // a node is always kept if its metadata may be behind: not synced recently, no state of the table, or live blocks.
+  std::vector<nebula::meta::NNode> prune(const nebula::meta::Table&,
+                                         const PlanPtr,
+                                         const std::vector<nebula::meta::NNode>&) const;
+
   // add given block into the target table states repo
   static bool addBlock(TableStates&, std::shared_ptr<io::BatchBlock>);
 
@@ -95,6 +120,10 @@ public:
     return add(list);
   }
 
+  // replace all local blocks of the spec of given block by it at once,
+  // eg. publish a new state of a block still being built.
+  bool replace(std::shared_ptr<io::BatchBlock>);
+
   // remove blocks by table name and spec signature
   // return number of blocks removed
   size_t removeBySpec(const std::string&, const std::string&);
@@ -130,15 +159,40 @@ public:
   }
 
   // swap table states for given node
-  inline void swap(const nebula::meta::NNode& node, TableStates states) {
+  inline void swap(const nebula::meta::NNode& node, TableStates states, SyncPoint sync = { 0, 0 }) {
     std::lock_guard<std::mutex> lock(dmux_);
     data_[node] = states;
+    syncs_[node] = sync;
+    synced_[node] = SyncClock::now();
   }
 
+  // apply changes of given node in place: remove all blocks of removed specs, then add blocks
+  void apply(const nebula::meta::NNode&,
+             const TableSpecSet&,
+             const std::vector<std::shared_ptr<io::BatchBlock>>&,
+             SyncPoint);
+
+  // sync point of given node's states in current block manager
+  inline SyncPoint sync(const nebula::meta::NNode& node) const {
+    std::lock_guard<std::mutex> lock(dmux_);
+    auto found = syncs_.find(node);
+    return found == syncs_.end() ? SyncPoint{ 0, 0 } : found->second;
+  }
+
+  // visit local blocks consistently with current sync point:
+  // changes after given sync point if it's covered by the change log, all blocks otherwise.
+  // return current sync point and whether it's a delta,
+  // a delta visits removed specs (table, spec) first and then blocks added after.
+  std::pair<SyncPoint, bool> visit(SyncPoint,
+                                   std::function<void(const std::string&, const std::string&)>,
+                                   std::function<void(const io::BatchBlock&)>) const;
+
   inline void removeNode(const std::string& addr) {
     std::lock_guard<std::mutex> lock(dmux_);
     for (auto itr = data_.begin(); itr != data_.end(); ++itr) {
       if (addr == itr->first.toString()) {
+        syncs_.erase(itr->first);
+        synced_.erase(itr->first);
         data_.erase(itr);
         break;
       }
@@ -207,6 +261,30 @@ public:
     return stats;
   }
 
+  // version of the block set of given table across all nodes,
+  // it moves whenever any block of a node holding the table is added, replaced or expired.
+  BlockVersion version(const std::string& table) const {
+    std::lock_guard<std::mutex> lock(dmux_);
+    BlockVersion version;
+    for (const auto& ts : data_) {
+      if (ts.second.find(table) == ts.second.end()) {
+        continue;
+      }
+
+      // local blocks are versioned by the change log, remote ones by their last sync point
+      SyncPoint point{ epoch_, generation_ };
+      if (!ts.first.isInProc()) {
+        auto found = syncs_.find(ts.first);
+        point = found == syncs_.end() ? SyncPoint{ 0, 0 } : found->second;
+      }
+
+      version.emplace_back(ts.first.toString(), point);
+    }
+
+    std::sort(version.begin(), version.end());
+    return version;
+  }
+
   // get all active specs
   StringSet activeSpecs() const {
     std::lock_guard<std::mutex> lock(dmux_);
@@ -231,9 +309,10 @@ public:
   std::shared_ptr<nebula::surface::eval::Histogram> hist(const std::string&, size_t) const;
 
 private:
-  BlockManager() : blocks_{ 0 } {
-    data_.emplace(nebula::meta::NNode::inproc(), TableStates{});
-  }
+  BlockManager();
+
+  // record a change of local blocks, called with data lock held
+  void record(const std::string&, const std::string&, std::shared_ptr<io::BatchBlock>);
 
   inline TableStates& local() {
     return data_.at(nebula::meta::NNode::inproc());
@@ -265,6 +344,27 @@ private:
     nebula::meta::NodeEqual>
     data_;
 
+  // sync point of every remote node states
+  nebula::common::unordered_map<
+    nebula::meta::NNode,
+    SyncPoint,
+    nebula::meta::NodeHash,
+    nebula::meta::NodeEqual>
+    syncs_;
+
+  // last time every remote node states synced
+  nebula::common::unordered_map<
+    nebula::meta::NNode,
+    SyncClock::time_point,
+    nebula::meta::NodeHash,
+    nebula::meta::NodeEqual>
+    synced_;
+
+  // change log of local blocks, bounded and led by the oldest change
+  const uint64_t epoch_;
+  uint64_t generation_;
+  std::deque<BlockChange> changes_;
+
   // empty specs
   StringSet emptySpecs_;
   mutable std::mutex dmux_;
@@ -45,16 +45,22 @@ struct QueryStats {
   explicit QueryStats()
     : blocksScan{ 0 },
       rowsScan{ 0 },
-      rowsRet{ 0 } {}
+      rowsRet{ 0 },
+      nodesQuery{ 0 },
+      nodesDone{ 0 } {}
   // blocks scanned in given compute
   size_t blocksScan;
   // rows scanned in given compute
   size_t rowsScan;
   // rows returned in given compute
   size_t rowsRet;
+  // nodes the query fans out to
+  size_t nodesQuery;
+  // nodes completed before the result is returned, less than nodesQuery means approximate result
+  size_t nodesDone;
   inline std::string toString() const {
-    return fmt::format("blocks scan:{0}, rows scan: {1}, rows returned: {2}",
-                       blocksScan, rowsScan, rowsRet);
+    return fmt::format("blocks scan:{0}, rows scan: {1}, rows returned: {2}, nodes done: {3}/{4}",
+                       blocksScan, rowsScan, rowsRet, nodesDone, nodesQuery);
   }
 };
 
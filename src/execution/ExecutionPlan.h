@@ -235,9 +235,45 @@ public:
     return *this;
   }
 
-  Phase& sort(std::vector<size_t> sorts, bool desc) {
+  // order of every sort column, descending if true
+  Phase& sort(std::vector<size_t> sorts, std::vector<bool> descs) {
+    N_ENSURE_EQ(sorts.size(), descs.size(), "every sort column expects an order");
     sorts_ = std::move(sorts);
-    desc_ = desc;
+    descs_ = std::move(descs);
+    return *this;
+  }
+
+  // resolve column references of all expressions once the phase is built,
+  // a custom column shadows a column of the same name, otherwise it's bound to the ordinal in input schema.
+  // so that block computing reads every column by index rather than its name for each row.
+  Phase& bind() {
+    const auto binder = [this](nebula::surface::eval::ValueEval& ve) {
+      auto binding = ve.binding();
+      if (binding == nullptr) {
+        return;
+      }
+
+      for (const auto& c : customs_) {
+        if (c->signature() == binding->name) {
+          binding->custom = c.get();
+          return;
+        }
+      }
+
+      auto found = fieldMap_.find(binding->name);
+      if (found != fieldMap_.end()) {
+        binding->ordinal = found->second;
+      }
+    };
+
+    if (filter_) {
+      filter_->walk(binder);
+    }
+
+    for (auto& f : fields_) {
+      f->walk(binder);
+    }
+
     return *this;
   }
 
@@ -280,8 +316,8 @@ public:
     return sorts_;
   }
 
-  inline bool isDesc() const {
-    return desc_;
+  inline const std::vector<bool>& descs() const {
+    return descs_;
   }
 
   inline size_t top() const {
@@ -343,8 +379,7 @@ private:
 
   // sorting properties
   std::vector<size_t> sorts_;
-  // TODO(cao) - every sort column may have different order, single direction now
-  bool desc_;
+  std::vector<bool> descs_;
 
   // results limitation
   size_t limit_;
@@ -389,8 +424,8 @@ public:
     return static_cast<const BlockPhase&>(*upstream_).sorts();
   }
 
-  inline bool isDesc() const {
-    return static_cast<const BlockPhase&>(*upstream_).isDesc();
+  inline const std::vector<bool>& descs() const {
+    return static_cast<const BlockPhase&>(*upstream_).descs();
   }
 
   inline size_t top() const {
@@ -422,8 +457,8 @@ public:
     return static_cast<const NodePhase&>(*upstream_).sorts();
   }
 
-  inline bool isDesc() const {
-    return static_cast<const NodePhase&>(*upstream_).isDesc();
+  inline const std::vector<bool>& descs() const {
+    return static_cast<const NodePhase&>(*upstream_).descs();
   }
 
   inline bool hasAggregation() const {
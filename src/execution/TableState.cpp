@@ -16,6 +16,8 @@
 
 #include "TableState.h"
 
+#include <algorithm>
+
 #include "common/Wrap.h"
 
 namespace nebula {
@@ -58,24 +60,99 @@ bool TableState::add(std::shared_ptr<BatchBlock> block) {
   // collect metrics
   update(block, rows_, bytes_, window_, hists_);
   ++blocks_;
+  if (block->state().live) {
+    ++lives_;
+  }
 
   // add this block to the repo
   data_.emplace(spec, block);
+  std::atomic_store(&indices_, std::shared_ptr<const BlockIndices>{});
   return true;
 }
 
 size_t TableState::remove(const std::string& spec) {
+  return remove(nebula::common::unordered_set<std::string>{ spec });
+}
+
+size_t TableState::remove(const nebula::common::unordered_set<std::string>& specs) {
+  LOCK_DATA_ACCESS
+
+  size_t count = 0;
+  for (const auto& spec : specs) {
+    count += data_.erase(spec);
+    tailSpecs_.erase(spec);
+  }
+
+  rebuild();
+  return count;
+}
+
+size_t TableState::replace(std::shared_ptr<BatchBlock> block) {
   LOCK_DATA_ACCESS
 
+  const auto& spec = block->spec();
+  const auto& data = block->data();
+  const auto live = data != nullptr && !data->sealed();
+
+  // a new snapshot of a live block grows from the previous one of the same batch,
+  // metrics move forward by their difference and the index is not touched.
+  auto range = data_.equal_range(spec);
+  if (live && tailSpecs_.find(spec) != tailSpecs_.end()
+      && range.first != range.second && std::next(range.first) == range.second
+      && range.first->second->data() == data) {
+    const auto& prev = range.first->second->state();
+    const auto& state = block->state();
+    rows_ = rows_ + state.numRows - prev.numRows;
+    bytes_ = bytes_ + state.rawSize - prev.rawSize;
+    window_.first = std::min(block->start(), window_.first);
+    window_.second = std::max(block->end(), window_.second);
+    TableStateBase::merge(hists_, state.histograms);
+    TableStateBase::retract(hists_, prev.histograms);
+
+    range.first->second = block;
+    refreshTails();
+    return 1;
+  }
+
+  // blocks of the spec are swapped at once, queries see either old or new ones
   auto count = data_.erase(spec);
+  data_.emplace(spec, block);
+  if (live) {
+    tailSpecs_.emplace(spec);
+  } else {
+    tailSpecs_.erase(spec);
+  }
+
+  rebuild();
+  return count;
+}
+
+void TableState::refreshTails() {
+  auto tails = std::make_shared<std::vector<BlockPtr>>();
+  tails->reserve(tailSpecs_.size());
+  for (const auto& spec : tailSpecs_) {
+    auto range = data_.equal_range(spec);
+    for (auto it = range.first; it != range.second; ++it) {
+      tails->push_back(it->second);
+    }
+  }
+
+  std::atomic_store(&tails_, std::shared_ptr<const std::vector<BlockPtr>>{ std::move(tails) });
+}
+
+void TableState::rebuild() {
+  std::atomic_store(&indices_, std::shared_ptr<const BlockIndices>{});
+  refreshTails();
 
   // update the metrics
   size_t rows = 0;
   size_t bytes = 0;
   std::pair<int64_t, int64_t> window{ std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() };
+  size_t lives = 0;
   HistVector hists;
   for (auto& b : data_) {
     update(b.second, rows, bytes, window, hists);
+    lives += b.second->state().live;
   }
 
   // updated state data
@@ -84,22 +161,99 @@ size_t TableState::remove(const std::string& spec) {
   bytes_ = bytes;
   std::swap(window_, window);
   std::swap(hists_, hists);
-
-  return count;
+  lives_ = lives;
 }
 
-std::vector<BatchPtr> TableState::query(const Window& window, const std::string& version) const {
+std::shared_ptr<const BlockIndices> TableState::indices() const {
+  auto snapshot = std::atomic_load(&indices_);
+  if (N_LIKELY(snapshot != nullptr)) {
+    return snapshot;
+  }
+
   LOCK_DATA_ACCESS
 
-  std::vector<BatchPtr> batches;
-  vector_reserve(batches, data_.size(), "TableState::query");
+  // someone else may have built it while we're waiting
+  snapshot = std::atomic_load(&indices_);
+  if (snapshot != nullptr) {
+    return snapshot;
+  }
 
+  // live blocks are served from their own snapshot
+  auto indices = std::make_shared<BlockIndices>();
   for (auto& b : data_) {
-    if (b.second->overlap(window) && b.second->version() == version) {
-      batches.push_back(b.second->data());
+    if (tailSpecs_.find(b.first) == tailSpecs_.end()) {
+      (*indices)[b.second->version()].blocks.push_back(b.second);
+    }
+  }
+
+  for (auto& v : *indices) {
+    auto& index = v.second;
+    std::sort(index.blocks.begin(), index.blocks.end(), [](const BlockPtr& b1, const BlockPtr& b2) {
+      return b1->start() < b2->start();
+    });
+
+    vector_reserve(index.maxEnd, index.blocks.size(), "TableState::indices");
+    auto maxEnd = std::numeric_limits<int64_t>::min();
+    for (auto& b : index.blocks) {
+      maxEnd = std::max(maxEnd, b->end());
+      index.maxEnd.push_back(maxEnd);
+    }
+  }
+
+  snapshot = std::move(indices);
+  std::atomic_store(&indices_, snapshot);
+  return snapshot;
+}
+
+std::vector<BlockPtr> TableState::blocks(const Window& window, const std::string& version) const {
+  // queries read a snapshot without lock
+  const auto snapshot = indices();
+  std::vector<BlockPtr> result;
+  auto found = snapshot->find(version);
+  if (found != snapshot->end()) {
+    const auto& index = found->second;
+    const auto& blocks = index.blocks;
+
+    // blocks before lo end before the window, blocks since hi start after the window
+    auto lo = std::lower_bound(index.maxEnd.begin(), index.maxEnd.end(), window.first) - index.maxEnd.begin();
+    auto hi = std::upper_bound(blocks.begin(), blocks.end(), window.second, [](int64_t time, const BlockPtr& b) {
+                return time < b->start();
+              })
+              - blocks.begin();
+
+    if (lo < hi) {
+      vector_reserve(result, hi - lo, "TableState::blocks");
+    }
+
+    for (auto i = lo; i < hi; ++i) {
+      const auto& b = blocks.at(i);
+      if (b->end() >= window.first) {
+        result.push_back(b);
+      }
+    }
+  }
+
+  // a few live blocks are checked one by one
+  const auto tails = std::atomic_load(&tails_);
+  if (tails != nullptr) {
+    for (const auto& b : *tails) {
+      if (b->version() == version && b->overlap(window)) {
+        result.push_back(b);
+      }
     }
   }
 
+  return result;
+}
+
+std::vector<BatchPtr> TableState::query(const Window& window, const std::string& version) const {
+  const auto blocks = this->blocks(window, version);
+  std::vector<BatchPtr> batches;
+  vector_reserve(batches, blocks.size(), "TableState::query");
+  for (const auto& b : blocks) {
+    batches.push_back(b->data());
+  }
+
   return batches;
 }
 
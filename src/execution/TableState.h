@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 
@@ -89,9 +90,12 @@ public:
 
   inline static void merge(nebula::surface::eval::HistVector& target,
                            const nebula::surface::eval::HistVector& source) {
-    // merge histogram from state into hists
+    // merge histogram from state into hists, copy them as target is merged into later
     if (target.size() == 0) {
-      target = source;
+      target.reserve(source.size());
+      for (const auto& h : source) {
+        target.push_back(h->clone());
+      }
       return;
     }
 
@@ -102,6 +106,15 @@ public:
     }
   }
 
+  // take out histograms merged before, see Histogram::retract
+  inline static void retract(nebula::surface::eval::HistVector& target,
+                             const nebula::surface::eval::HistVector& source) {
+    N_ENSURE(target.size() >= source.size(), "expect histograms merged before");
+    for (size_t i = 0; i < source.size(); ++i) {
+      target.at(i)->retract(*source.at(i));
+    }
+  }
+
   inline void print() const noexcept {
     LOG(INFO) << "Table: " << table_
               << ", blocks: " << blocks_
@@ -129,6 +142,17 @@ protected:
 // a shortcut for pair set of {table name, spec id}
 using TableSpecSet = nebula::common::unordered_set<std::pair<std::string, std::string>>;
 
+// An immutable interval index of all blocks of one version.
+// Blocks are sorted by start time, and maxEnd[i] is the max end time of blocks [0, i],
+// so that blocks overlapping a window is a narrow range found by two binary searches.
+struct BlockIndex {
+  std::vector<std::shared_ptr<nebula::execution::io::BatchBlock>> blocks;
+  std::vector<int64_t> maxEnd;
+};
+
+// snapshot of interval indices of all versions
+using BlockIndices = nebula::common::unordered_map<std::string, BlockIndex>;
+
 // Table State with solid data in it
 class TableState : public TableStateBase {
 public:
@@ -167,16 +191,52 @@ public:
   // remove all blocks for given spec
   size_t remove(const std::string&);
 
+  // remove all blocks for given specs
+  size_t remove(const nebula::common::unordered_set<std::string>&);
+
+  // replace all blocks of the spec of given block by it, return number of blocks replaced.
+  // a block of an unsealed batch (live tail) is kept out of the index, a new snapshot of it
+  // moves metrics by the difference from previous one without touching other blocks.
+  size_t replace(std::shared_ptr<nebula::execution::io::BatchBlock>);
+
+  // get all blocks of given version overlapping given window
+  std::vector<std::shared_ptr<nebula::execution::io::BatchBlock>> blocks(const Window&, const std::string&) const;
+
   // get all data batch pointers by given window
   std::vector<nebula::memory::BatchPtr> query(const Window&, const std::string&) const;
 
   // iterate every single block to feed the given lambda
   void iterate(std::function<void(const nebula::execution::io::BatchBlock&)>) const;
 
+  // has any block of a batch still being built, whose metadata is behind its data
+  inline bool live() const {
+    return lives_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // get current index snapshot, build it if it's invalidated by add or remove
+  std::shared_ptr<const BlockIndices> indices() const;
+
+private:
+  // rebuild metrics and invalidate index after blocks removed or replaced, called with data lock held
+  void rebuild();
+
+  // refresh snapshot of live blocks, called with data lock held
+  void refreshTails();
+
 private:
   // spec signature -> multi blocks
   std::unordered_multimap<std::string, std::shared_ptr<nebula::execution::io::BatchBlock>> data_;
   mutable std::mutex mdata_;
+
+  // index snapshot read without lock, reset on every change and lazily rebuilt
+  mutable std::shared_ptr<const BlockIndices> indices_;
+
+  // specs of live blocks which are not indexed, and snapshot of their blocks read without lock
+  nebula::common::unordered_set<std::string> tailSpecs_;
+  std::shared_ptr<const std::vector<std::shared_ptr<nebula::execution::io::BatchBlock>>> tails_;
+
+  // number of live blocks
+  std::atomic<size_t> lives_{ 0 };
 };
 
 } // namespace execution
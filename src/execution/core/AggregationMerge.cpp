@@ -19,17 +19,19 @@
 #include <fmt/format.h>
 #include <gflags/gflags.h>
 
-#include "common/Fold.h"
+#include "common/Hash.h"
 #include "execution/serde/RowCursorSerde.h"
 #include "memory/keyed/FlatRowCursor.h"
 #include "memory/keyed/HashFlat.h"
 #include "surface/eval/UDF.h"
 
-DEFINE_uint64(MULTI_FOLD_WIDTH, 1,
-              "defines if we want fixed width for multi-fold passes."
-              "0: use pool size to calculate width = total / size"
+DEFINE_uint64(MERGE_PARTITIONS, 0,
+              "defines number of hash partitions to merge aggregation results in parallel."
+              "0: use pool size as number of partitions"
               "1: use current thread, not using pool"
-              "2+: use this width to do folding parallel");
+              "2+: use this number of partitions");
+DEFINE_uint64(MERGE_PARALLEL_ROWS, 100000,
+              "minimum number of total input rows to merge aggregation results in parallel");
 
 /**
  * A logic wrapper to merge aggregation results shared by aggregators (Node Executor or Server Executor)
@@ -39,17 +41,190 @@ namespace execution {
 namespace core {
 
 using nebula::common::CompositeCursor;
+using nebula::execution::QueryStats;
+using nebula::memory::keyed::FlatBuffer;
 using nebula::memory::keyed::FlatRowCursor;
 using nebula::memory::keyed::HashFlat;
 using nebula::surface::EmptyRowCursor;
 using nebula::surface::RowCursorPtr;
 using nebula::surface::RowData;
+using nebula::surface::eval::Fields;
 using nebula::surface::eval::ValueEval;
 using nebula::type::Kind;
 using nebula::type::Schema;
 
+// hash all key columns of a row, used to assign rows into partitions
+// equal keys always land in the same partition so partitions can be merged independently
+using KeyHasher = std::function<size_t(const RowData&)>;
+
+KeyHasher keyHasher(const Schema& schema, const Fields& fields) {
+  std::vector<KeyHasher> hashers;
+  for (size_t i = 0, size = fields.size(); i < size; ++i) {
+    if (fields.at(i)->isAggregate()) {
+      continue;
+    }
+
+#define TYPE_HASH(KIND, FUNC)                                     \
+  case Kind::KIND: {                                              \
+    hashers.push_back([i](const RowData& row) -> size_t {         \
+      if (row.isNull(i)) {                                        \
+        return 0;                                                 \
+      }                                                           \
+      auto value = row.FUNC(i);                                   \
+      return nebula::common::Hasher::hash64(&value, sizeof(value)); \
+    });                                                           \
+    break;                                                        \
+  }
+
+    switch (schema->childType(i)->k()) {
+      TYPE_HASH(BOOLEAN, readBool)
+      TYPE_HASH(TINYINT, readByte)
+      TYPE_HASH(SMALLINT, readShort)
+      TYPE_HASH(INTEGER, readInt)
+      TYPE_HASH(BIGINT, readLong)
+      TYPE_HASH(REAL, readFloat)
+      TYPE_HASH(DOUBLE, readDouble)
+      TYPE_HASH(INT128, readInt128)
+    case Kind::VARCHAR: {
+      hashers.push_back([i](const RowData& row) -> size_t {
+        if (row.isNull(i)) {
+          return 0;
+        }
+        auto value = row.readString(i);
+        return nebula::common::Hasher::hash64(value.data(), value.size());
+      });
+      break;
+    }
+    default:
+      // non-supported key type doesn't contribute to partitioning
+      break;
+    }
+
+#undef TYPE_HASH
+  }
+
+  return [hashers = std::move(hashers)](const RowData& row) {
+    size_t hash = 0;
+    for (const auto& hasher : hashers) {
+      hash = hash * 31 + hasher(row);
+    }
+
+    // mix it so that partition doesn't correlate with hash value used inside hash flat
+    return (hash * 0x9E3779B97F4A7C15ULL) >> 32;
+  };
+}
+
+// run task(i) for i in [0, size) on the pool and wait for all of them
+template <typename T>
+void parallel(folly::ThreadPoolExecutor& pool, size_t size, T&& task) {
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    auto p = std::make_shared<folly::Promise<folly::Unit>>();
+    pool.add([i, &task, p]() {
+      p->setWith([i, &task]() { task(i); });
+    });
+
+    futures.push_back(p->getFuture());
+  }
+
+  auto x = folly::collectAll(futures).get();
+  for (auto it = x.begin(); it < x.end(); ++it) {
+    N_ENSURE(it->hasValue(), "partition merge task failed");
+  }
+}
+
+// radix partitioned merge:
+// 1. every group of sources is aggregated into P hash flats by key hash
+// 2. every partition merges its hash flats from all groups independently
+// 3. all partitions are concatenated into one flat buffer, no key overlaps across partitions
+RowCursorPtr partitionMerge(
+  folly::ThreadPoolExecutor& pool,
+  const Schema schema,
+  const Fields& fields,
+  const std::vector<RowCursorPtr>& cursors,
+  const size_t partitions) {
+  const auto groups = std::min(partitions, cursors.size());
+  const auto hasher = keyHasher(schema, fields);
+
+  // flats[group][partition]
+  std::vector<std::vector<std::unique_ptr<HashFlat>>> flats(groups);
+  parallel(pool, groups, [&](size_t g) {
+    auto& local = flats.at(g);
+    local.reserve(partitions);
+    for (size_t p = 0; p < partitions; ++p) {
+      local.push_back(std::make_unique<HashFlat>(schema, fields));
+    }
+
+    for (size_t s = g, size = cursors.size(); s < size; s += groups) {
+      auto& cursor = cursors.at(s);
+      while (cursor->hasNext()) {
+        const auto& row = cursor->next();
+        local.at(hasher(row) % partitions)->update(row);
+      }
+    }
+  });
+
+  // merge all groups into the first group for each partition
+  if (groups > 1) {
+    parallel(pool, partitions, [&](size_t p) {
+      auto& to = flats.at(0).at(p);
+      for (size_t g = 1; g < groups; ++g) {
+        auto& from = flats.at(g).at(p);
+        if (from->binary()) {
+          for (size_t r = 0, rows = from->getRows(); r < rows; ++r) {
+            to->update(*from, r);
+          }
+          continue;
+        }
+
+        FlatRowCursor cursor(std::move(from));
+        while (cursor.hasNext()) {
+          to->update(cursor.next());
+        }
+      }
+    });
+  }
+
+  // concatenate partitions, sketches are carried over by the rows
+  auto result = std::make_unique<FlatBuffer>(schema, fields);
+  for (auto& flat : flats.at(0)) {
+    if (flat->binary()) {
+      for (size_t r = 0, rows = flat->getRows(); r < rows; ++r) {
+        result->add(*flat, r);
+      }
+      continue;
+    }
+
+    FlatRowCursor cursor(std::move(flat));
+    while (cursor.hasNext()) {
+      result->add(cursor.next());
+    }
+  }
+
+  return std::make_shared<FlatRowCursor>(std::move(result));
+}
+
+// fold a result into a hash flat
+void fold(HashFlat& hf, const RowCursorPtr& result) {
+  // results of other nodes or blocks backed by flat buffer are merged in binary
+  auto flat = std::dynamic_pointer_cast<FlatRowCursor>(result);
+  if (flat && flat->flat().binary()) {
+    const auto& fb = flat->flat();
+    for (size_t r = 0, rows = fb.getRows(); r < rows; ++r) {
+      hf.update(fb, r);
+    }
+    return;
+  }
+
+  while (result->hasNext()) {
+    const auto& row = result->next();
+    hf.update(row);
+  }
+}
+
 RowCursorPtr merge(
-  folly::ThreadPoolExecutor&,
+  folly::ThreadPoolExecutor& pool,
   const Schema schema,
   const std::vector<std::unique_ptr<ValueEval>>& fields,
   const bool hasAggregation,
@@ -62,9 +237,23 @@ RowCursorPtr merge(
   }
 
   if (hasAggregation) {
-    // if it is aggregation, we're sure the data cursor will be hash flat.
-    // So that we can do this multi-fold pass
-    // transform folly tries into HashFlat
+    std::vector<RowCursorPtr> cursors;
+    size_t rows = 0;
+    for (auto it = sources.begin(); it < sources.end(); ++it) {
+      if (it->hasValue() && it->value()) {
+        cursors.push_back(it->value());
+        rows += it->value()->size();
+      }
+    }
+
+    // large merge goes through partitioned merge on the pool
+    const auto partitions = FLAGS_MERGE_PARTITIONS == 0 ? pool.numThreads() : FLAGS_MERGE_PARTITIONS;
+    if (partitions > 1 && cursors.size() > 1 && rows >= FLAGS_MERGE_PARALLEL_ROWS) {
+      LOG(INFO) << fmt::format("Partitioned merge rows: {0} in partitions: {1}", rows, partitions);
+      return partitionMerge(pool, schema, fields, cursors, partitions);
+    }
+
+    // merge all rows into a single hash flat in current thread
     auto hf = std::make_unique<HashFlat>(schema, fields);
     for (auto it = sources.begin(); it < sources.end(); ++it) {
       // if the result is empty
@@ -72,56 +261,12 @@ RowCursorPtr merge(
         continue;
       }
 
-      auto blockResult = it->value();
-      while (blockResult->hasNext()) {
-        const auto& row = blockResult->next();
-        hf->update(row);
-      }
+      fold(*hf, it->value());
     }
 
     return std::make_shared<FlatRowCursor>(std::move(hf));
   }
 
-  // TODO(cao) - I'm seeing multi-fold problems and even worse performance
-  // Need more time to work on this, most likely caused by the manipulation on the pointers/casting/moving
-  //   // convert to flat buffer pointer, we do not need schema used for new instance
-  //   auto buffer = nebula::execution::serde::asBuffer(*it->value(), nullptr);
-  //   N_ENSURE_NOT_NULL(buffer, "invalid buffer in merge path");
-  //   // this buffer could be HashFlat if it is from local aggregation
-  //   // or plain flat buffer which is searialized through boundary
-  //   auto origin = buffer.release();
-  //   auto flat = dynamic_cast<HashFlat*>(origin);
-  //   if (flat) {
-  //     blocks.push_back(std::unique_ptr<HashFlat>{ flat });
-  //   } else {
-  //     blocks.push_back(std::make_unique<HashFlat>(origin, keys));
-  //   }
-  // }
-
-  // if (blocks.size() == 0) {
-  //   LOG(INFO) << "no valid block to merge.";
-  //   return EmptyRowCursor::instance();
-  // }
-
-  // fold blocks if there are more than one
-  // if (blocks.size() > 1) {
-  //   nebula::common::fold<std::unique_ptr<HashFlat>>(
-  //     pool, blocks, [&update](std::unique_ptr<HashFlat>& from, std::unique_ptr<HashFlat>& to) {
-  //       // do the in-place merge
-  //       // iterate the block result and partial aggregate it in hash flat
-  //       FlatRowCursor cursor(std::move(from));
-  //       auto i = 0;
-  //       while (cursor.hasNext()) {
-  //         const auto& row = cursor.next();
-  //         to->update(row, update);
-  //       }
-  //     },
-  //     FLAGS_MULTI_FOLD_WIDTH);
-  // }
-
-  // // after fold, all data aggregated at position 0
-  // return std::make_shared<FlatRowCursor>(std::move(blocks.at(0)));
-
   auto composite = std::make_shared<CompositeCursor<RowData>>();
   auto failures = 0;
   for (auto it = sources.begin(); it < sources.end(); ++it) {
@@ -144,6 +289,57 @@ RowCursorPtr merge(
   return composite;
 }
 
+ProgressiveMerge::ProgressiveMerge(const Schema schema, const Fields& fields, const bool hasAggregation)
+  : flat_{ hasAggregation ? std::make_unique<HashFlat>(schema, fields) : nullptr },
+    composite_{ hasAggregation ? nullptr : std::make_shared<CompositeCursor<RowData>>() },
+    count_{ 0 },
+    closed_{ false } {}
+
+bool ProgressiveMerge::add(RowCursorPtr result, const QueryStats& stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (closed_) {
+    return false;
+  }
+
+  ++count_;
+  stats_.blocksScan += stats.blocksScan;
+  stats_.rowsScan += stats.rowsScan;
+  if (!result) {
+    return true;
+  }
+
+  if (flat_) {
+    fold(*flat_, result);
+  } else {
+    composite_->combine(result);
+  }
+
+  return true;
+}
+
+void ProgressiveMerge::finish() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!closed_) {
+    stats_.nodesDone += 1;
+  }
+}
+
+RowCursorPtr ProgressiveMerge::close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  N_ENSURE(!closed_, "progressive merge closed already");
+  closed_ = true;
+  LOG(INFO) << fmt::format("Progressive merge closed with results: {0}, sources done: {1}", count_, stats_.nodesDone);
+  if (count_ == 0) {
+    return EmptyRowCursor::instance();
+  }
+
+  if (flat_) {
+    return std::make_shared<FlatRowCursor>(std::move(flat_));
+  }
+
+  return composite_;
+}
+
 } // namespace core
 } // namespace execution
 } // namespace nebula
\ No newline at end of file
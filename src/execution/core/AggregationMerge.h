@@ -16,7 +16,12 @@
 
 #pragma once
 
+#include <mutex>
+
+#include "common/Cursor.h"
 #include "common/Folly.h"
+#include "execution/Context.h"
+#include "memory/keyed/HashFlat.h"
 #include "surface/DataSurface.h"
 #include "surface/eval/ValueEval.h"
 #include "type/Type.h"
@@ -34,6 +39,38 @@ nebula::surface::RowCursorPtr merge(
   const nebula::surface::eval::Fields&,
   const bool,
   const std::vector<folly::Try<nebula::surface::RowCursorPtr>>&);
+
+// merge results one by one as they arrive (eg. partial results streamed from nodes),
+// aggregation results are folded into a single hash flat right away.
+// close() takes whatever merged so far and any result arriving later is discarded.
+class ProgressiveMerge {
+public:
+  ProgressiveMerge(const nebula::type::Schema, const nebula::surface::eval::Fields&, const bool);
+  virtual ~ProgressiveMerge() = default;
+
+  // merge a result with stats of the blocks it covers, return false if discarded as merge is closed
+  bool add(nebula::surface::RowCursorPtr, const nebula::execution::QueryStats&);
+
+  // a source (eg. a node) has no more results
+  void finish();
+
+  // close the merge and return merged result
+  nebula::surface::RowCursorPtr close();
+
+  // stats of all merged results, final once closed
+  inline const nebula::execution::QueryStats& stats() const {
+    return stats_;
+  }
+
+private:
+  std::unique_ptr<nebula::memory::keyed::HashFlat> flat_;
+  std::shared_ptr<nebula::common::CompositeCursor<nebula::surface::RowData>> composite_;
+  nebula::execution::QueryStats stats_;
+  size_t count_;
+  bool closed_;
+  std::mutex mutex_;
+};
+
 } // namespace core
 } // namespace execution
 } // namespace nebula
\ No newline at end of file
@@ -18,6 +18,7 @@
 
 #include <gflags/gflags.h>
 #include <gperftools/profiler.h>
+#include <numeric>
 
 #include "AggregationMerge.h"
 #include "common/Likely.h"
@@ -26,6 +27,10 @@
 
 DEFINE_bool(CPU_PROF, false, "Enable cpu profile");
 DEFINE_string(PROF_FILE, "/tmp/cpu_prof.out", "CPU profile output file");
+DEFINE_bool(VECTORIZE, true, "Enable vectorized filter on selection vectors");
+DEFINE_uint32(VECTOR_SIZE, 1024, "Number of rows in every selection vector");
+DEFINE_bool(ZONE_MAP_SCAN, true, "Skip or accept pages of a partial block through its zone maps");
+DEFINE_bool(DICT_CODE_KEYS, true, "Hash and compare string keys of dictionary encoded columns on codes");
 
 /**
  * Nebula runtime / online meta data.
@@ -35,12 +40,14 @@ namespace execution {
 namespace core {
 
 using nebula::memory::EvaledBlock;
+using nebula::memory::keyed::Coder;
 using nebula::memory::keyed::HashFlat;
 using nebula::surface::RowCursorPtr;
 using nebula::surface::SchemaRow;
 using nebula::surface::eval::BlockEval;
 using nebula::surface::eval::EvalContext;
 using nebula::surface::eval::ScriptData;
+using nebula::surface::eval::Selection;
 using nebula::type::Kind;
 using nebula::type::Schema;
 
@@ -64,7 +71,8 @@ void BlockExecutor::compute() {
   }
 
   // process every single row and put result in HashFlat
-  auto accessor = data_.first->makeAccessor();
+  // columns are read by ordinals of plan input schema which expressions are bound to
+  auto accessor = data_.first->makeAccessor(plan_.inputSchema());
   const auto& fields = plan_.fields();
   const auto& filter = plan_.filter();
 
@@ -81,6 +89,29 @@ void BlockExecutor::compute() {
   ComputedRow cr(fieldMap, plan_.fields(), ctx);
   result_ = std::make_unique<HashFlat>(plan_.outputSchema(), fields);
 
+  // string keys selected from dictionary encoded columns group rows by their codes
+  if (FLAGS_DICT_CODE_KEYS) {
+    std::vector<Coder> coders;
+    coders.reserve(fields.size());
+    bool coded = false;
+    for (const auto& f : fields) {
+      if (!f->isAggregate()
+          && f->expressionType() == nebula::surface::eval::ExpressionType::COLUMN
+          && f->outputType() == Kind::VARCHAR) {
+        // column expr signature is composed by "F:{col}"
+        coders.push_back(data_.first->coder(std::string(f->signature().substr(2))));
+        coded = coded || coders.back() != nullptr;
+        continue;
+      }
+
+      coders.emplace_back();
+    }
+
+    if (coded) {
+      result_->encode(std::move(coders));
+    }
+  }
+
   // we want to evaluate here for the whole block before we go to iterations of computing
   // by leveraging its metadata including histogram, bloom filter, dictionary etc.
   // the result we would like to see is:
@@ -92,22 +123,81 @@ void BlockExecutor::compute() {
   // and these methods will be used in each individual ValueEval and give result like above.
   // So we need an special operator to be implemented to have this function
   const auto blockRows = data_.first->getRows();
-  for (size_t i = 0; i < blockRows; ++i) {
-    ctx->reset(accessor->seek(i));
-
-    // if not fullfil the condition
-    // ignore valid here - if system can't determine how to act on NULL value
-    // we don't know how to make decision here too
-    if (N_LIKELY(!scanAll)) {
-      if (!filter.eval<bool>(*ctx).value_or(false)) {
+
+  // scan rows in [begin, end), all indicates every row in the range matches the filter
+  const auto& kernel = filter.kernel();
+  const auto scan = [&](size_t begin, size_t end, bool all) {
+    // vectorized mode: filter a batch of rows through column kernels on a selection vector
+    // and only compute selected rows. row evaluation is still needed if the kernel is not exact.
+    if (!all && kernel && FLAGS_VECTORIZE) {
+      const size_t batchRows = std::max<size_t>(FLAGS_VECTOR_SIZE, 1);
+      Selection selection;
+      selection.reserve(batchRows);
+      for (size_t start = begin; start < end; start += batchRows) {
+        const auto stop = std::min(start + batchRows, end);
+        selection.resize(stop - start);
+        std::iota(selection.begin(), selection.end(), (uint32_t)start);
+
+        const auto exact = kernel(*data_.first, selection);
+        for (auto i : selection) {
+          ctx->reset(accessor->seek(i));
+          if (!exact && !filter.eval<bool>(*ctx).value_or(false)) {
+            continue;
+          }
+
+          result_->update(cr, i);
+        }
+      }
+
+      return;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      ctx->reset(accessor->seek(i));
+
+      // if not fullfil the condition
+      // ignore valid here - if system can't determine how to act on NULL value
+      // we don't know how to make decision here too
+      if (N_LIKELY(!all)) {
+        if (!filter.eval<bool>(*ctx).value_or(false)) {
+          continue;
+        }
+      }
+
+      // flat compute every new value of each field and set to corresponding column in flat
+      result_->update(cr, i);
+    }
+  };
+
+  // a partial block is evaluated page by page through its zone maps,
+  // pages evaluated as NONE are skipped and pages evaluated as ALL are not filtered.
+  const auto pages = data_.first->numPages();
+  if (!scanAll && pages > 1 && FLAGS_ZONE_MAP_SCAN) {
+    const auto pageRows = data_.first->pageRows();
+    size_t skipped = 0;
+    for (size_t p = 0; p < pages; ++p) {
+      auto eval = filter.eval(nebula::memory::PageBlock(*data_.first, p));
+      if (eval == BlockEval::NONE) {
+        ++skipped;
         continue;
       }
+
+      // nulls never match so a page with nulls can't be accepted as a whole
+      const auto begin = p * pageRows;
+      scan(begin, std::min(begin + pageRows, blockRows), eval == BlockEval::ALL && data_.first->dense(p));
     }
 
-    // flat compute every new value of each field and set to corresponding column in flat
-    result_->update(cr);
+    VLOG(1) << "block executor: plan=" << planId_ << ", skipped pages=" << skipped << "/" << pages;
+  } else {
+    scan(0, blockRows, scanAll);
   }
 
+  // keys are hashed on values again for merging with other blocks
+  result_->decode();
+
+  // result is copied out of the block, release it for its writer if it's live
+  pin_.unlock();
+
   // after the compute flat should contain all the data we need.
   index_ = 0;
   size_ = result_->getRows();
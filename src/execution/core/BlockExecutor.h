@@ -45,7 +45,8 @@ public:
     : nebula::surface::RowCursor(0),
       planId_{ planId },
       data_{ data },
-      plan_{ plan } {
+      plan_{ plan },
+      pin_{ data.first->pin() } {
     // compute will finish the compute and fill the data state in
     this->compute();
   }
@@ -59,6 +60,10 @@ public:
     return result_->crow(index);
   }
 
+  inline const nebula::memory::keyed::FlatBuffer& flat() const {
+    return *result_;
+  }
+
   inline std::unique_ptr<nebula::memory::keyed::FlatBuffer> takeResult() {
     auto temp = std::move(result_);
     result_ = nullptr;
@@ -72,6 +77,8 @@ private:
   const std::string& planId_;
   const nebula::memory::EvaledBlock& data_;
   const nebula::execution::BlockPhase& plan_;
+  // block may be a live batch still being built
+  std::shared_lock<std::shared_mutex> pin_;
   std::unique_ptr<nebula::memory::keyed::HashFlat> result_;
 };
 
@@ -84,7 +91,8 @@ public:
     : nebula::surface::RowCursor(0),
       planId_{ planId },
       data_{ data },
-      plan_{ plan } {
+      plan_{ plan },
+      pin_{ data.first->pin() } {
     // compute will finish the compute and fill the data state in
     this->compute();
   }
@@ -106,6 +114,8 @@ private:
   const std::string& planId_;
   const nebula::memory::EvaledBlock& data_;
   const nebula::execution::BlockPhase& plan_;
+  // samples read rows of the block lazily, keep it pinned while they're served
+  std::shared_lock<std::shared_mutex> pin_;
   std::unique_ptr<ReferenceRows> samples_;
 };
 
@@ -40,6 +40,20 @@ folly::Future<RowCursorPtr> NodeClient::execute(const PlanPtr plan) {
   return p->getFuture();
 }
 
+folly::Future<folly::Unit> NodeClient::stream(const PlanPtr plan, Partial sink) {
+  auto p = std::make_shared<folly::Promise<folly::Unit>>();
+
+  pool_.add([plan, &pool = pool_, p, sink = std::move(sink)]() {
+    NodeExecutor nodeExec(BlockManager::init(), true);
+    p->setWith([&]() {
+      // an incomplete stream fails the node so that it's not counted as done
+      N_ENSURE(nodeExec.stream(pool, plan, sink), "incomplete results: blocks failed or timed out");
+    });
+  });
+
+  return p->getFuture();
+}
+
 } // namespace core
 } // namespace execution
 } // namespace nebula
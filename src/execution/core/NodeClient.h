@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <glog/logging.h>
 #include "common/Folly.h"
 #include "common/Task.h"
@@ -30,6 +31,10 @@ namespace nebula {
 namespace execution {
 namespace core {
 
+// receive a partial result of a node with stats of the blocks it covers,
+// return false to stop receiving more.
+using Partial = std::function<bool(nebula::surface::RowCursorPtr, const QueryStats&)>;
+
 class NodeClient {
 public:
   NodeClient(const nebula::meta::NNode& node, folly::ThreadPoolExecutor& pool)
@@ -38,6 +43,10 @@ public:
 
   virtual folly::Future<nebula::surface::RowCursorPtr> execute(const PlanPtr plan);
 
+  // execute a plan and push partial results to the sink as groups of blocks finish,
+  // the future completes when the node has no more results.
+  virtual folly::Future<folly::Unit> stream(const PlanPtr plan, Partial sink);
+
   // state is used to pull state of a node - do nothing for inproc node client
   virtual void update() {}
 
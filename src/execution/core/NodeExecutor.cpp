@@ -16,7 +16,9 @@
 
 #include "NodeExecutor.h"
 
+#include <condition_variable>
 #include <gflags/gflags.h>
+#include <mutex>
 
 #include "AggregationMerge.h"
 #include "BlockExecutor.h"
@@ -37,6 +39,10 @@ DEFINE_uint64(NODE_TIMEOUT,
 
 DEFINE_bool(SINGLE_BLOCK, false, "some preventive use case only need to query a single block.");
 
+DEFINE_uint64(STREAM_BLOCKS,
+              8,
+              "number of finished blocks merged into one partial result when streaming query results to server");
+
 /**
  * Nebula runtime / online meta data.
  */
@@ -101,16 +107,14 @@ RowCursorPtr NodeExecutor::execute(folly::ThreadPoolExecutor& pool, const PlanPt
   // compile the results into a single row cursor
   auto x = folly::collectAll(results).get(NODE_TIMEOUT);
 
-  // single response optimization
-  if (x.size() == 1) {
-    return x.at(0).value();
-  }
-
   // depends on the query plan, if there is no aggregation
   // the results set from different block exeuction can be simply composite together
   // but the query needs to aggregate on keys, then we have to merge the results based on partial aggregatin plan
+  // single response optimization skips the merge, but it's still cut by top sort
   const NodePhase& phase = plan->fetch<PhaseType::PARTIAL>();
-  auto merged = merge(pool, phase.outputSchema(), phase.fields(), phase.hasAggregation(), x);
+  auto merged = x.size() == 1
+                  ? x.at(0).value()
+                  : merge(pool, phase.outputSchema(), phase.fields(), phase.hasAggregation(), x);
 
   // if scale is 0 or this query has no limit on it
   if (local_ || FLAGS_TOP_SORT_SCALE == 0 || phase.top() == 0) {
@@ -120,6 +124,110 @@ RowCursorPtr NodeExecutor::execute(folly::ThreadPoolExecutor& pool, const PlanPt
   return topSort<>(merged, phase, FLAGS_TOP_SORT_SCALE);
 }
 
+bool NodeExecutor::stream(
+  folly::ThreadPoolExecutor& pool,
+  const PlanPtr plan,
+  std::function<bool(RowCursorPtr, const QueryStats&)> sink) {
+  const BlockPhase& blockPhase = plan->fetch<PhaseType::COMPUTE>();
+  auto ts = TableService::singleton();
+
+  // block results are queued as they finish, the state is shared with block tasks
+  // since they may outlive this call when the node times out.
+  struct Pending {
+    explicit Pending(FilteredBlocks b) : blocks{ std::move(b) } {}
+    FilteredBlocks blocks;
+    std::vector<std::pair<RowCursorPtr, size_t>> ready;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  auto pending = std::make_shared<Pending>(
+    blockManager_->query(*ts->query(blockPhase.table()).table(), plan, pool));
+  auto& blocks = pending->blocks;
+  const auto planId = plan->id();
+  LOG(INFO) << "plan=" << planId << ", streaming total blocks: " << blocks.size();
+  if (FLAGS_SINGLE_BLOCK && blocks.size() > 1) {
+    LOG(ERROR) << "Expected single block but found multiple blocks.";
+    blocks.erase(blocks.begin(), blocks.end() - 1);
+  }
+
+  const auto total = blocks.size();
+  for (size_t i = 0; i < total; ++i) {
+    pool.addWithPriority(
+      [pending, i, plan, &blockPhase, planId]() {
+        const auto& block = pending->blocks.at(i);
+        RowCursorPtr result = nullptr;
+        try {
+          result = nebula::execution::core::compute(planId, block, blockPhase);
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "plan=" << planId << ", block failed: " << e.what();
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(pending->mutex);
+          pending->ready.emplace_back(result, block.first->getRows());
+        }
+        pending->cv.notify_one();
+      },
+      folly::Executor::HI_PRI);
+  }
+
+  // merge and push every group of finished blocks
+  const NodePhase& phase = plan->fetch<PhaseType::PARTIAL>();
+  const size_t group = std::max<size_t>(FLAGS_STREAM_BLOCKS, 1);
+  const auto deadline = std::chrono::steady_clock::now() + NODE_TIMEOUT;
+  size_t received = 0;
+  size_t failed = 0;
+  while (received < total) {
+    std::vector<std::pair<RowCursorPtr, size_t>> ready;
+    {
+      std::unique_lock<std::mutex> lock(pending->mutex);
+      const auto expected = std::min(group, total - received);
+      pending->cv.wait_until(lock, deadline, [&pending, expected]() {
+        return pending->ready.size() >= expected;
+      });
+      std::swap(ready, pending->ready);
+    }
+
+    // timed out with nothing finished
+    if (ready.empty()) {
+      LOG(WARNING) << "plan=" << planId << ", streaming timeout with blocks done: " << received << "/" << total;
+      break;
+    }
+
+    received += ready.size();
+    QueryStats stats;
+    std::vector<folly::Try<RowCursorPtr>> results;
+    vector_reserve(results, ready.size(), "NodeExecutor::stream");
+    for (auto& r : ready) {
+      stats.blocksScan += 1;
+      stats.rowsScan += r.second;
+      if (r.first) {
+        results.emplace_back(std::move(r.first));
+      } else {
+        ++failed;
+      }
+    }
+
+    auto merged = results.size() == 1
+                    ? results.at(0).value()
+                    : merge(pool, phase.outputSchema(), phase.fields(), phase.hasAggregation(), results);
+
+    // every chunk is cut by top sort as a unary result is
+    if (!local_ && FLAGS_TOP_SORT_SCALE > 0 && phase.top() > 0) {
+      merged = topSort<>(merged, phase, FLAGS_TOP_SORT_SCALE);
+    }
+
+    stats.rowsRet = merged->size();
+    if (!sink(merged, stats)) {
+      LOG(INFO) << "plan=" << planId << ", streaming stopped with blocks done: " << received << "/" << total;
+      break;
+    }
+  }
+
+  return received == total && failed == 0;
+}
+
 } // namespace core
 } // namespace execution
 } // namespace nebula
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <glog/logging.h>
 #include <thread>
 
@@ -40,6 +41,14 @@ public:
 public:
   nebula::surface::RowCursorPtr execute(folly::ThreadPoolExecutor&, const PlanPtr);
 
+  // execute the plan and push merged result of every group of finished blocks to the sink
+  // along with stats of the blocks in the group, return after all groups are pushed
+  // or the sink returns false to stop receiving more.
+  // return false if the results pushed are incomplete, eg. some blocks failed or timed out.
+  bool stream(folly::ThreadPoolExecutor&,
+              const PlanPtr,
+              std::function<bool(nebula::surface::RowCursorPtr, const QueryStats&)>);
+
 private:
   const std::shared_ptr<BlockManager> blockManager_;
 
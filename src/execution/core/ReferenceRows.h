@@ -43,7 +43,7 @@ public:
       fieldMap_{ nebula::surface::SchemaRow::name2index(plan_.outputSchema()) },
       scriptData_{ makeScriptData(plan) },
       data_{ data },
-      accessor_{ data.makeAccessor() },
+      accessor_{ data.makeAccessor(plan.inputSchema()) },
       ctx_{ std::make_shared<nebula::surface::eval::EvalContext>(plan.cacheEval(), scriptData_) },
       filter_{ plan.filter() },
       runtime_{ fieldMap_, plan_.fields(), ctx_ } {
@@ -68,7 +68,8 @@ public:
     // map external row to internal row due to filter
     auto row = rows_.at(index);
 
-    auto a = data_.makeAccessor();
+    // a copy of the cursor accessor shares its columns resolved already
+    auto a = std::make_unique<nebula::memory::RowAccessor>(*accessor_);
     a->seek(row);
 
     // a computed row with a wrapped row only
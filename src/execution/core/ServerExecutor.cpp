@@ -15,11 +15,16 @@
  */
 
 #include "ServerExecutor.h"
+
+#include <atomic>
+
 #include "AggregationMerge.h"
 #include "Finalize.h"
 #include "NodeConnector.h"
 #include "TopSort.h"
 #include "common/Folly.h"
+#include "common/Wrap.h"
+#include "execution/meta/TableService.h"
 #include "surface/eval/UDF.h"
 
 // maximum timeout in ms a query can best do
@@ -27,6 +32,12 @@ DEFINE_uint64(RPC_TIMEOUT,
               35000,
               "maximum time nebula can torelate for each query in miliseconds");
 DEFINE_bool(SINGLE_NODE, false, "some use case only need to run on single node");
+DEFINE_bool(NODE_PRUNING, true, "skip nodes having no blocks to pass query filter by synced block metadata");
+DEFINE_bool(STREAM_QUERY, true, "nodes stream back partial results which are merged by server as they arrive");
+DEFINE_uint64(PARTIAL_RESULT_MS,
+              0,
+              "return approximate result merged so far if not all nodes finish in given miliseconds, "
+              "0 to wait for all nodes until RPC_TIMEOUT, only works with STREAM_QUERY");
 
 /**
  * Nebula runtime / online meta data.
@@ -35,6 +46,8 @@ namespace nebula {
 namespace execution {
 namespace core {
 
+using nebula::common::vector_reserve;
+using nebula::execution::meta::TableService;
 using nebula::meta::NNode;
 using nebula::surface::EmptyRowCursor;
 using nebula::surface::RowCursorPtr;
@@ -55,9 +68,31 @@ RowCursorPtr ServerExecutor::execute(
     nodes.erase(nodes.begin(), nodes.end() - 1);
   }
 
+  // nodes whose blocks are all out of the filter produce nothing
+  if (FLAGS_NODE_PRUNING && nodes.size() > 0) {
+    auto table = TableService::singleton()->query(plan->fetch<PhaseType::COMPUTE>().table()).table();
+    const auto total = nodes.size();
+    nodes = BlockManager::init()->prune(*table, plan, nodes);
+    VLOG(1) << "Nodes to execute query " << plan->id() << ": " << nodes.size() << " / " << total;
+    if (nodes.empty()) {
+      return EmptyRowCursor::instance();
+    }
+  }
+
+  auto& stats = plan->ctx().stats();
+  stats.nodesQuery = nodes.size();
+  if (FLAGS_STREAM_QUERY) {
+    return stream(plan, connector, pool, nodes);
+  }
+
+  auto done = std::make_shared<std::atomic<size_t>>(0);
   for (const NNode& node : nodes) {
     auto c = connector->makeClient(node, pool);
     auto f = c->execute(plan)
+               .thenValue([done](RowCursorPtr result) {
+                 done->fetch_add(1);
+                 return result;
+               })
                // set time out handling
                .onTimeout(RPC_TIMEOUT, [&]() -> RowCursorPtr { 
                  LOG(WARNING) << "RPC Timeout: " << FLAGS_RPC_TIMEOUT;
@@ -72,6 +107,7 @@ RowCursorPtr ServerExecutor::execute(
 
   // collect all returns and turn it into a future
   auto x = folly::collectAll(results).get();
+  stats.nodesDone = done->load();
 
   // only one result - don't need any aggregation or composite
   const auto& phase = plan->fetch<PhaseType::GLOBAL>();
@@ -95,13 +131,65 @@ RowCursorPtr ServerExecutor::execute(
   }
 
   // update result size to stats
-  auto& stats = plan->ctx().stats();
   stats.rowsRet = resultSize;
 
   // apply sorting and limit if available
   return topSort(finalize(result, fieldMap, phase), phase);
 }
 
+RowCursorPtr ServerExecutor::stream(
+  const PlanPtr plan,
+  const std::shared_ptr<NodeConnector> connector,
+  folly::ThreadPoolExecutor& pool,
+  const std::vector<NNode>& nodes) {
+  // merge state is shared with node clients which may outlive this call when we return early
+  const auto& phase = plan->fetch<PhaseType::GLOBAL>();
+  auto progress = std::make_shared<ProgressiveMerge>(phase.inputSchema(), phase.fields(), phase.hasAggregation());
+
+  std::vector<folly::Future<folly::Unit>> results;
+  vector_reserve(results, nodes.size(), "ServerExecutor::stream");
+  for (const NNode& node : nodes) {
+    auto c = connector->makeClient(node, pool);
+    // plan is held by the sink as merge references fields of its phase
+    auto f = c->stream(plan, [progress, plan](RowCursorPtr result, const QueryStats& stats) {
+                 return progress->add(result, stats);
+               })
+               .thenValue([progress](folly::Unit) { progress->finish(); })
+               // a failed or incomplete node is not done, so the approximate result is never cached
+               .thenError(folly::tag_t<std::exception>{}, [](const std::exception& e) {
+                 LOG(WARNING) << "RPC Error: " << e.what();
+               });
+
+    results.push_back(std::move(f));
+  }
+
+  // wait for all nodes, or give up on slow ones to return approximate result early
+  const auto waitMs = FLAGS_PARTIAL_RESULT_MS > 0
+                        ? std::min(FLAGS_PARTIAL_RESULT_MS, FLAGS_RPC_TIMEOUT)
+                        : FLAGS_RPC_TIMEOUT;
+  try {
+    folly::collectAll(results).get(std::chrono::milliseconds(waitMs));
+  } catch (const folly::FutureTimeout&) {
+    LOG(WARNING) << "Nodes not finished in time: " << waitMs << "ms, returning partial result.";
+  }
+
+  auto result = progress->close();
+  const auto& merged = progress->stats();
+  auto& stats = plan->ctx().stats();
+  stats.blocksScan += merged.blocksScan;
+  stats.rowsScan += merged.rowsScan;
+  stats.nodesDone = merged.nodesDone;
+
+  // result holds the final total rows in the query before applying limit
+  auto resultSize = result->size();
+  if (resultSize == 0) {
+    return result;
+  }
+
+  stats.rowsRet = resultSize;
+  return topSort(finalize(result, phase.fieldMap(), phase), phase);
+}
+
 } // namespace core
 } // namespace execution
 } // namespace nebula
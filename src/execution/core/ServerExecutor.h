@@ -46,6 +46,14 @@ public:
                                         const PlanPtr,
                                         const std::shared_ptr<NodeConnector> = inproc());
 
+private:
+  // fan out the plan to nodes streaming back partial results and merge them as they arrive,
+  // return what is merged once all nodes finish or the wait times out.
+  nebula::surface::RowCursorPtr stream(const PlanPtr,
+                                       const std::shared_ptr<NodeConnector>,
+                                       folly::ThreadPoolExecutor&,
+                                       const std::vector<nebula::meta::NNode>&);
+
 private:
   const std::string server_;
 };
@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "execution/ExecutionPlan.h"
 #include "surface/DataSurface.h"
 #include "surface/TopRows.h"
+#include "surface/eval/Aggregator.h"
 
 /**
  * A logic wrapper to return top sort cursors when sorting and limiting are present
@@ -27,12 +30,39 @@ namespace nebula {
 namespace execution {
 namespace core {
 
+// value type of a sort key, strings are copied since source rows are not kept alive
+template <nebula::type::Kind K>
+using SortValue = std::conditional_t<K == nebula::type::Kind::VARCHAR,
+                                     std::string,
+                                     typename nebula::type::TypeTraits<K>::CppType>;
+
+using KeyFiller = std::function<void(const nebula::surface::RowData&)>;
+
+// sort key of an aggregate column in partial results is ordered by its finalized value
+template <nebula::type::Kind O, nebula::type::Kind I>
+KeyFiller aggregateKey(nebula::surface::SortKeys& keys, size_t rows, size_t index, bool desc) {
+  using T = SortValue<O>;
+  auto key = std::make_unique<nebula::surface::TypedSortKey<T>>(rows, desc);
+  auto k = key.get();
+  keys.push_back(std::move(key));
+  return [k, index](const nebula::surface::RowData& row) {
+    auto sketch = row.getAggregator(index);
+    if (sketch == nullptr) {
+      k->add(true, T{});
+      return;
+    }
+
+    k->add(false, T(std::static_pointer_cast<nebula::surface::eval::Aggregator<O, I>>(sketch)->finalize()));
+  };
+}
+
 // SCALE is used to enlarge the final set in result, by default return whatever asked
 template <nebula::execution::PhaseType PT>
 nebula::surface::RowCursorPtr topSort(
   nebula::surface::RowCursorPtr input,
   const nebula::execution::Phase<PT>& phase,
   size_t scale = 1) {
+  using nebula::type::Kind;
   // short circuit
   if (input->size() == 0) {
     return input;
@@ -41,53 +71,95 @@ nebula::surface::RowCursorPtr topSort(
   // do the aggregation from all different nodes
   // sort and top of results
   auto schema = phase.outputSchema();
-  std::function<bool(const std::unique_ptr<nebula::surface::RowData>& left,
-                     const std::unique_ptr<nebula::surface::RowData>& right)>
-    less = nullptr;
   const auto& sorts = phase.sorts();
+  const auto& descs = phase.descs();
+  const auto rows = input->size();
+  nebula::surface::SortKeys keys;
+  std::vector<KeyFiller> fillers;
   LOG(INFO) << "Sort the single query result and return: " << sorts.size();
-  if (sorts.size() > 0) {
-    N_ENSURE(sorts.size() == 1, "support single sorting column for now");
-    const auto& col = schema->childType(sorts[0]);
-    const auto kind = col->k();
-    const auto& name = col->name();
+  for (size_t i = 0; i < sorts.size(); ++i) {
+    const auto index = sorts.at(i);
+    const auto desc = descs.at(i);
+    const auto kind = schema->childType(index)->k();
+    KeyFiller filler = nullptr;
+
+    // partial results carry sketches for aggregate columns
+    if constexpr (PT == nebula::execution::PhaseType::PARTIAL) {
+      const auto& field = phase.fields().at(index);
+      if (field->isAggregate()) {
+        const auto ot = field->outputType();
+        const auto it = field->inputType();
+#define LOGIC_BY_IO(O, I)                                             \
+  case Kind::I: {                                                     \
+    filler = aggregateKey<Kind::O, Kind::I>(keys, rows, index, desc); \
+    break;                                                            \
+  }
+
+        ITERATE_BY_IO(ot, it)
+
+#undef LOGIC_BY_IO
+
+        if (filler) {
+          fillers.push_back(std::move(filler));
+        }
+        continue;
+      }
+    }
 
 // instead of assert, we torelate column not found for sorting
-#define LESS_KIND_CASE(K, F, OP)                                             \
-  case nebula::type::Kind::K: {                                              \
-    less = [&name](const std::unique_ptr<nebula::surface::RowData>& left,    \
-                   const std::unique_ptr<nebula::surface::RowData>& right) { \
-      return left->F(name) OP right->F(name);                                \
-    };                                                                       \
-    break;                                                                   \
+#define KEY_KIND_CASE(K, F)                                                    \
+  case Kind::K: {                                                              \
+    using T = SortValue<Kind::K>;                                              \
+    auto key = std::make_unique<nebula::surface::TypedSortKey<T>>(rows, desc); \
+    filler = [k = key.get(), index](const nebula::surface::RowData& row) {     \
+      auto isNull = row.isNull(index);                                         \
+      k->add(isNull, isNull ? T{} : T(row.F(index)));                          \
+    };                                                                         \
+    keys.push_back(std::move(key));                                            \
+    break;                                                                     \
   }
-#define LESS_SWITCH_DESC(OP)                \
-  switch (kind) {                           \
-    LESS_KIND_CASE(BOOLEAN, readBool, OP)   \
-    LESS_KIND_CASE(TINYINT, readByte, OP)   \
-    LESS_KIND_CASE(SMALLINT, readShort, OP) \
-    LESS_KIND_CASE(INTEGER, readInt, OP)    \
-    LESS_KIND_CASE(BIGINT, readLong, OP)    \
-    LESS_KIND_CASE(REAL, readFloat, OP)     \
-    LESS_KIND_CASE(DOUBLE, readDouble, OP)  \
-    LESS_KIND_CASE(VARCHAR, readString, OP) \
-  default:                                  \
-    less = nullptr;                         \
+
+    switch (kind) {
+      KEY_KIND_CASE(BOOLEAN, readBool)
+      KEY_KIND_CASE(TINYINT, readByte)
+      KEY_KIND_CASE(SMALLINT, readShort)
+      KEY_KIND_CASE(INTEGER, readInt)
+      KEY_KIND_CASE(BIGINT, readLong)
+      KEY_KIND_CASE(REAL, readFloat)
+      KEY_KIND_CASE(DOUBLE, readDouble)
+      KEY_KIND_CASE(INT128, readInt128)
+      KEY_KIND_CASE(VARCHAR, readString)
+    default:
+      LOG(WARNING) << "Skip sorting on unsupported column: " << index;
+    }
+
+#undef KEY_KIND_CASE
+
+    if (filler) {
+      fillers.push_back(std::move(filler));
+    }
   }
 
-    if (phase.isDesc()) {
-      LESS_SWITCH_DESC(<)
-    } else {
-      LESS_SWITCH_DESC(>)
+  // cutting partial results without a full order may drop groups of final top rows
+  if constexpr (PT == nebula::execution::PhaseType::PARTIAL) {
+    if (keys.size() < sorts.size()) {
+      return input;
     }
+  }
 
-#undef LESS_SWITCH_DESC
-#undef LESS_KIND_CASE
+  // extract values of all keys in one pass, rows are picked from source by index later
+  if (!keys.empty()) {
+    while (input->hasNext()) {
+      const auto& row = input->next();
+      for (const auto& filler : fillers) {
+        filler(row);
+      }
+    }
   }
 
-  return std::make_shared<nebula::surface::TopRows>(input, phase.top() * scale, std::move(less));
+  return std::make_shared<nebula::surface::TopRows>(input, phase.top() * scale, std::move(keys));
 }
 
 } // namespace core
 } // namespace execution
-} // namespace nebula
\ No newline at end of file
+} // namespace nebula
@@ -62,6 +62,18 @@ std::shared_ptr<BatchBlock> BlockLoader::from(const BlockSignature& sign, std::s
   return std::make_shared<BatchBlock>(sign, b, BlockState{ b->getRows(), b->getMemory(), hist(*b) });
 }
 
+std::shared_ptr<BatchBlock> BlockLoader::snapshot(const BlockSignature& sign, std::shared_ptr<Batch> b) {
+  N_ENSURE_NOT_NULL(b, "requires a solid batch");
+
+  // histograms of the batch keep changing, make a copy
+  auto hists = hist(*b);
+  for (auto& h : hists) {
+    h = h->clone();
+  }
+
+  return std::make_shared<BatchBlock>(sign, b, BlockState{ b->getRows(), b->getMemory(), std::move(hists), !b->sealed() });
+}
+
 BlockList BlockLoader::load(const BlockSignature& block) {
   const auto& testName = test_.name();
   if (nebula::common::Chars::prefix(
@@ -39,6 +39,9 @@ class BlockLoader {
 public:
   static std::shared_ptr<BatchBlock> from(const nebula::meta::BlockSignature&, std::shared_ptr<nebula::memory::Batch>);
 
+  // a block of a batch still being built by the caller, its state is a copy taken at the moment
+  static std::shared_ptr<BatchBlock> snapshot(const nebula::meta::BlockSignature&, std::shared_ptr<nebula::memory::Batch>);
+
 public:
   BlockList load(const nebula::meta::BlockSignature&);
 
@@ -20,6 +20,7 @@
 
 #include "execution/core/BlockExecutor.h"
 #include "memory/keyed/FlatRowCursor.h"
+#include "surface/TopRows.h"
 #include "type/Serde.h"
 
 /**
@@ -92,20 +93,39 @@ FlatBufferPtr asBuffer(nebula::surface::RowCursor& cursor,
                        const nebula::surface::eval::Fields& fields) {
   if (auto b = dynamic_cast<nebula::execution::core::BlockExecutor*>(&cursor)) {
     return b->takeResult();
-  } else if (auto f = dynamic_cast<nebula::memory::keyed::FlatRowCursor*>(&cursor)) {
+  }
+
+  if (auto f = dynamic_cast<nebula::memory::keyed::FlatRowCursor*>(&cursor)) {
     return f->takeResult();
-  } else {
-    // TODO(cao): this will lose the aggregation states by adding row by row
-    // we should ask FlatBuffer to support serializaiton with filtered rows
-    // push TOP ROWS serialization into FB instead of row by row rebuild.
-    LOG(INFO) << "Serializing row cursor as flat buffer.";
-    auto buffer = std::make_unique<nebula::memory::keyed::FlatBuffer>(schema, fields);
-    while (cursor.hasNext()) {
-      buffer->add(cursor.next());
+  }
+
+  // top rows of a flat buffer are picked and copied in binary rather than rebuilt row by row
+  if (auto t = dynamic_cast<nebula::surface::TopRows*>(&cursor)) {
+    const nebula::memory::keyed::FlatBuffer* flat = nullptr;
+    if (auto f = std::dynamic_pointer_cast<nebula::memory::keyed::FlatRowCursor>(t->rows())) {
+      flat = &f->flat();
+    } else if (auto b = std::dynamic_pointer_cast<nebula::execution::core::BlockExecutor>(t->rows())) {
+      flat = &b->flat();
+    }
+
+    if (flat && flat->binary()) {
+      auto buffer = std::make_unique<nebula::memory::keyed::FlatBuffer>(schema, fields);
+      for (auto index : t->indices()) {
+        buffer->add(*flat, index);
+      }
+
+      return buffer;
     }
+  }
 
-    return buffer;
+  // samples or composite cursors are not backed by a flat buffer, add them row by row
+  LOG(INFO) << "Serializing row cursor as flat buffer.";
+  auto buffer = std::make_unique<nebula::memory::keyed::FlatBuffer>(schema, fields);
+  while (cursor.hasNext()) {
+    buffer->add(cursor.next());
   }
+
+  return buffer;
 }
 
 void init() {
@@ -15,12 +15,17 @@
  */
 
 #include <fmt/format.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <map>
 #include <yorel/yomm2/cute.hpp>
 
+#include "common/Folly.h"
 #include "execution/ExecutionPlan.h"
+#include "execution/core/AggregationMerge.h"
 #include "execution/core/BlockExecutor.h"
+#include "execution/core/TopSort.h"
 #include "execution/serde/RowCursorSerde.h"
 #include "memory/Batch.h"
 #include "meta/TestTable.h"
@@ -28,6 +33,9 @@
 #include "surface/eval/UDF.h"
 #include "surface/eval/ValueEval.h"
 
+DECLARE_uint64(MERGE_PARTITIONS);
+DECLARE_uint64(MERGE_PARALLEL_ROWS);
+
 namespace nebula {
 namespace execution {
 namespace test {
@@ -37,6 +45,7 @@ using nebula::memory::Batch;
 using nebula::memory::EvaledBlock;
 using nebula::surface::Accessor;
 using nebula::surface::MockRowData;
+using nebula::surface::RowCursorPtr;
 using nebula::surface::RowData;
 using nebula::surface::eval::BlockEval;
 using nebula::surface::eval::column;
@@ -98,7 +107,7 @@ public:
     }
 
   private:
-    int32_t value;
+    int32_t value = 0;
   };
 
 public:
@@ -249,6 +258,219 @@ TEST(ExecutionTest, TestCustomColumn) {
   }
 }
 
+TEST(ExecutionTest, TestPlanBinding) {
+  nebula::meta::TestTable test;
+  auto outputSchema = TypeSerializer::from("ROW<id:int, event:string>");
+  nebula::execution::BlockPhase plan(test.schema(), outputSchema);
+
+  // custom column "event" shadows the column of the same name in input schema
+  nebula::surface::eval::Fields customs;
+  customs.push_back(custom<std::string_view>("event", "const event = () => \"e\";"));
+  nebula::surface::eval::Fields selects;
+  selects.reserve(2);
+  selects.push_back(column<int32_t>("id"));
+  selects.push_back(column<std::string_view>("event"));
+  plan.scan(test.name())
+    .custom(std::move(customs))
+    .compute(std::move(selects))
+    .filter(column<bool>("flag"))
+    .bind();
+
+  const auto& fieldMap = plan.fieldMap();
+  const auto& fields = plan.fields();
+  auto id = fields.at(0)->binding();
+  ASSERT_NE(id, nullptr);
+  EXPECT_EQ(id->ordinal, fieldMap.at("id"));
+  EXPECT_EQ(id->custom, nullptr);
+
+  auto event = fields.at(1)->binding();
+  ASSERT_NE(event, nullptr);
+  EXPECT_EQ(event->ordinal, nebula::surface::eval::Binding::UNBOUND);
+  EXPECT_EQ(event->custom, plan.customs().at(0).get());
+
+  auto flag = plan.filter().binding();
+  ASSERT_NE(flag, nullptr);
+  EXPECT_EQ(flag->ordinal, fieldMap.at("flag"));
+  EXPECT_EQ(flag->custom, nullptr);
+}
+
+TEST(ExecutionTest, TestPartitionedMerge) {
+  nebula::meta::TestTable test;
+  auto outputSchema = TypeSerializer::from("ROW<key:tinyint, agg:int>");
+  nebula::execution::BlockPhase plan(test.schema(), outputSchema);
+
+  nebula::surface::eval::Fields selects;
+  selects.reserve(2);
+  selects.push_back(column<int8_t>("value"));
+  selects.push_back(std::make_unique<TestUdaf>());
+  plan.scan(test.name())
+    .compute(std::move(selects))
+    .filter(constant<bool>(true))
+    .keys({ 0 })
+    .aggregate(1, { false, true });
+
+  // blocks share the same key space of tinyint
+  constexpr auto blocks = 8;
+  constexpr auto size = 1000;
+  std::vector<EvaledBlock> ebs;
+  for (auto i = 0; i < blocks; ++i) {
+    auto batch = std::make_shared<Batch>(test, size);
+    MockRowData row(i + 1);
+    for (auto k = 0; k < size; ++k) {
+      batch->add(row);
+    }
+    ebs.emplace_back(batch, BlockEval::PARTIAL);
+  }
+
+  folly::CPUThreadPoolExecutor pool{ 4 };
+  auto run = [&](size_t partitions) {
+    FLAGS_MERGE_PARTITIONS = partitions;
+    FLAGS_MERGE_PARALLEL_ROWS = 0;
+    std::vector<folly::Try<RowCursorPtr>> sources;
+    for (const auto& eb : ebs) {
+      sources.emplace_back(nebula::execution::core::compute("123", eb, plan));
+    }
+
+    auto cursor = nebula::execution::core::merge(pool, outputSchema, plan.fields(), true, sources);
+
+    // key -> count, null key as 1000
+    std::map<int32_t, int32_t> result;
+    while (cursor->hasNext()) {
+      const auto& row = cursor->next();
+      int32_t key = row.isNull(0) ? 1000 : row.readByte(0);
+      auto agg = std::static_pointer_cast<TestUdaf::Aggregator>(row.getAggregator(1));
+      EXPECT_EQ(result.count(key), 0);
+      result[key] = agg->finalize();
+    }
+
+    return result;
+  };
+
+  auto serial = run(1);
+  auto parallel = run(4);
+  EXPECT_EQ(serial, parallel);
+
+  auto total = 0;
+  for (auto& kv : parallel) {
+    total += kv.second;
+  }
+  EXPECT_EQ(total, blocks * size);
+}
+
+TEST(ExecutionTest, TestBinaryCopySketches) {
+  nebula::meta::TestTable test;
+  auto outputSchema = TypeSerializer::from("ROW<key:tinyint, agg:int>");
+  nebula::execution::BlockPhase plan(test.schema(), outputSchema);
+
+  nebula::surface::eval::Fields selects;
+  selects.reserve(2);
+  selects.push_back(column<int8_t>("value"));
+  selects.push_back(std::make_unique<TestUdaf>());
+  plan.scan(test.name())
+    .compute(std::move(selects))
+    .filter(constant<bool>(true))
+    .keys({ 0 })
+    .aggregate(1, { false, true });
+
+  auto batch = std::make_shared<Batch>(test, 1000);
+  MockRowData row(7);
+  for (auto i = 0; i < 1000; ++i) {
+    batch->add(row);
+  }
+
+  EvaledBlock eb{ batch, BlockEval::PARTIAL };
+  auto cursor = nebula::execution::core::compute("123", eb, plan);
+  const auto& src = std::dynamic_pointer_cast<BlockExecutor>(cursor)->flat();
+  ASSERT_TRUE(src.binary());
+
+  nebula::memory::keyed::FlatBuffer copy(outputSchema, plan.fields());
+  for (size_t r = 0; r < src.getRows(); ++r) {
+    copy.add(src, r);
+  }
+
+  // merging into a copied row never changes the aggregation state of the source row
+  auto value = [](const RowData& r) {
+    return std::static_pointer_cast<TestUdaf::Aggregator>(r.getAggregator(1))->finalize();
+  };
+
+  size_t sketches = 0;
+  for (size_t r = 0; r < src.getRows(); ++r) {
+    auto sketch = copy.row(r).getAggregator(1);
+    if (sketch == nullptr) {
+      continue;
+    }
+
+    ++sketches;
+    const auto expected = value(src.row(r));
+    EXPECT_EQ(value(copy.row(r)), expected);
+    sketch->mix(*src.row(r).getAggregator(1));
+    EXPECT_EQ(value(copy.row(r)), expected * 2);
+    EXPECT_EQ(value(src.row(r)), expected);
+  }
+
+  EXPECT_GT(sketches, 0);
+}
+
+TEST(ExecutionTest, TestTopSort) {
+  nebula::meta::TestTable test;
+  auto outputSchema = TypeSerializer::from("ROW<key:tinyint, agg:int>");
+  auto block = std::make_unique<nebula::execution::BlockPhase>(test.schema(), outputSchema);
+
+  // top 5 keys by count desc and key asc
+  constexpr auto top = 5;
+  nebula::surface::eval::Fields selects;
+  selects.reserve(2);
+  selects.push_back(column<int8_t>("value"));
+  selects.push_back(std::make_unique<TestUdaf>());
+  block->scan(test.name())
+    .compute(std::move(selects))
+    .filter(constant<bool>(true))
+    .keys({ 0 })
+    .aggregate(1, { false, true })
+    .sort({ 1, 0 }, { true, false })
+    .limit(top);
+  const auto& blockPhase = *block;
+  nebula::execution::NodePhase phase(std::move(block));
+
+  constexpr auto size = 1000;
+  auto batch = std::make_shared<Batch>(test, size);
+  MockRowData row;
+  for (auto k = 0; k < size; ++k) {
+    batch->add(row);
+  }
+  EvaledBlock eb{ batch, BlockEval::PARTIAL };
+
+  // expected order through a full sort of all groups, null key goes last
+  using Group = std::tuple<int32_t, bool, int32_t>;
+  const auto group = [](const RowData& r) {
+    auto agg = std::static_pointer_cast<TestUdaf::Aggregator>(r.getAggregator(1));
+    auto isNull = r.isNull(0);
+    return Group{ -agg->finalize(), isNull, isNull ? 0 : r.readByte(0) };
+  };
+
+  std::vector<Group> expected;
+  auto all = nebula::execution::core::compute("123", eb, blockPhase);
+  while (all->hasNext()) {
+    expected.push_back(group(all->next()));
+  }
+  std::sort(expected.begin(), expected.end());
+  expected.resize(std::min<size_t>(expected.size(), top));
+
+  auto cursor = nebula::execution::core::topSort(nebula::execution::core::compute("123", eb, blockPhase), phase);
+  EXPECT_EQ(cursor->size(), expected.size());
+  for (const auto& g : expected) {
+    EXPECT_EQ(group(cursor->next()), g);
+  }
+
+  // only top rows are shipped from node
+  auto topN = nebula::execution::core::topSort(nebula::execution::core::compute("123", eb, blockPhase), phase);
+  auto fb = nebula::execution::serde::asBuffer(*topN, outputSchema, phase.fields());
+  EXPECT_EQ(fb->getRows(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(std::get<2>(group(fb->row(i))), std::get<2>(expected.at(i)));
+  }
+}
+
 } // namespace test
 } // namespace execution
-} // namespace nebula
\ No newline at end of file
+} // namespace nebula
@@ -15,10 +15,13 @@
  */
 
 #include <fmt/format.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <numeric>
 #include <yorel/yomm2/cute.hpp>
 
+#include "api/udf/Prefix.h"
 #include "execution/ExecutionPlan.h"
 #include "execution/core/BlockExecutor.h"
 #include "execution/serde/RowCursorSerde.h"
@@ -29,6 +32,9 @@
 #include "surface/eval/UDF.h"
 #include "surface/eval/ValueEval.h"
 
+DECLARE_bool(VECTORIZE);
+DECLARE_bool(DICT_CODE_KEYS);
+
 /// this test focus on optimized execution by data metadata, mostly histogram
 namespace nebula {
 namespace execution {
@@ -42,6 +48,7 @@ using nebula::surface::RowData;
 using nebula::surface::eval::BlockEval;
 using nebula::surface::eval::column;
 using nebula::surface::eval::constant;
+using nebula::surface::eval::Selection;
 using nebula::surface::eval::UDAF;
 using nebula::type::TypeSerializer;
 
@@ -72,6 +79,151 @@ TEST(OptimizedQuery, TestPredicatePushdown) {
   EvaledBlock eb{ batch, BlockEval::PARTIAL };
   auto cursor = nebula::execution::core::compute("123", eb, plan);
 }
+
+TEST(OptimizedQuery, TestVectorizedFilter) {
+  nebula::meta::TestTable test;
+  auto size = 5000;
+  auto batch = std::make_shared<Batch>(test, size);
+  nebula::surface::MockRowData row;
+  for (auto i = 0; i < size; ++i) {
+    batch->add(row);
+  }
+
+  auto filter = [] {
+    return nebula::surface::eval::band<bool, bool>(
+      nebula::surface::eval::gt<int32_t, int32_t>(column<int32_t>("id"), constant<int32_t>(0)),
+      nebula::surface::eval::eq<bool, bool>(column<bool>("flag"), constant<bool>(true)));
+  };
+
+  // kernel result should match row by row evaluation exactly
+  {
+    auto f = filter();
+    ASSERT_TRUE(f->kernel() != nullptr);
+
+    Selection selection(size);
+    std::iota(selection.begin(), selection.end(), 0);
+    EXPECT_TRUE(f->kernel()(*batch, selection));
+
+    size_t matches = 0;
+    auto accessor = batch->makeAccessor();
+    nebula::surface::eval::EvalContext ctx{ false };
+    for (auto i = 0; i < size; ++i) {
+      ctx.reset(accessor->seek(i));
+      if (f->eval<bool>(ctx).value_or(false)) {
+        EXPECT_EQ(selection.at(matches++), (uint32_t)i);
+      }
+    }
+
+    EXPECT_EQ(matches, selection.size());
+  }
+
+  // block executor produces the same result in both modes
+  auto run = [&](bool vectorize) {
+    FLAGS_VECTORIZE = vectorize;
+    auto outputSchema = TypeSerializer::from("ROW<id:int, flag:bool>");
+    nebula::execution::BlockPhase plan(test.schema(), outputSchema);
+
+    nebula::surface::eval::Fields selects;
+    selects.reserve(2);
+    selects.push_back(column<int32_t>("id"));
+    selects.push_back(column<bool>("flag"));
+    plan.scan(test.name())
+      .compute(std::move(selects))
+      .filter(filter())
+      .aggregate(0, { false, false })
+      .limit(size);
+
+    EvaledBlock eb{ batch, BlockEval::PARTIAL };
+    return nebula::execution::core::compute("vector", eb, plan)->size();
+  };
+
+  auto rows = run(false);
+  EXPECT_EQ(run(true), rows);
+  FLAGS_VECTORIZE = true;
+}
+
+TEST(OptimizedQuery, TestDictionaryCodes) {
+  nebula::meta::ColumnProps props;
+  props.emplace("country", nebula::meta::Column{ false, true });
+  nebula::meta::Table table("dict", TypeSerializer::from("ROW<id:int, country:string>"), props, {});
+  auto batch = std::make_shared<Batch>(table, 1024);
+
+  // 4 countries and nulls
+  const std::vector<std::string_view> countries{ "us", "cn", "uk", "fr" };
+  constexpr size_t size = 3000;
+  std::vector<int32_t> ids(size);
+  std::vector<std::string_view> values(size);
+  auto nulls = std::make_unique<bool[]>(size);
+  for (size_t i = 0; i < size; ++i) {
+    ids[i] = i;
+    values[i] = countries[i % countries.size()];
+    nulls[i] = i % 7 == 0;
+  }
+
+  batch->append<int32_t>("id", ids.data(), nullptr, size);
+  batch->append<std::string_view>("country", values.data(), nulls.get(), size);
+  batch->commit(size);
+
+  // dictionary is served only after sealed
+  EXPECT_EQ(batch->dictSize("country"), 0);
+  batch->seal();
+  EXPECT_EQ(batch->dictSize("country"), countries.size());
+  EXPECT_EQ(batch->dictSize("id"), 0);
+  auto coder = batch->coder("country");
+  ASSERT_TRUE(coder != nullptr);
+  EXPECT_EQ(coder(0), -1);
+  EXPECT_EQ(batch->dictItem("country", coder(3)), "fr");
+
+  // kernels of string predicates match row by row evaluation exactly
+  auto verify = [&](std::unique_ptr<nebula::surface::eval::ValueEval> f) {
+    ASSERT_TRUE(f->kernel() != nullptr);
+    Selection selection(size);
+    std::iota(selection.begin(), selection.end(), 0);
+    EXPECT_TRUE(f->kernel()(*batch, selection));
+
+    size_t matches = 0;
+    auto accessor = batch->makeAccessor();
+    nebula::surface::eval::EvalContext ctx{ false };
+    for (size_t i = 0; i < size; ++i) {
+      ctx.reset(accessor->seek(i));
+      if (f->eval<bool>(ctx).value_or(false)) {
+        EXPECT_EQ(selection.at(matches++), (uint32_t)i);
+      }
+    }
+
+    EXPECT_EQ(matches, selection.size());
+  };
+
+  verify(nebula::surface::eval::eq<std::string_view, std::string_view>(
+    column<std::string_view>("country"), constant<std::string_view>("uk")));
+  verify(nebula::surface::eval::neq<std::string_view, std::string_view>(
+    column<std::string_view>("country"), constant<std::string_view>("uk")));
+  verify(std::make_unique<nebula::api::udf::Prefix>("prefix", column<std::string_view>("country"), "c"));
+  verify(std::make_unique<nebula::api::udf::Prefix>("prefix", column<std::string_view>("country"), "U", false, true));
+
+  // grouping on codes has the same result as grouping on values
+  auto run = [&](bool coded) {
+    FLAGS_DICT_CODE_KEYS = coded;
+    auto outputSchema = TypeSerializer::from("ROW<country:string>");
+    nebula::execution::BlockPhase plan(table.schema(), outputSchema);
+
+    nebula::surface::eval::Fields selects;
+    selects.push_back(column<std::string_view>("country"));
+    plan.scan(table.name())
+      .compute(std::move(selects))
+      .filter(constant<bool>(true))
+      .aggregate(0, { false })
+      .limit(size);
+
+    EvaledBlock eb{ batch, BlockEval::PARTIAL };
+    return nebula::execution::core::compute("dict", eb, plan)->size();
+  };
+
+  EXPECT_EQ(run(false), countries.size() + 1);
+  EXPECT_EQ(run(true), countries.size() + 1);
+  FLAGS_DICT_CODE_KEYS = true;
+}
+
 } // namespace test
 } // namespace execution
 } // namespace nebula
\ No newline at end of file
@@ -19,14 +19,23 @@
 #include <gtest/gtest.h>
 
 #include "common/Evidence.h"
+#include "execution/TableState.h"
+#include "execution/io/BlockLoader.h"
 #include "execution/meta/TableService.h"
+#include "memory/Batch.h"
 #include "meta/TestUtils.h"
+#include "surface/eval/Histogram.h"
+#include "type/Serde.h"
 
 namespace nebula {
 namespace execution {
 namespace test {
 
 using nebula::common::Evidence;
+using nebula::execution::io::BatchBlock;
+using nebula::execution::io::BlockLoader;
+using nebula::memory::Batch;
+using nebula::meta::BlockSignature;
 using nebula::execution::meta::TableService;
 using nebula::meta::DataSpec;
 using nebula::meta::NNode;
@@ -36,6 +45,7 @@ using nebula::meta::SpecSplit;
 using nebula::meta::SpecSplitPtr;
 using nebula::meta::SpecState;
 using nebula::meta::TTL;
+using nebula::surface::eval::IntHistogram;
 
 TEST(TableServiceTest, TestTableService) {
   auto& ts = TableService::singleton();
@@ -96,6 +106,110 @@ TEST(TableServiceTest, TestTableService) {
   }
 }
 
+TEST(TableServiceTest, TestTableStateQuery) {
+  TableState state("test");
+  std::vector<std::tuple<std::string, int64_t, int64_t>> blocks;
+
+  // blocks of two versions with random time ranges
+  std::srand(Evidence::unix_timestamp());
+  for (size_t i = 0; i < 2000; ++i) {
+    auto version = i % 3 == 0 ? "v1" : "v2";
+    int64_t start = std::rand() % 100000;
+    int64_t end = start + std::rand() % 600;
+    blocks.emplace_back(version, start, end);
+    BlockSignature sign{ "test", version, i, start, end, fmt::format("spec{0}", i % 100) };
+    state.add(std::make_shared<BatchBlock>(sign, nullptr, nebula::meta::BlockState{ 1, 1, {} }));
+  }
+
+  auto expect = [&blocks](const std::pair<int64_t, int64_t>& w, const std::string& v) {
+    size_t count = 0;
+    for (auto& b : blocks) {
+      if (std::get<0>(b) == v && std::get<1>(b) <= w.second && std::get<2>(b) >= w.first) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  // index returns exactly the blocks overlapping the window
+  for (auto i = 0; i < 100; ++i) {
+    int64_t start = std::rand() % 100000;
+    std::pair<int64_t, int64_t> window{ start, start + std::rand() % 3000 };
+    EXPECT_EQ(state.query(window, "v1").size(), expect(window, "v1"));
+    EXPECT_EQ(state.query(window, "v2").size(), expect(window, "v2"));
+  }
+
+  EXPECT_EQ(state.query({ 0, 200000 }, "v3").size(), 0);
+
+  // index is rebuilt after removal
+  state.remove("spec0");
+  for (size_t i = 0; i < blocks.size(); i += 100) {
+    std::get<0>(blocks.at(i)) = "removed";
+  }
+
+  EXPECT_EQ(state.query({ 0, 200000 }, "v1").size(), expect({ 0, 200000 }, "v1"));
+  EXPECT_EQ(state.query({ 0, 200000 }, "v2").size(), expect({ 0, 200000 }, "v2"));
+}
+
+TEST(TableServiceTest, TestLiveReplace) {
+  TableState state("live");
+  for (size_t i = 0; i < 100; ++i) {
+    BlockSignature sign{ "live", "v1", i, (int64_t)i * 10, (int64_t)i * 10 + 5, fmt::format("spec{0}", i) };
+    nebula::surface::eval::HistVector hists{ std::make_shared<IntHistogram>("id", 10, 0, 9, 45) };
+    state.add(std::make_shared<BatchBlock>(sign, nullptr, nebula::meta::BlockState{ 10, 100, hists }));
+  }
+
+  EXPECT_EQ(state.query({ 0, 2000 }, "v1").size(), 100);
+
+  nebula::meta::Table table("live", nebula::type::TypeSerializer::from("ROW<id:int>"), {}, {});
+  auto batch = std::make_shared<Batch>(table, 16);
+  int32_t id = 0;
+  auto publish = [&](int64_t end) {
+    std::vector<int32_t> ids(10);
+    for (auto& v : ids) {
+      v = id++;
+    }
+
+    batch->append<int32_t>("id", ids.data(), nullptr, ids.size());
+    batch->commit(ids.size());
+    return state.replace(BlockLoader::snapshot(BlockSignature{ "live", "v1", 0, 1000, end, "tail" }, batch));
+  };
+
+  // first publish of a live spec goes through a full rebuild
+  EXPECT_EQ(publish(1005), 0);
+  const auto index = state.indices();
+  EXPECT_EQ(index->at("v1").blocks.size(), 100);
+
+  // later publishes don't touch other blocks, the index snapshot stays the same
+  for (auto i = 1; i <= 10; ++i) {
+    EXPECT_EQ(publish(1005 + i), 1);
+    EXPECT_EQ(state.indices(), index);
+  }
+
+  EXPECT_EQ(state.numBlocks(), 101);
+  EXPECT_EQ(state.numRows(), 1110);
+  EXPECT_EQ(state.timeWindow().second, 1015);
+  auto hist = std::dynamic_pointer_cast<IntHistogram>(state.hists().at(0));
+  ASSERT_NE(hist, nullptr);
+  EXPECT_EQ(hist->count, 1110);
+  EXPECT_EQ(hist->sum(), 4500 + 109 * 110 / 2);
+  EXPECT_EQ(hist->max(), 109);
+
+  // live block is served without the index
+  EXPECT_EQ(state.query({ 1010, 1020 }, "v1").size(), 1);
+  EXPECT_EQ(state.query({ 0, 2000 }, "v1").size(), 101);
+  EXPECT_EQ(state.query({ 0, 2000 }, "v2").size(), 0);
+
+  // sealed block takes its final place in the index
+  batch->seal();
+  EXPECT_EQ(state.replace(BlockLoader::from(BlockSignature{ "live", "v1", 0, 1000, 1015, "tail" }, batch)), 1);
+  EXPECT_NE(state.indices(), index);
+  EXPECT_EQ(state.indices()->at("v1").blocks.size(), 101);
+  EXPECT_EQ(state.numRows(), 1110);
+  EXPECT_EQ(state.query({ 1010, 1020 }, "v1").size(), 1);
+  EXPECT_EQ(state.query({ 0, 2000 }, "v1").size(), 101);
+}
+
 } // namespace test
 } // namespace execution
 } // namespace nebula
\ No newline at end of file
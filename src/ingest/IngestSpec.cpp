@@ -16,12 +16,15 @@
 
 #include "IngestSpec.h"
 
+#include <chrono>
 #include <gflags/gflags.h>
 #include <gperftools/heap-profiler.h>
 #include <rapidjson/document.h>
+#include <shared_mutex>
 
 #include "MacroRow.h"
 #include "common/Evidence.h"
+#include "common/Folly.h"
 #include "common/Wrap.h"
 #include "execution/BlockManager.h"
 #include "execution/meta/TableService.h"
@@ -29,8 +32,10 @@
 #include "meta/TestTable.h"
 #include "storage/CsvReader.h"
 #include "storage/JsonReader.h"
+#include "storage/MappedFile.h"
 #include "storage/NFS.h"
 #include "storage/ParquetReader.h"
+#include "storage/RangeReader.h"
 #include "storage/VectorReader.h"
 #include "storage/http/Http.h"
 #include "storage/kafka/KafkaReader.h"
@@ -40,6 +45,18 @@
 // table-wise customization
 DEFINE_string(NTEST_LOADER, "NebulaTest", "define the loader name for loading nebula test data");
 DEFINE_uint64(NBLOCK_MAX_ROWS, 1000000, "max rows per block");
+DEFINE_bool(INGEST_STREAMING, true,
+            "parse files through ranged reads while downloading them rather than copying to local first");
+DEFINE_uint64(INGEST_STREAM_CHUNK, 8 * 1024 * 1024, "bytes of each ranged read when streaming a file");
+DEFINE_bool(INGEST_COLUMNAR, true, "ingest parquet files column by column for non-partitioned tables");
+DEFINE_uint64(INGEST_COLUMNAR_ROWS, 4096, "max rows decoded at once per column in columnar ingestion");
+DEFINE_uint64(INGEST_CHUNK_MB, 64,
+              "local csv and line json files are mapped and parsed in chunks of about this size "
+              "by ingest threads in parallel, 0 to disable");
+DEFINE_uint32(INGEST_THREADS, 0,
+              "threads to ingest splits and parquet row groups of a spec in parallel."
+              "0: use hardware concurrency"
+              "1: use current thread only");
 
 /**
  * We will sync etcd configs for cluster info into this memory object
@@ -71,16 +88,26 @@ using nebula::meta::TableSpecPtr;
 using nebula::meta::TestTable;
 using nebula::meta::TimeSpec;
 using nebula::meta::TimeType;
+using nebula::storage::ByteRange;
+using nebula::storage::CsvChunkReader;
 using nebula::storage::CsvReader;
+using nebula::storage::JsonChunkReader;
+using nebula::storage::MappedFile;
 using nebula::storage::JsonVectorReader;
 using nebula::storage::makeJsonReader;
+using nebula::storage::NFileSystem;
 using nebula::storage::ParquetReader;
+using nebula::storage::RangeFile;
+using nebula::storage::RangeStream;
 using nebula::storage::http::HttpService;
 using nebula::storage::kafka::KafkaReader;
 using nebula::storage::kafka::KafkaSegment;
+using nebula::storage::kafka::KafkaTopic;
 using nebula::surface::RowCursor;
 using nebula::surface::RowData;
+using nebula::type::Kind;
 using nebula::type::LongType;
+using nebula::type::Schema;
 using nebula::type::TypeSerializer;
 
 static constexpr auto LOADER_SWAP = "Swap";
@@ -90,6 +117,15 @@ static constexpr auto LOADER_API = "Api";
 // a settings to overwrite batch size of a table
 static constexpr auto BATCH_SIZE = "batch";
 
+// ingest workers run in its own pool rather than the node pool,
+// because ingest specs are running in the node pool and wait for their workers.
+folly::CPUThreadPoolExecutor& ingestPool() {
+  static folly::CPUThreadPoolExecutor pool{
+    FLAGS_INGEST_THREADS == 0 ? std::thread::hardware_concurrency() : FLAGS_INGEST_THREADS
+  };
+  return pool;
+}
+
 // load some nebula test data into current process
 void loadNebulaTestData(const TableSpecPtr& table, const std::string& spec) {
   // load test data to run this query
@@ -151,7 +187,31 @@ size_t IngestSpec::work() noexcept {
 
 bool IngestSpec::load(BlockList& blocks) noexcept {
   // if domain is present - assume it's S3 file
-  auto fs = nebula::storage::makeFS(dsu::getProtocol(table_->source), domain_, table_->settings);
+  std::shared_ptr<NFileSystem> fs = nebula::storage::makeFS(dsu::getProtocol(table_->source), domain_, table_->settings);
+
+  // local text files are mapped in place and parsed in chunks without a copy
+  if (table_->source == DataSource::LOCAL && chunkable()) {
+    for (auto& split : splits_) {
+      split->local = split->path;
+    }
+
+    bool result = this->ingest(blocks);
+    for (auto& split : splits_) {
+      split->local.resize(0);
+    }
+
+    return result;
+  }
+
+  // parse data directly from the file system if it supports ranged reads,
+  // compressed csv is inflated from the ranged reads as well
+  const auto streamable = table_->format == DataFormat::PARQUET
+                          || table_->format == DataFormat::JSON
+                          || table_->format == DataFormat::CSV;
+  if (FLAGS_INGEST_STREAMING && streamable && fs->ranged()) {
+    return this->ingest(blocks, fs);
+  }
+
   auto localFs = nebula::storage::makeFS("local");
 
   // attach a local file to each split
@@ -404,7 +464,6 @@ size_t IngestSpec::loadKafka(SpecSplitPtr split) noexcept {
   // build up the segment to consume
   // note that: Kafka path is composed by this pattern: "{partition}_{offset}_{size}"
   auto segment = KafkaSegment::from(split->path);
-  KafkaReader reader(table_, std::move(segment));
 
   // time function
   MacroRow macroRow(table_->timeSpec, split->watermark, split->macros);
@@ -413,13 +472,45 @@ size_t IngestSpec::loadKafka(SpecSplitPtr split) noexcept {
   auto table = table_->to();
 
   // build a batch
-  auto batch = std::make_shared<Batch>(*table, reader.size());
+  auto batch = std::make_shared<Batch>(*table, segment.size);
 
   auto lowTime = std::numeric_limits<int64_t>::max();
   auto highTime = std::numeric_limits<int64_t>::min();
 
-  while (reader.hasNext()) {
-    auto& r = reader.next();
+  // live tail: the batch is published to queries periodically while it's being filled,
+  // every publish replaces the previous block of this spec with a new state.
+  // the writer holds the batch lock over a run of rows, it's released when a run is full
+  // or the reader is about to wait for new messages.
+  static constexpr size_t LIVE_RUN = 1024;
+  const auto tailMs = KafkaTopic::tailMs();
+  auto bm = BlockManager::init();
+  std::unique_lock<std::shared_mutex> writing;
+  size_t run = 0;
+  size_t published = 0;
+  auto last = std::chrono::steady_clock::now();
+  auto publish = [&](bool force) {
+    if (writing.owns_lock()) {
+      writing.unlock();
+    }
+
+    run = 0;
+    const auto now = std::chrono::steady_clock::now();
+    const auto rows = batch->getRows();
+    if (rows == published
+        || (!force && std::chrono::duration_cast<std::chrono::milliseconds>(now - last).count() < (int64_t)tailMs)) {
+      return;
+    }
+
+    bm->replace(BlockLoader::snapshot(BlockSignature{ table->name(), "v1", 0, lowTime, highTime, id_ }, batch));
+    published = rows;
+    last = now;
+  };
+
+  auto reader = tailMs > 0
+                  ? std::make_unique<KafkaReader>(table_, std::move(segment), tailMs, [&publish]() { publish(true); })
+                  : std::make_unique<KafkaReader>(table_, std::move(segment));
+  while (reader->hasNext()) {
+    auto& r = reader->next();
     const auto& row = macroRow.set(&r);
 
     // TODO(cao) - Kafka may produce NULL row due to corruption or exception
@@ -439,14 +530,46 @@ size_t IngestSpec::loadKafka(SpecSplitPtr split) noexcept {
     }
 
     // add a new entry
+    if (tailMs > 0) {
+      if (!writing.owns_lock()) {
+        writing = batch->lock();
+      }
+
+      batch->add(row);
+      if (++run >= LIVE_RUN) {
+        publish(false);
+      }
+
+      continue;
+    }
+
     batch->add(row);
   }
 
+  if (writing.owns_lock()) {
+    writing.unlock();
+  }
+
+  // a live segment given up waiting drops its published rows, it's consumed from its start again
+  if (reader->incomplete()) {
+    bm->removeBySpec(table->name(), id_);
+    retry_ = true;
+    return 0;
+  }
+
   // build a block and add it to block manager
-  batch->seal();
-  BlockManager::init()->add(
-    BlockLoader::from(
-      BlockSignature{ table->name(), "v1", 0, lowTime, highTime, id_ }, batch));
+  // a live batch is sealed in place and swapped in with its final state
+  {
+    auto lock = batch->lock();
+    batch->seal();
+  }
+
+  auto block = BlockLoader::from(BlockSignature{ table->name(), "v1", 0, lowTime, highTime, id_ }, batch);
+  if (tailMs > 0) {
+    bm->replace(block);
+  } else {
+    bm->add(block);
+  }
 
 #ifdef PPROF
   HeapProfilerStop();
@@ -456,7 +579,63 @@ size_t IngestSpec::loadKafka(SpecSplitPtr split) noexcept {
   return 1;
 }
 
-bool IngestSpec::ingest(BlockList& blocks) noexcept {
+std::unique_ptr<RowCursor> IngestSpec::open(SpecSplitPtr split,
+                                            const Schema& schema,
+                                            const std::vector<std::string>& columns,
+                                            std::shared_ptr<NFileSystem> fs,
+                                            std::pair<size_t, size_t> groups) {
+  if (table_->source == DataSource::GSHEET) {
+    return this->readGSheet();
+  }
+
+  // stream the file through ranged reads while parsing
+  const auto size = fs != nullptr ? fs->info(split->path).size : 0;
+  if (fs != nullptr) {
+    LOG(INFO) << "Streaming split: " << split->path << ", size: " << size;
+    if (table_->format == DataFormat::CSV) {
+      auto stream = std::make_unique<RangeStream>(fs, split->path, size, FLAGS_INGEST_STREAM_CHUNK);
+      return std::make_unique<CsvReader>(std::move(stream), split->path, table_->csv, columns);
+    }
+
+    if (table_->format == DataFormat::JSON) {
+      auto stream = std::make_unique<RangeStream>(fs, split->path, size, FLAGS_INGEST_STREAM_CHUNK);
+      return makeJsonReader(std::move(stream), table_->json, schema, columns);
+    }
+  } else if (table_->format == DataFormat::CSV) {
+    if (groups.second > 0) {
+      return std::make_unique<CsvChunkReader>(
+        std::make_shared<MappedFile>(split->local), groups, table_->csv, columns);
+    }
+
+    return std::make_unique<CsvReader>(split->local, table_->csv, columns);
+  } else if (table_->format == DataFormat::JSON) {
+    if (groups.second > 0) {
+      return std::make_unique<JsonChunkReader>(
+        std::make_shared<MappedFile>(split->local), groups, table_->json, schema, columns);
+    }
+
+    return makeJsonReader(split->local, table_->json, schema, columns);
+  }
+
+  if (table_->format == DataFormat::PARQUET) {
+    // parquet reads footer and needed column chunks only when streaming
+    // schema is modified with time column, we need original schema here
+    auto reader = fs != nullptr
+                    ? std::make_unique<ParquetReader>(
+                      std::make_shared<RangeFile>(fs, split->path, size), schema, columns)
+                    : std::make_unique<ParquetReader>(split->local, schema, columns);
+    if (groups.second > 0) {
+      reader->range(groups.first, groups.second);
+    }
+
+    return reader;
+  }
+
+  LOG(ERROR) << "Supported data formats: csv, json, parquet.";
+  return nullptr;
+}
+
+bool IngestSpec::ingest(BlockList& blocks, std::shared_ptr<NFileSystem> fs) noexcept {
   auto table = table_->to();
   auto version = version_;
 
@@ -487,8 +666,9 @@ bool IngestSpec::ingest(BlockList& blocks) noexcept {
   }
 
   // a lambda to build batch block
-  std::pair<int64_t, int64_t> range{ std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() };
-  auto makeBlock = [&table, &version, &range, &specId](size_t bid, std::shared_ptr<Batch> b) {
+  using Range = std::pair<int64_t, int64_t>;
+  std::atomic<size_t> blockId{ 0 };
+  auto makeBlock = [&table, &version, &specId, &blockId](std::shared_ptr<Batch> b, const Range& range) {
     // seal the block
     b->seal();
     LOG(INFO) << "Push a block: " << b->state();
@@ -498,111 +678,257 @@ bool IngestSpec::ingest(BlockList& blocks) noexcept {
       BlockSignature{
         table->name(),
         version,
-        bid,
+        blockId++,
         range.first,
         range.second,
         specId },
       b);
   };
 
-  // This may result in many blocks since it's partitioned in each ingestion spec.
-  std::unordered_map<size_t, std::shared_ptr<Batch>> batches;
-  auto pod = table->pod();
-  size_t blockId = 0;
-
-  // TODO: introduce a flag to fail whole spec when bad file hit
-  // ISSUE: https://github.com/varchar-io/nebula/issues/175
+  // break the spec into units of work: one per split,
+  // a parquet split is broken further by row groups if there are not enough splits to keep all threads busy,
+  // so is a local text file by chunks of lines.
+  auto& pool = ingestPool();
+  const size_t threads = pool.numThreads();
+  std::vector<std::pair<SpecSplitPtr, std::pair<size_t, size_t>>> units;
+  const auto byGroups = table_->format == DataFormat::PARQUET
+                        && table_->source != DataSource::GSHEET
+                        && splits_.size() < threads;
+  const auto byChunks = fs == nullptr
+                        && chunkable()
+                        && FLAGS_INGEST_CHUNK_MB > 0
+                        && splits_.size() < threads;
   for (const auto& split : splits_) {
-    std::unique_ptr<RowCursor> source = nullptr;
-    try {
-      if (table_->source == DataSource::GSHEET) {
-        source = this->readGSheet();
-      } else if (table_->format == DataFormat::CSV) {
-        source = std::make_unique<CsvReader>(split->local, table_->csv, columns);
-      } else if (table_->format == DataFormat::JSON) {
-        source = makeJsonReader(split->local, table_->json, schema, columns);
-      } else if (table_->format == DataFormat::PARQUET) {
-        // schema is modified with time column, we need original schema here
-        source = std::make_unique<ParquetReader>(split->local, schema, columns);
-      } else {
-        LOG(ERROR) << "Supported data formats: csv, json, parquet.";
-        continue;
+    if (byChunks) {
+      std::vector<ByteRange> chunks;
+      try {
+        MappedFile file(split->local);
+        const auto parts = std::min(threads, file.size() / (FLAGS_INGEST_CHUNK_MB << 20) + 1);
+        if (parts > 1) {
+          chunks = file.lines(parts, table_->format == DataFormat::CSV);
+        }
+      } catch (const std::exception& exp) {
+        LOG(ERROR) << "Error mapping split: " << split->path << ", exception: " << exp.what();
+        return false;
       }
 
-      // no valid reader is created
-      if (source == nullptr) {
+      if (chunks.size() > 1) {
+        LOG(INFO) << "Ingest split " << split->path << " in chunks: " << chunks.size();
+        for (const auto& chunk : chunks) {
+          units.emplace_back(split, chunk);
+        }
+
         continue;
       }
+    }
 
-      // build time row to handle time column and macro columns reading
-      MacroRow macroRow(table_->timeSpec, split->watermark, split->macros);
+    size_t groups = 0;
+    if (byGroups) {
+      try {
+        groups = static_cast<ParquetReader*>(open(split, schema, columns, fs).get())->groups();
+      } catch (const std::exception& exp) {
+        LOG(ERROR) << "Error opening split: " << split->path << ", exception: " << exp.what();
+        return false;
+      }
+    }
 
-      // ingest current reader into the blocks
-      while (source->hasNext()) {
-        auto& r = source->next();
-        const auto& row = macroRow.set(&r);
+    // each unit reads about equal number of row groups, or whole file if not broken
+    if (groups == 0) {
+      units.emplace_back(split, std::pair<size_t, size_t>{ 0, 0 });
+      continue;
+    }
 
-        // for non-partitioned, all batch's pid will be 0
-        size_t pid = 0;
-        BessType bess = -1;
-        if (pod) {
-          pid = pod->pod(row, bess);
-        }
+    const auto parts = std::min(groups, threads);
+    for (size_t i = 0; i < parts; ++i) {
+      units.emplace_back(split, std::pair<size_t, size_t>{ groups * i / parts, groups * (i + 1) / parts });
+    }
+  }
 
-        // get the batch
-        auto batch = batches[pid];
-        if (batch == nullptr) {
-          batch = std::make_shared<Batch>(*table, bRows, pid);
-          batches[pid] = batch;
+  auto pod = table->pod();
+
+  // columnar ingestion needs time column computed by itself, and bess is computed from a row
+  const auto columnar = FLAGS_INGEST_COLUMNAR
+                        && pod == nullptr
+                        && table_->timeSpec.type != TimeType::PROVIDED;
+
+  // every worker pulls units one by one and ingests them into its own batches,
+  // nothing is shared between workers except the unit cursor and block ID.
+  const auto workers = std::min(threads, units.size());
+  std::vector<BlockList> lists(workers);
+  std::atomic<size_t> cursor{ 0 };
+  std::atomic<bool> failed{ false };
+  auto work = [&](size_t worker) {
+    // This may result in many blocks since it's partitioned in each ingestion spec.
+    std::unordered_map<size_t, std::pair<std::shared_ptr<Batch>, Range>> batches;
+    auto& list = lists.at(worker);
+
+    // get the batch of given partition, a full batch is moved to the block list and replaced by a new one
+    auto batchOf = [&](size_t pid, size_t capacity) -> std::pair<std::shared_ptr<Batch>, Range>& {
+      auto& entry = batches[pid];
+      if (entry.first == nullptr || entry.first->getRows() >= bRows) {
+        if (entry.first != nullptr) {
+          list.push_front(makeBlock(entry.first, entry.second));
         }
 
-        // if this is already full
-        if (batch->getRows() >= bRows) {
-          // move it to the manager and erase it from the map
-          blocks.push_front(makeBlock(blockId++, batch));
+        entry = { std::make_shared<Batch>(*table, capacity, pid),
+                  { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() } };
+      }
+
+      return entry;
+    };
+
+    // TODO: introduce a flag to fail whole spec when bad file hit
+    // ISSUE: https://github.com/varchar-io/nebula/issues/175
+    for (auto u = cursor++; u < units.size() && !failed; u = cursor++) {
+      const auto& split = units.at(u).first;
+      try {
+        auto source = open(split, schema, columns, fs, units.at(u).second);
 
-          // make a new batch
-          batch = std::make_shared<Batch>(*table, bRows, pid);
-          batches[pid] = batch;
-          range = { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min() };
+        // no valid reader is created
+        if (source == nullptr) {
+          continue;
         }
 
-        // update time range before adding the row to the batch
-        // get time column value
-        int64_t time = row.readLong(Table::TIME_COLUMN);
-        if (time < range.first) {
-          range.first = time;
+        // size the batch by rows of current source if it is known
+        const auto capacity = source->size() > 0 ? std::min(bRows, source->size()) : bRows;
+
+        // build time row to handle time column and macro columns reading
+        MacroRow macroRow(table_->timeSpec, split->watermark, split->macros);
+
+        // csv rows bound to table schema are added into batches by column ordinals rather than names
+        const auto tableSchema = table->schema();
+        auto chunk = dynamic_cast<CsvChunkReader*>(source.get());
+        if (chunk != nullptr) {
+          chunk->bind(tableSchema);
         }
 
-        if (time > range.second) {
-          range.second = time;
+        auto csv = dynamic_cast<CsvReader*>(source.get());
+        if (csv != nullptr) {
+          csv->bind(tableSchema);
+        }
+        macroRow.bind(tableSchema);
+
+        // parquet is ingested column by column into the batch
+        auto parquet = dynamic_cast<ParquetReader*>(source.get());
+        if (parquet != nullptr && columnar) {
+          std::vector<int64_t> times;
+          while (parquet->hasNext()) {
+            auto& entry = batchOf(0, capacity);
+            auto& batch = *entry.first;
+            auto& range = entry.second;
+
+            // time column is computed for each row from columns not stored in the batch
+            times.clear();
+            const auto max = std::min<size_t>(FLAGS_INGEST_COLUMNAR_ROWS, bRows - batch.getRows());
+            const auto rows = parquet->read(batch, max, [&](const RowData& r) {
+              int64_t time = macroRow.set(&r).readLong(Table::TIME_COLUMN);
+              if (time < range.first) {
+                range.first = time;
+              }
+
+              if (time > range.second) {
+                range.second = time;
+              }
+
+              times.push_back(time);
+            });
+
+            batch.append<int64_t>(Table::TIME_COLUMN, times.data(), nullptr, rows);
+
+            // macro columns have the same value for all rows of a split
+            for (const auto& macro : split->macros) {
+              if (batch.has(macro.first) && batch.columnType(macro.first)->k() == Kind::VARCHAR) {
+                std::vector<std::string_view> values(rows, macro.second);
+                batch.append<std::string_view>(macro.first, values.data(), nullptr, rows);
+              }
+            }
+
+            batch.commit(rows);
+          }
+
+          continue;
         }
 
-        // add a new entry
-        batch->add(row, bess);
+        // ingest current reader into the blocks
+        while (source->hasNext()) {
+          auto& r = source->next();
+          const auto& row = macroRow.set(&r);
+
+          // for non-partitioned, all batch's pid will be 0
+          size_t pid = 0;
+          BessType bess = -1;
+          if (pod) {
+            pid = pod->pod(row, bess);
+          }
+
+          // get the batch
+          auto& entry = batchOf(pid, capacity);
+
+          // update time range before adding the row to the batch
+          // get time column value
+          auto& range = entry.second;
+          int64_t time = row.readLong(Table::TIME_COLUMN);
+          if (time < range.first) {
+            range.first = time;
+          }
+
+          if (time > range.second) {
+            range.second = time;
+          }
+
+          // add a new entry
+          entry.first->add(row, bess);
+        }
+      } catch (const std::exception& exp) {
+        LOG(ERROR) << "Error processing split: " << split->path
+                   << ", table: " << table_->name
+                   << ", exception: " << exp.what();
+
+        // it does not make sense to continue if we can not read the file
+        failed = true;
+        return;
       }
-    } catch (const std::exception& exp) {
-      LOG(ERROR) << "Error processing split: " << split->path
-                 << ", table: " << table_->name
-                 << ", exception: " << exp.what();
+    }
 
-      // it does not make sense to continue if we can not read the file
-      return false;
+    // build all data blocks
+    for (auto& itr : batches) {
+      // TODO(cao) - the block maybe too small
+      // to waste lots of memory especially in case of sparse storage
+      // we need to try to compress them if useful to save memory
+
+      // it does not make sense to push empty block into the manager
+      auto& entry = itr.second;
+      if (entry.first->getRows() > 0) {
+        list.push_front(makeBlock(entry.first, entry.second));
+      }
     }
+  };
+
+  // run all workers except the first one in the ingest pool, current thread works as the first one.
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(workers);
+  for (size_t i = 1; i < workers; ++i) {
+    auto p = std::make_shared<folly::Promise<folly::Unit>>();
+    pool.add([i, &work, p]() {
+      p->setWith([i, &work]() { work(i); });
+    });
+
+    futures.push_back(p->getFuture());
   }
 
-  // build all data blocks
-  // move all blocks in map into block manager
-  for (auto& itr : batches) {
-    // TODO(cao) - the block maybe too small
-    // to waste lots of memory especially in case of sparse storage
-    // we need to try to compress them if useful to save memory
+  if (workers > 0) {
+    work(0);
+  }
 
-    // it does not make sense to push empty block into the manager
-    auto batch = itr.second;
-    if (batch->getRows() > 0) {
-      blocks.push_front(makeBlock(blockId++, batch));
-    }
+  folly::collectAll(futures).get();
+  if (failed) {
+    return false;
+  }
+
+  // move all blocks built by workers into the result,
+  // they are registered together by the caller through block manager.
+  for (auto& list : lists) {
+    blocks.splice_after(blocks.before_begin(), list);
   }
 
   // return all blocks built up so far
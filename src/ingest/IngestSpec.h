@@ -25,6 +25,7 @@
 #include "meta/DataSpec.h"
 #include "meta/NNode.h"
 #include "meta/TableSpec.h"
+#include "storage/NFileSystem.h"
 
 /**
  * A ingest spec is generated from table setting based on its ingestion type.
@@ -56,6 +57,12 @@ public:
   // return number of blocks produced
   size_t work() noexcept;
 
+  // the spec stopped before all its data loaded (eg. a live segment not filled up in time),
+  // nothing of it is kept and it's supposed to be ingested again.
+  inline bool retry() const {
+    return retry_;
+  }
+
 private:
   // load swap
   size_t loadSwap() noexcept;
@@ -84,8 +91,26 @@ private:
   // load current spec as blocks
   bool load(nebula::execution::io::BlockList&) noexcept;
 
-  // ingest will expect all files are downloaded
-  bool ingest(nebula::execution::io::BlockList&) noexcept;
+  // local csv and line json files can be parsed in chunks in place
+  inline bool chunkable() const {
+    return (table_->format == nebula::meta::DataFormat::CSV && table_->csv.compression.empty())
+           || (table_->format == nebula::meta::DataFormat::JSON && table_->json.rowsField.empty());
+  }
+
+  // open a reader of given split, a parquet reader can be limited to a range of row groups,
+  // a local text file reader can be limited to a chunk of bytes.
+  std::unique_ptr<nebula::surface::RowCursor> open(nebula::meta::SpecSplitPtr,
+                                                   const nebula::type::Schema&,
+                                                   const std::vector<std::string>&,
+                                                   std::shared_ptr<nebula::storage::NFileSystem>,
+                                                   std::pair<size_t, size_t> = { 0, 0 });
+
+  // ingest will expect all files are downloaded unless a file system is provided to stream them
+  // splits, parquet row groups and text file chunks are ingested in parallel by ingest workers
+  bool ingest(nebula::execution::io::BlockList&, std::shared_ptr<nebula::storage::NFileSystem> = nullptr) noexcept;
+
+private:
+  bool retry_ = false;
 };
 
 } // namespace ingest
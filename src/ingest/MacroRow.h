@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "meta/TableSpec.h"
 
 /**
@@ -38,6 +40,30 @@ public:
     return *this;
   }
 
+  // bind to a schema to serve reads by column ordinals of it,
+  // it's bound only if the wrapped row is bound to the same schema too.
+  void bind(const nebula::type::Schema& schema) {
+    schema_ = schema.get();
+    time_ = std::numeric_limits<size_t>::max();
+    values_.assign(schema->size(), nullptr);
+    for (size_t i = 0, size = schema->size(); i < size; ++i) {
+      const auto& name = schema->childType(i)->name();
+      if (name == nebula::meta::Table::TIME_COLUMN) {
+        time_ = i;
+        continue;
+      }
+
+      auto macro = macros_.find(name);
+      if (macro != macros_.end()) {
+        values_[i] = &macro->second;
+      }
+    }
+  }
+
+  bool bound(const nebula::type::Schema& schema) const override {
+    return schema_ == schema.get() && row_->bound(schema);
+  }
+
 // raw date to _time_ columm in ingestion time
 #define TRANSFER(TYPE, FUNC)                           \
   TYPE FUNC(const std::string& field) const override { \
@@ -54,6 +80,25 @@ public:
   TRANSFER(std::unique_ptr<nebula::surface::ListData>, readList)
   TRANSFER(std::unique_ptr<nebula::surface::MapData>, readMap)
 
+#undef TRANSFER
+
+#define TRANSFER(TYPE, FUNC)                                   \
+  TYPE FUNC(nebula::surface::IndexType index) const override { \
+    return row_->FUNC(index);                                  \
+  }
+
+  TRANSFER(bool, readBool)
+  TRANSFER(int8_t, readByte)
+  TRANSFER(int16_t, readShort)
+  TRANSFER(int32_t, readInt)
+  TRANSFER(float, readFloat)
+  TRANSFER(double, readDouble)
+  TRANSFER(int128_t, readInt128)
+  TRANSFER(std::unique_ptr<nebula::surface::ListData>, readList)
+  TRANSFER(std::unique_ptr<nebula::surface::MapData>, readMap)
+
+#undef TRANSFER
+
   bool isNull(const std::string& field) const override {
     if (N_UNLIKELY(field == nebula::meta::Table::TIME_COLUMN)
         || macros_.find(field) != macros_.end()) {
@@ -82,6 +127,30 @@ public:
     return row_->readString(field);
   }
 
+  bool isNull(nebula::surface::IndexType index) const override {
+    if (N_UNLIKELY(index == time_) || values_[index] != nullptr) {
+      return false;
+    }
+
+    return row_->isNull(index);
+  }
+
+  int64_t readLong(nebula::surface::IndexType index) const override {
+    if (N_UNLIKELY(index == time_)) {
+      return timeFunc_(row_);
+    }
+
+    return row_->readLong(index);
+  }
+
+  std::string_view readString(nebula::surface::IndexType index) const override {
+    if (N_UNLIKELY(values_[index] != nullptr)) {
+      return *values_[index];
+    }
+
+    return row_->readString(index);
+  }
+
 private:
   // A method to convert time spec into a time function
   std::function<int64_t(const nebula::surface::RowData*)> makeTimeFunc(const nebula::meta::TimeSpec& ts, int64_t watermark) {
@@ -172,6 +241,11 @@ private:
   std::function<int64_t(const nebula::surface::RowData*)> timeFunc_;
   const nebula::surface::RowData* row_;
   const nebula::common::MapKV macros_;
+
+  // bound schema: ordinal of time column and macro value of every ordinal
+  const nebula::type::RowType* schema_ = nullptr;
+  size_t time_;
+  std::vector<const std::string*> values_;
 };
 
 } // namespace ingest
@@ -16,10 +16,12 @@
 
 #include <fmt/format.h>
 #include <folly/Conv.h>
+#include <gflags/gflags.h>
 
 #include "SpecRepo.h"
 
 #include "common/Evidence.h"
+#include "common/HashRing.h"
 #include "execution/BlockManager.h"
 #include "execution/meta/SpecProvider.h"
 #include "execution/meta/TableService.h"
@@ -31,10 +33,13 @@
  * We will sync etcd configs for cluster info into this memory object
  * To understand cluster status - total nodes.
  */
+DEFINE_double(SPEC_LOAD_BOUND, 0.25, "a node hosts at most (1 + bound) times of its weighted share of specs");
+
 namespace nebula {
 namespace ingest {
 
 using dsu = nebula::meta::DataSourceUtils;
+using nebula::common::BoundedRing;
 using nebula::common::Evidence;
 using nebula::common::Identifiable;
 using nebula::common::MapKV;
@@ -178,8 +183,6 @@ void resetSpec(SpecPtr& spec) {
 std::pair<size_t, size_t> SpecRepo::assign(const ClientMaker& clientMaker) noexcept {
   std::lock_guard<std::mutex> lock(specsMutex_);
 
-  // TODO(cao) - build resource constaints here to reach a balance
-  // for now, we just spin new specs into nodes with lower memory size
   auto nodes = ClusterInfo::singleton().nodes();
   const auto size = nodes.size();
   if (size == 0) {
@@ -187,30 +190,32 @@ std::pair<size_t, size_t> SpecRepo::assign(const ClientMaker& clientMaker) noexc
     return { 0, 0 };
   }
 
-  // allocate resource to less occupied node first
-  std::sort(nodes.begin(), nodes.end(), [](auto& n1, auto& n2) {
-    return n1.size < n2.size;
+  // only active nodes are able to host specs
+  std::vector<NNode> actives;
+  actives.reserve(size);
+  std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(actives), [](const auto& n) {
+    return n.isActive();
   });
 
+  if (actives.empty()) {
+    LOG(ERROR) << "No active node found to assign a spec.";
+    return { 0, size };
+  }
+
   const auto& ts = TableService::singleton();
-  size_t idx = 0;
 
   // all active specs seen from active nodes in current cycle
   const auto& bm = BlockManager::init();
   const auto& emptySpecs = bm->emptySpecs();
   const auto activeSpecs = bm->activeSpecs();
 
-  // for each spec
-  // TODO(cao): should we do hash-based shuffling here to ensure a stable assignment?
-  // Round-robin is easy to break the position affinity whenever new spec is coming
-  // Or we can keep order of the specs so that any old spec is associated.
-  auto numTasks = 0;
+  // collect all specs, if a spec is assigned but somehow it's lost as we don't see it in active spec
+  // we will need to make sure it's assigned again
+  std::vector<SpecPtr> specs;
   auto tables = ts->all();
   for (auto& registry : tables) {
-    auto specs = registry->all();
-    for (auto& spec : specs) {
-      // if current spec is assigned but somehow it's lost as we don't see it in active spec
-      // we will need to make sure it's assigned again
+    auto all = registry->all();
+    for (auto& spec : all) {
       const auto& id = spec->id();
       if (spec->assigned()
           && !activeSpecs.contains(id)
@@ -218,43 +223,60 @@ std::pair<size_t, size_t> SpecRepo::assign(const ClientMaker& clientMaker) noexc
         resetSpec(spec);
       }
 
-      // if the spec is not assigned to a node yet
-      if (!spec->assigned()) {
-        auto startId = idx;
-        while (true) {
-          auto& n = nodes.at(idx);
-          if (n.isActive()) {
-            spec->affinity(n);
-            idx = (idx + 1) % size;
-            break;
-          }
+      specs.push_back(std::move(spec));
+    }
+  }
 
-          idx = (idx + 1) % size;
-          if (idx == startId) {
-            LOG(ERROR) << "No active node found to assign a spec.";
-            return { numTasks, size };
-          }
-        }
-      }
+  // place specs by a bounded-load consistent hash ring keyed by spec ID,
+  // so that a node change (restart, scaling) only moves its own share of specs rather than reshuffle all.
+  // nodes are weighted by memory capacity, a node not reporting it is treated as an average node.
+  size_t known = 0, memory = 0;
+  for (const auto& n : actives) {
+    if (n.memory > 0) {
+      ++known;
+      memory += n.memory;
+    }
+  }
 
-      // check if the spec needs to be communicated to the node
-      if (spec->needSync()) {
-        ++numTasks;
+  const auto average = known > 0 ? memory / known : 1;
+  BoundedRing<NNode> ring(
+    actives,
+    [](const NNode& n) { return n.toString(); },
+    [average](const NNode& n) { return n.memory > 0 ? n.memory : average; },
+    specs.size(),
+    FLAGS_SPEC_LOAD_BOUND);
+
+  // specs already hosted count into their nodes' load
+  for (const auto& spec : specs) {
+    if (spec->assigned()) {
+      ring.charge(spec->affinity().toString());
+    }
+  }
 
-        // get the client
-        auto client = clientMaker(spec->affinity());
-        Task t(TaskType::INGESTION, std::static_pointer_cast<Identifiable>(spec));
-        TaskState state = client->task(t);
+  auto numTasks = 0;
+  for (auto& spec : specs) {
+    // if the spec is not assigned to a node yet
+    if (!spec->assigned()) {
+      spec->affinity(*ring.attach(spec->id()));
+    }
 
-        // udpate spec state so that it won't be resent
-        if (state == TaskState::SUCCEEDED) {
-          spec->state(SpecState::READY);
-        } else if (state == TaskState::FAILED || state == TaskState::QUEUE) {
-          // TODO(cao) - post process for case if this task failed?
-          LOG(WARNING) << "Task state: " << (char)state
-                       << " at node: " << spec->affinity().toString()
-                       << " | " << t.signature();
-        }
+    // check if the spec needs to be communicated to the node
+    if (spec->needSync()) {
+      ++numTasks;
+
+      // get the client
+      auto client = clientMaker(spec->affinity());
+      Task t(TaskType::INGESTION, std::static_pointer_cast<Identifiable>(spec));
+      TaskState state = client->task(t);
+
+      // udpate spec state so that it won't be resent
+      if (state == TaskState::SUCCEEDED) {
+        spec->state(SpecState::READY);
+      } else if (state == TaskState::FAILED || state == TaskState::QUEUE) {
+        // TODO(cao) - post process for case if this task failed?
+        LOG(WARNING) << "Task state: " << (char)state
+                     << " at node: " << spec->affinity().toString()
+                     << " | " << t.signature();
       }
     }
   }
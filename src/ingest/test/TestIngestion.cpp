@@ -15,7 +15,9 @@
  */
 
 #include <common/Evidence.h>
+#include <cstdio>
 #include <fmt/format.h>
+#include <fstream>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 // TODO: https://github.com/varchar-io/nebula/issues/178
@@ -24,10 +26,15 @@
 
 #include "execution/meta/SpecProvider.h"
 #include "ingest/IngestSpec.h"
+#include "ingest/MacroRow.h"
 #include "ingest/SpecRepo.h"
+#include "memory/Batch.h"
 #include "meta/ClusterInfo.h"
 #include "meta/MetaDb.h"
 #include "meta/TableSpec.h"
+#include "storage/CsvReader.h"
+#include "storage/MappedFile.h"
+#include "type/Serde.h"
 
 namespace nebula {
 namespace ingest {
@@ -143,6 +150,84 @@ TEST(IngestTest, TestTimePatternSpecGeneration) {
     }
   }
 }
+
+TEST(IngestTest, TestBoundCsvRows) {
+  // csv columns are in a different order from the table schema
+  auto file = "/tmp/nebula.test.bound.csv";
+  constexpr auto rows = 100;
+  {
+    std::ofstream out(file);
+    out << "weight,ts,name,id\n";
+    for (auto i = 0; i < rows; ++i) {
+      out << (i * 0.5) << "," << (1600000000 + i) << ",n" << (i % 7) << "," << i << "\n";
+    }
+  }
+
+  Table table("bound",
+              nebula::type::TypeSerializer::from(
+                "ROW<_time_:bigint, id:int, name:string, weight:double, ts:bigint, dt:string>"),
+              {},
+              {});
+  const auto schema = table.schema();
+  TimeSpec ts{ TimeType::COLUMN, 0, "ts", "UNIXTIME" };
+  CsvProps csv{ true, false, "," };
+
+  // load all rows of the cursor through a macro row, bound to table schema or not
+  auto load = [&](nebula::surface::RowCursor& cursor, bool bind) {
+    auto batch = std::make_unique<nebula::memory::Batch>(table, rows);
+    MacroRow macroRow(ts, 0, { { "dt", "2020-01-01" } });
+    if (bind) {
+      macroRow.bind(schema);
+    }
+
+    while (cursor.hasNext()) {
+      const auto& row = macroRow.set(&cursor.next());
+      EXPECT_EQ(row.bound(schema), bind);
+      batch->add(row);
+    }
+
+    return batch;
+  };
+
+  auto verify = [&](const nebula::memory::Batch& expected, const nebula::memory::Batch& batch) {
+    ASSERT_EQ(batch.getRows(), rows);
+    ASSERT_EQ(expected.getRows(), rows);
+    auto e = expected.makeAccessor();
+    auto a = batch.makeAccessor();
+    for (auto i = 0; i < rows; ++i) {
+      const auto& er = e->seek(i);
+      const auto& ar = a->seek(i);
+      EXPECT_EQ(ar.readLong(Table::TIME_COLUMN), er.readLong(Table::TIME_COLUMN));
+      EXPECT_EQ(ar.readLong(Table::TIME_COLUMN), 1600000000 + i);
+      EXPECT_EQ(ar.readInt("id"), er.readInt("id"));
+      EXPECT_EQ(ar.readInt("id"), i);
+      EXPECT_EQ(ar.readString("name"), er.readString("name"));
+      EXPECT_EQ(ar.readDouble("weight"), er.readDouble("weight"));
+      EXPECT_EQ(ar.readLong("ts"), er.readLong("ts"));
+      EXPECT_EQ(ar.readString("dt"), er.readString("dt"));
+      EXPECT_EQ(ar.readString("dt"), "2020-01-01");
+    }
+  };
+
+  // name based path as the baseline
+  nebula::storage::CsvReader plain(file, csv, {});
+  auto expected = load(plain, false);
+
+  // stream reader bound to table schema
+  nebula::storage::CsvReader reader(file, csv, {});
+  reader.bind(schema);
+  verify(*expected, *load(reader, true));
+
+  // chunk reader bound to table schema
+  auto mapped = std::make_shared<nebula::storage::MappedFile>(file);
+  auto chunks = mapped->lines(1, true);
+  ASSERT_EQ(chunks.size(), 1);
+  nebula::storage::CsvChunkReader chunk(mapped, chunks.front(), csv, {});
+  chunk.bind(schema);
+  verify(*expected, *load(chunk, true));
+
+  std::remove(file);
+}
 } // namespace test
 } // namespace ingest
 } // namespace nebula
@@ -28,6 +28,30 @@ using nebula::surface::MapData;
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////// ROW Accessor ///////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+RowAccessor::RowAccessor(const Batch& batch, const nebula::type::Schema& schema)
+  : batch_{ batch }, dnMap_{ batch_.fields_ } {
+  // resolve data node of every column in the schema once rather than looking up by name per read
+  const auto size = schema->size();
+  auto columns = std::make_shared<BoundColumns>();
+  columns->nodes.reserve(size);
+  columns->partitions.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    const auto& name = schema->childType(i)->name();
+    auto found = dnMap_.find(name);
+    if (found == dnMap_.end()) {
+      columns->nodes.push_back(nullptr);
+      continue;
+    }
+
+    columns->nodes.push_back(found->second.get());
+    if (batch_.pod_ != nullptr && found->second->isPartition()) {
+      columns->partitions[i] = name;
+    }
+  }
+
+  columns_ = std::move(columns);
+}
+
 RowAccessor& RowAccessor::seek(size_t rowId) {
   // seek to row ID and return myself
   // TODO(cao) - a runtime ephemeral/transient state like this is bad for parallelism
@@ -69,6 +93,38 @@ READ_TYPE_BY_FIELD(std::string_view, readString)
 
 #undef READ_TYPE_BY_FIELD
 
+// a column not in this batch (eg. added to table after the batch built) reads as NULL
+#define READ_TYPE_BY_INDEX(TYPE, FUNC)                                               \
+  std::optional<TYPE> RowAccessor::FUNC(IndexType ordinal) const {                   \
+    auto d = columns_->nodes[ordinal];                                               \
+    if (N_UNLIKELY(d == nullptr)) {                                                  \
+      return std::nullopt;                                                           \
+    }                                                                                \
+    const auto& partition = columns_->partitions[ordinal];                           \
+    if (N_UNLIKELY(!partition.empty())) {                                            \
+      TYPE v;                                                                        \
+      if (batch_.pod_->value(partition, batch_.spaces_, bessValue_, v)) {            \
+        return v;                                                                    \
+      }                                                                              \
+    }                                                                                \
+    if (N_UNLIKELY(d->isNull(current_))) {                                           \
+      return std::nullopt;                                                           \
+    }                                                                                \
+    return d->read<TYPE>(current_);                                                  \
+  }
+
+READ_TYPE_BY_INDEX(bool, readBool)
+READ_TYPE_BY_INDEX(int8_t, readByte)
+READ_TYPE_BY_INDEX(int16_t, readShort)
+READ_TYPE_BY_INDEX(int32_t, readInt)
+READ_TYPE_BY_INDEX(int64_t, readLong)
+READ_TYPE_BY_INDEX(float, readFloat)
+READ_TYPE_BY_INDEX(double, readDouble)
+READ_TYPE_BY_INDEX(int128_t, readInt128)
+READ_TYPE_BY_INDEX(std::string_view, readString)
+
+#undef READ_TYPE_BY_INDEX
+
 // // compound types
 // // TODO(cao) - return a unique ptr seems unncessary expensive to create list accessor object every time
 // // we may want to maintain single instance and return a reference instead
@@ -18,6 +18,7 @@
 #include <numeric>
 
 DEFINE_int32(BESS_PAGE_SIZE, 1024, "page size for bess encoded data");
+DEFINE_uint32(ZONE_MAP_PAGE, 8192, "rows per page of zone maps built when a batch is sealed, 0 to disable");
 
 namespace nebula {
 namespace memory {
@@ -25,6 +26,7 @@ namespace memory {
 using nebula::meta::BessType;
 using nebula::meta::Table;
 using nebula::surface::RowData;
+using nebula::surface::eval::Selection;
 using nebula::type::Schema;
 using nebula::type::TreeBase;
 using nebula::type::TypeBase;
@@ -37,7 +39,8 @@ Batch::Batch(const Table& table, size_t capacity, size_t pid)
     bess_{ pod_ != nullptr ? (size_t)FLAGS_BESS_PAGE_SIZE : 0 },
     rows_{ 0 },
     fields_{ schema_->size() },
-    sealed_{ false } {
+    sealed_{ false },
+    pageRows_{ 0 } {
   // build a field name to data node
   for (size_t i = 0, size = schema_->size(); i < size; ++i) {
     auto f = dynamic_cast<TypeBase*>(schema_->TreeBase::childAt(i).get());
@@ -65,7 +68,8 @@ size_t Batch::add(const RowData& row, BessType bess) {
   }
 
   // read data from row data and save it to batch
-  auto result = data_->append<const RowData&>(row);
+  // a row bound to the schema of this batch is read by column ordinals rather than names
+  auto result = row.bound(schema_) ? data_->appendBound(row) : data_->append<const RowData&>(row);
 
   // record the row size
   VLOG(1) << "Total row size  = " << result;
@@ -73,9 +77,16 @@ size_t Batch::add(const RowData& row, BessType bess) {
   return rows_++;
 }
 
+size_t Batch::commit(size_t rows) {
+  N_ENSURE(!sealed_, "can not add rows into sealed batch");
+  rows_ += rows;
+  data_->commit(rows_);
+  return rows_;
+}
+
 // random access to a row - may require internal seek
-std::unique_ptr<RowAccessor> Batch::makeAccessor() const {
-  return std::make_unique<RowAccessor>(const_cast<const Batch&>(*this));
+std::unique_ptr<RowAccessor> Batch::makeAccessor(Schema schema) const {
+  return std::make_unique<RowAccessor>(const_cast<const Batch&>(*this), schema ? schema : schema_);
 }
 
 std::string Batch::state() const {
@@ -102,10 +113,71 @@ std::string Batch::state() const {
                      data_->rawSize(), std::get<1>(s), std::get<0>(s), rows_, bess_.size());
 }
 
+// partition column values are encoded in bess per row, leave them to row accessor
+#define VECTOR_READ(TYPE)                                                                               \
+  bool Batch::read(const std::string& col, const Selection& selection, TYPE* values, bool* nulls) const { \
+    auto itr = fields_.find(col);                                                                       \
+    if (itr == fields_.end()                                                                            \
+        || itr->second->isPartition()                                                                   \
+        || itr->second->kind() != nebula::type::TypeDetect<TYPE>::kind) {                               \
+      return false;                                                                                     \
+    }                                                                                                   \
+    itr->second->read<TYPE>(selection.data(), selection.size(), values, nulls);                        \
+    return true;                                                                                        \
+  }
+
+VECTOR_READ(bool)
+VECTOR_READ(int8_t)
+VECTOR_READ(int16_t)
+VECTOR_READ(int32_t)
+VECTOR_READ(int64_t)
+VECTOR_READ(float)
+VECTOR_READ(double)
+VECTOR_READ(int128_t)
+VECTOR_READ(std::string_view)
+
+#undef VECTOR_READ
+
+// dictionary is only exposed once sealed, it keeps growing while building.
+size_t Batch::dictSize(const std::string& col) const {
+  auto itr = fields_.find(col);
+  if (!sealed_ || itr == fields_.end() || itr->second->isPartition() || !itr->second->coded()) {
+    return 0;
+  }
+
+  return itr->second->dictSize();
+}
+
+std::string_view Batch::dictItem(const std::string& col, int32_t code) const {
+  return fields_.at(col)->dictItem(code);
+}
+
+bool Batch::codes(const std::string& col, const Selection& selection, int32_t* codes, bool* nulls) const {
+  if (dictSize(col) == 0) {
+    return false;
+  }
+
+  fields_.at(col)->codes(selection.data(), selection.size(), codes, nulls);
+  return true;
+}
+
+std::function<int32_t(size_t)> Batch::coder(const std::string& col) const {
+  if (dictSize(col) == 0) {
+    return {};
+  }
+
+  return [node = fields_.at(col)](size_t row) -> int32_t {
+    return node->code(row);
+  };
+}
+
 void Batch::seal() {
   N_ENSURE(!sealed_, "batch is already sealed.");
   sealed_ = true;
 
+  // build zone maps on raw data before encoding
+  buildZones();
+
   // seal every node
   data_->seal();
 
@@ -116,5 +188,88 @@ void Batch::seal() {
   }
 }
 
+// zone maps: min/max/count of every page for every scalar column,
+// they are histograms so that block evaluation works on a page as is.
+void Batch::buildZones() {
+  const size_t pageRows = FLAGS_ZONE_MAP_PAGE;
+  if (pageRows == 0 || rows_ <= pageRows) {
+    return;
+  }
+
+  pageRows_ = pageRows;
+  const auto pages = numPages();
+  pageNulls_.assign(pages, false);
+
+  Selection selection(pageRows);
+  auto nulls = std::make_unique<bool[]>(pageRows);
+
+  // only numbers have min/max histograms
+  const auto build = [&](const std::string& name, auto& node, auto* values, auto zero) {
+    using T = decltype(zero);
+    using W = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>;
+    auto& zones = zones_[name];
+    zones.reserve(pages);
+    for (size_t p = 0; p < pages; ++p) {
+      const auto begin = p * pageRows;
+      const auto size = std::min(pageRows, rows_ - begin);
+      std::iota(selection.begin(), selection.begin() + size, (uint32_t)begin);
+      node->template read<T>(selection.data(), size, values, nulls.get());
+
+      auto hist = std::make_shared<nebula::surface::eval::NumberHistogram<W>>(name);
+      for (size_t i = 0; i < size; ++i) {
+        if (nulls[i]) {
+          pageNulls_[p] = true;
+          continue;
+        }
+
+        const W v = values[i];
+        hist->count++;
+        hist->v_min = std::min(hist->v_min, v);
+        hist->v_max = std::max(hist->v_max, v);
+        hist->v_sum += v;
+      }
+
+      zones.push_back(hist);
+    }
+  };
+
+#define BUILD_ZONES(KIND)                                                \
+  case nebula::type::Kind::KIND: {                                       \
+    using T = nebula::type::TypeTraits<nebula::type::Kind::KIND>::CppType; \
+    auto values = std::make_unique<T[]>(pageRows);                       \
+    build(name, node, values.get(), T{});                                \
+    break;                                                               \
+  }
+
+  for (auto& field : fields_) {
+    const auto& name = field.first;
+    auto& node = field.second;
+    if (node->isPartition()) {
+      continue;
+    }
+
+    switch (node->kind()) {
+      BUILD_ZONES(TINYINT)
+      BUILD_ZONES(SMALLINT)
+      BUILD_ZONES(INTEGER)
+      BUILD_ZONES(BIGINT)
+      BUILD_ZONES(REAL)
+      BUILD_ZONES(DOUBLE)
+    default: break;
+    }
+  }
+
+#undef BUILD_ZONES
+}
+
+std::shared_ptr<nebula::surface::eval::Histogram> Batch::histogram(const std::string& col, size_t page) const {
+  auto itr = zones_.find(col);
+  if (itr == zones_.end()) {
+    return histogram(col);
+  }
+
+  return itr->second.at(page);
+}
+
 } // namespace memory
 } // namespace nebula
\ No newline at end of file
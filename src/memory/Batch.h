@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <shared_mutex>
 #include <string_view>
 
 #include "DataNode.h"
@@ -37,7 +38,7 @@ namespace memory {
 using DnMap = nebula::common::unordered_map<std::string, PDataNode>;
 
 class RowAccessor;
-class Batch : public nebula::surface::eval::Block {
+class Batch : public nebula::surface::eval::Block, public nebula::surface::eval::Columnar {
 public: // read row from and write row to
   Batch(const nebula::meta::Table&, size_t capacity, size_t pid = 0);
   virtual ~Batch() = default;
@@ -45,8 +46,27 @@ public: // read row from and write row to
   // add a row into current batch
   size_t add(const nebula::surface::RowData& row, nebula::meta::BessType bess = 0);
 
+  // columnar appending: append values of a column for the next rows in bulk,
+  // rows are visible after commit, columns not appended for these rows are filled with nulls.
+  // not supported by partitioned batch since bess is computed from a row.
+  template <typename T>
+  void append(const std::string& col, const T* values, const bool* nulls, size_t size) {
+    N_ENSURE(!sealed_, "can not add rows into sealed batch");
+    N_ENSURE(pod_ == nullptr, "columnar appending is not supported in partitioned batch");
+    fields_.at(col)->append<T>(values, nulls, size);
+  }
+
+  // commit rows appended by column and return number of rows in current batch
+  size_t commit(size_t rows);
+
+  // check if a column is stored in current batch
+  inline bool has(const std::string& col) const {
+    return fields_.find(col) != fields_.end();
+  }
+
   // random access to a row - may require internal seek
-  std::unique_ptr<RowAccessor> makeAccessor() const;
+  // reads by index are served in ordinals of given schema (schema of this batch if not given)
+  std::unique_ptr<RowAccessor> makeAccessor(nebula::type::Schema = nullptr) const;
 
 public: /* implement interface of Block.h */
   inline nebula::type::Schema schema() const override {
@@ -118,6 +138,30 @@ public: /* implement interface of Block.h */
 #undef DISPATCH_KIND
   }
 
+public: /* implement interface of Columnar.h */
+#define VECTOR_READ(TYPE) \
+  bool read(const std::string&, const nebula::surface::eval::Selection&, TYPE*, bool*) const override;
+
+  VECTOR_READ(bool)
+  VECTOR_READ(int8_t)
+  VECTOR_READ(int16_t)
+  VECTOR_READ(int32_t)
+  VECTOR_READ(int64_t)
+  VECTOR_READ(float)
+  VECTOR_READ(double)
+  VECTOR_READ(int128_t)
+  VECTOR_READ(std::string_view)
+
+#undef VECTOR_READ
+
+  size_t dictSize(const std::string&) const override;
+  std::string_view dictItem(const std::string&, int32_t) const override;
+  bool codes(const std::string&, const nebula::surface::eval::Selection&, int32_t*, bool*) const override;
+
+  // code reader of a dictionary encoded column by row id, -1 for null,
+  // empty if the column is not served by dictionary codes.
+  std::function<int32_t(size_t)> coder(const std::string&) const;
+
 public:
   inline size_t getMemory() const {
     return data_->storageAllocation();
@@ -138,6 +182,39 @@ public:
   // This helps release some necessary memory used in batch building
   void seal();
 
+  // A batch can be read while it is still being built by a single writer (eg. live tail of a stream).
+  // Buffers move when they grow, so writer appends rows or seals under the exclusive lock,
+  // and readers pin the batch to see a consistent snapshot of rows added so far.
+  inline std::unique_lock<std::shared_mutex> lock() {
+    return std::unique_lock<std::shared_mutex>(live_);
+  }
+
+  inline std::shared_lock<std::shared_mutex> pin() const {
+    return std::shared_lock<std::shared_mutex>(live_);
+  }
+
+  inline bool sealed() const {
+    return sealed_;
+  }
+
+  // zone maps: number of rows per page, 0 if no zone maps built
+  inline size_t pageRows() const {
+    return pageRows_;
+  }
+
+  // number of pages covered by zone maps
+  inline size_t numPages() const {
+    return pageRows_ == 0 ? 0 : (rows_ + pageRows_ - 1) / pageRows_;
+  }
+
+  // histogram of a column in given page, block level histogram if the column has no zone map
+  std::shared_ptr<nebula::surface::eval::Histogram> histogram(const std::string&, size_t) const;
+
+  // no nulls in given page for all columns with zone map
+  inline bool dense(size_t page) const {
+    return !pageNulls_.at(page);
+  }
+
   // a bloom filter tester
   template <typename T>
   inline bool probably(const std::string& col, const T& value) const {
@@ -175,14 +252,73 @@ private:
   DnMap fields_;
 
   bool sealed_;
+  mutable std::shared_mutex live_;
+
+  // zone maps built at seal: column -> histogram of every page
+  size_t pageRows_;
+  nebula::common::unordered_map<std::string, std::vector<std::shared_ptr<nebula::surface::eval::Histogram>>> zones_;
+  std::vector<bool> pageNulls_;
+
+private:
+  void buildZones();
+};
+
+// A page of a batch presented as a block,
+// so that block level evaluation of a filter applies to every page through zone maps.
+class PageBlock : public nebula::surface::eval::Block {
+public:
+  PageBlock(const Batch& batch, size_t page) : batch_{ batch }, page_{ page } {}
+  virtual ~PageBlock() = default;
+
+  inline nebula::type::Schema schema() const override {
+    return batch_.schema();
+  }
+
+  inline size_t getRows() const override {
+    const auto begin = page_ * batch_.pageRows();
+    return std::min(batch_.getRows() - begin, batch_.pageRows());
+  }
+
+  nebula::type::TypeNode columnType(const std::string& col) const override {
+    return batch_.columnType(col);
+  }
+
+  std::shared_ptr<nebula::surface::eval::Histogram> histogram(const std::string& col) const override {
+    return batch_.histogram(col, page_);
+  }
+
+  std::vector<std::any> partitionValues(const std::string& col) const override {
+    return batch_.partitionValues(col);
+  }
+
+  // no bloom filter per page, a value not in the block is not in the page either
+  bool probably(const std::string& col, std::any v) const override {
+    return batch_.probably(col, v);
+  }
+
+private:
+  const Batch& batch_;
+  const size_t page_;
 };
 
 using BatchPtr = std::shared_ptr<Batch>;
 using EvaledBlock = std::pair<BatchPtr, nebula::surface::eval::BlockEval>;
 
+// data nodes of columns of a schema resolved in a batch, shared by all accessors copied from one
+struct BoundColumns {
+  // data node of every column ordinal in bound schema, nullptr if the batch doesn't have it
+  std::vector<DataNode*> nodes;
+  // names of partition columns which are read from bess value, empty for others
+  std::vector<std::string> partitions;
+};
+
 class RowAccessor : public nebula::surface::Accessor {
+  using IndexType = nebula::surface::IndexType;
+
 public:
-  RowAccessor(const Batch& batch) : batch_{ batch }, dnMap_{ batch_.fields_ } {}
+  RowAccessor(const Batch&, const nebula::type::Schema&);
+  // a copy shares bound columns, it's cheap to have one accessor per row
+  RowAccessor(const RowAccessor&) = default;
   virtual ~RowAccessor() = default;
 
 public:
@@ -196,6 +332,16 @@ public:
   std::optional<int128_t> readInt128(const std::string& field) const override;
   std::optional<std::string_view> readString(const std::string& field) const override;
 
+  std::optional<bool> readBool(IndexType) const override;
+  std::optional<int8_t> readByte(IndexType) const override;
+  std::optional<int16_t> readShort(IndexType) const override;
+  std::optional<int32_t> readInt(IndexType) const override;
+  std::optional<int64_t> readLong(IndexType) const override;
+  std::optional<float> readFloat(IndexType) const override;
+  std::optional<double> readDouble(IndexType) const override;
+  std::optional<int128_t> readInt128(IndexType) const override;
+  std::optional<std::string_view> readString(IndexType) const override;
+
 public:
   RowAccessor& seek(size_t);
 
@@ -204,6 +350,8 @@ private:
   const DnMap& dnMap_;
   size_t current_;
   nebula::meta::BessType bessValue_;
+
+  std::shared_ptr<const BoundColumns> columns_;
 };
 
 class ListAccessor : public nebula::surface::ListData {
@@ -16,6 +16,8 @@
 
 #include "DataNode.h"
 
+#include <array>
+
 #include "common/Hash.h"
 #include "common/Likely.h"
 #include "type/Type.h"
@@ -135,6 +137,115 @@ size_t DataNode::append(std::string_view str) {
   INCREMENT_RAW_SIZE_AND_RETURN()
 }
 
+#define APPEND_BULK_VALUES(K, N)                                                    \
+  template <>                                                                       \
+  size_t DataNode::append(const nebula::type::TypeTraits<Kind::K>::CppType* values, \
+                          const bool* nulls,                                        \
+                          size_t size) {                                            \
+    N_ENSURE(type_.k() == Kind::K, #N "type expected");                             \
+    constexpr size_t width = nebula::type::Type<Kind::K>::width;                    \
+    data_->add(count_, values, nulls, size);                                        \
+    size_t raw = 0;                                                                 \
+    for (size_t i = 0; i < size; ++i) {                                             \
+      const auto index = cursorAndAdvance();                                        \
+      if (nulls != nullptr && nulls[i]) {                                           \
+        meta_->setNull(index);                                                      \
+        raw += NULL_SIZE;                                                           \
+        continue;                                                                   \
+      }                                                                             \
+                                                                                    \
+      meta_->histogram(values[i]);                                                  \
+      raw += width;                                                                 \
+    }                                                                               \
+    rawSize_ += raw;                                                                \
+    return raw;                                                                     \
+  }
+
+APPEND_BULK_VALUES(BOOLEAN, bool)
+APPEND_BULK_VALUES(TINYINT, byte)
+APPEND_BULK_VALUES(SMALLINT, short)
+APPEND_BULK_VALUES(INTEGER, int)
+APPEND_BULK_VALUES(BIGINT, long)
+APPEND_BULK_VALUES(REAL, float)
+APPEND_BULK_VALUES(DOUBLE, double)
+APPEND_BULK_VALUES(INT128, int128)
+
+#undef APPEND_BULK_VALUES
+
+template <>
+size_t DataNode::append(const std::string_view* values, const bool* nulls, size_t size) {
+  N_ENSURE(type_.k() == nebula::type::StringType::kind, "string type expected");
+  if (!meta_->hasDict()) {
+    size_t raw = 0;
+    for (size_t i = 0; i < size; ++i) {
+      raw += (nulls != nullptr && nulls[i]) ? appendNull() : append(values[i]);
+    }
+
+    return raw;
+  }
+
+  // values decoded from a dictionary page point to the same memory for the same item,
+  // so dictionary index is cached by value address to skip hashing repeated items.
+  // this is safe since all values are alive and unchanged in a single call.
+  struct Slot {
+    const char* data;
+    size_t size;
+    int32_t index;
+  };
+  static constexpr size_t SLOTS = 64;
+  std::array<Slot, SLOTS> cache{};
+
+  size_t raw = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (nulls != nullptr && nulls[i]) {
+      raw += appendNull();
+      continue;
+    }
+
+    const auto& str = values[i];
+    const auto index = cursorAndAdvance();
+    meta_->histogram(str);
+
+    auto& slot = cache[(reinterpret_cast<uintptr_t>(str.data()) >> 3) % SLOTS];
+    if (slot.data != str.data() || slot.size != str.size() || slot.data == nullptr) {
+      slot = { str.data(), str.size(), meta_->dictItem(str) };
+    }
+
+    meta_->setOffsetSize(index, slot.index);
+    rawSize_ += str.size();
+    raw += str.size();
+  }
+
+  return raw;
+}
+
+size_t DataNode::commit(size_t entries) {
+  N_ENSURE(type_.k() == Kind::STRUCT, "struct type expected");
+
+  // fill nulls for columns not appended and accumulate raw size of all children
+  size_t raw = 0;
+  for (size_t i = 0, count = this->size(); i < count; ++i) {
+    const auto& child = this->childAt<PDataNode>(i).value();
+    if (!child->meta_->isPartition()) {
+      N_ENSURE_LE(child->count_, entries, "column has more values than rows");
+      while (child->count_ < entries) {
+        child->appendNull();
+      }
+    }
+
+    raw += child->rawSize_;
+  }
+
+  // histogram recording for every new row
+  for (auto rows = meta_->histogram()->count; rows < entries; ++rows) {
+    meta_->histogram(nullptr);
+  }
+
+  const auto size = raw - rawSize_;
+  rawSize_ = raw;
+  return size;
+}
+
 #define DISPATCH_KIND(KIND, lambda, object, func)                          \
   case Kind::KIND: {                                                       \
     lambda = [&object, &list](auto i) { return object->append(func(i)); }; \
@@ -219,8 +330,8 @@ size_t DataNode::append(const nebula::surface::MapData& map) {
     break;                                       \
   }
 
-template <>
-size_t DataNode::append(const nebula::surface::RowData& row) {
+template <bool BOUND>
+size_t DataNode::appendRow(const nebula::surface::RowData& row) {
   // TODO(cao): NULL row is not supported.
   // Need to modify if we want to support row/struct column type in the future
   N_ENSURE(type_.k() == Kind::STRUCT, "struct type expected");
@@ -232,29 +343,38 @@ size_t DataNode::append(const nebula::surface::RowData& row) {
     const auto kind = child->type_.k();
     const auto& name = child->type_.name();
 
+    // a bound row reads the field by its ordinal
+    const auto& field = [&]() -> decltype(auto) {
+      if constexpr (BOUND) {
+        return i;
+      } else {
+        return name;
+      }
+    }();
+
     // null field
-    if (row.isNull(name)) {
+    if (row.isNull(field)) {
       size += child->appendNull();
       continue;
     }
 
     switch (kind) {
-      DISPATCH_KIND(size, BOOLEAN, child, row.readBool(name))
-      DISPATCH_KIND(size, TINYINT, child, row.readByte(name))
-      DISPATCH_KIND(size, SMALLINT, child, row.readShort(name))
-      DISPATCH_KIND(size, INTEGER, child, row.readInt(name))
-      DISPATCH_KIND(size, BIGINT, child, row.readLong(name))
-      DISPATCH_KIND(size, REAL, child, row.readFloat(name))
-      DISPATCH_KIND(size, DOUBLE, child, row.readDouble(name))
-      DISPATCH_KIND(size, INT128, child, row.readInt128(name))
-      DISPATCH_KIND(size, VARCHAR, child, row.readString(name))
+      DISPATCH_KIND(size, BOOLEAN, child, row.readBool(field))
+      DISPATCH_KIND(size, TINYINT, child, row.readByte(field))
+      DISPATCH_KIND(size, SMALLINT, child, row.readShort(field))
+      DISPATCH_KIND(size, INTEGER, child, row.readInt(field))
+      DISPATCH_KIND(size, BIGINT, child, row.readLong(field))
+      DISPATCH_KIND(size, REAL, child, row.readFloat(field))
+      DISPATCH_KIND(size, DOUBLE, child, row.readDouble(field))
+      DISPATCH_KIND(size, INT128, child, row.readInt128(field))
+      DISPATCH_KIND(size, VARCHAR, child, row.readString(field))
     case Kind::ARRAY: {
-      auto list = row.readList(name);
+      auto list = row.readList(field);
       size += child->append<const ListData&>(*list);
       break;
     }
     case Kind::MAP: {
-      auto map = row.readMap(name);
+      auto map = row.readMap(field);
       size += child->append<const MapData&>(*map);
       break;
     }
@@ -270,6 +390,15 @@ size_t DataNode::append(const nebula::surface::RowData& row) {
   INCREMENT_RAW_SIZE_AND_RETURN()
 }
 
+template <>
+size_t DataNode::append(const nebula::surface::RowData& row) {
+  return appendRow<false>(row);
+}
+
+size_t DataNode::appendBound(const nebula::surface::RowData& row) {
+  return appendRow<true>(row);
+}
+
 #undef DISPATCH_KIND
 
 #undef INCREMENT_RAW_SIZE_AND_RETURN
@@ -319,5 +448,48 @@ std::string_view DataNode::read(size_t index) {
 
 #undef TYPE_READ_DELEGATE
 
+// fill nulls for every row, and patch values with default value for real nulls
+// data stream has void values for all nulls, so bulk read can be done without holes
+#define TYPE_BULK_READ_DELEGATE(TYPE)                                                  \
+  template <>                                                                          \
+  void DataNode::read(const uint32_t* rows, size_t size, TYPE* values, bool* nulls) { \
+    data_->read<TYPE>(rows, size, values);                                             \
+    const auto hasDefault = meta_->hasDefault();                                       \
+    for (size_t i = 0; i < size; ++i) {                                                \
+      nulls[i] = meta_->isNull(rows[i]);                                               \
+      if (N_UNLIKELY(hasDefault && meta_->isRealNull(rows[i]))) {                      \
+        values[i] = data_->defaultValue<TYPE>();                                       \
+      }                                                                                \
+    }                                                                                  \
+  }
+
+TYPE_BULK_READ_DELEGATE(bool)
+TYPE_BULK_READ_DELEGATE(int8_t)
+TYPE_BULK_READ_DELEGATE(int16_t)
+TYPE_BULK_READ_DELEGATE(int32_t)
+TYPE_BULK_READ_DELEGATE(int64_t)
+TYPE_BULK_READ_DELEGATE(float)
+TYPE_BULK_READ_DELEGATE(double)
+TYPE_BULK_READ_DELEGATE(int128_t)
+
+#undef TYPE_BULK_READ_DELEGATE
+
+template <>
+void DataNode::read(const uint32_t* rows, size_t size, std::string_view* values, bool* nulls) {
+  for (size_t i = 0; i < size; ++i) {
+    nulls[i] = meta_->isNull(rows[i]);
+    values[i] = read<std::string_view>(rows[i]);
+  }
+}
+
+void DataNode::codes(const uint32_t* rows, size_t size, int32_t* codes, bool* nulls) {
+  N_ENSURE(coded(), "dictionary codes expected");
+  for (size_t i = 0; i < size; ++i) {
+    // null entries have no offset recorded
+    nulls[i] = meta_->isNull(rows[i]);
+    codes[i] = nulls[i] ? 0 : meta_->offsetSize(rows[i]).second;
+  }
+}
+
 } // namespace memory
 } // namespace nebula
\ No newline at end of file
@@ -79,6 +79,19 @@ public: // data appending API
   template <typename T>
   size_t append(T v);
 
+  // bulk append values of next entries, nulls[i] is set if value i is null (nulls can be nullptr).
+  // values of null entries are expected to be void value.
+  template <typename T>
+  size_t append(const T* values, const bool* nulls, size_t size);
+
+  // close entries of a struct node whose children are appended by column,
+  // children having less values are filled with nulls.
+  size_t commit(size_t entries);
+
+  // append a row to a struct node by reading its fields through column ordinals,
+  // caller ensures the row is bound to the same schema of this node.
+  size_t appendBound(const nebula::surface::RowData&);
+
 public: // data reading API
   // use std::optional to simplify the interface
   // instead of
@@ -94,6 +107,40 @@ public: // data reading API
   template <typename T>
   T read(size_t index);
 
+  // bulk read values of given rows, nulls[i] is set if the value is null
+  template <typename T>
+  void read(const uint32_t* rows, size_t size, T* values, bool* nulls);
+
+  inline bool isPartition() const {
+    return meta_->isPartition();
+  }
+
+  inline nebula::type::Kind kind() const {
+    return type_.k();
+  }
+
+  // values are served by dictionary codes,
+  // not for a node with default value since its nulls read as the default value.
+  inline bool coded() const {
+    return meta_->hasDict() && !meta_->hasDefault();
+  }
+
+  inline size_t dictSize() const {
+    return meta_->dictSize();
+  }
+
+  inline std::string_view dictItem(int32_t code) const {
+    return meta_->dictItem(code);
+  }
+
+  // dictionary code of given entry, -1 if it is null
+  inline int32_t code(size_t index) {
+    return meta_->isNull(index) ? -1 : meta_->offsetSize(index).second;
+  }
+
+  // bulk read dictionary codes of given rows, nulls[i] is set if the value is null
+  void codes(const uint32_t* rows, size_t size, int32_t* codes, bool* nulls);
+
   template <typename T>
   inline bool probably(const T& v) const {
     return data_->probably(v);
@@ -163,6 +210,10 @@ private:
     return count_++;
   }
 
+  // append a row to a struct node, fields are read by ordinals if bound, otherwise by names
+  template <bool BOUND>
+  size_t appendRow(const nebula::surface::RowData&);
+
 private:
   // pointing to a node in the schema tree which is supposed to be shared.
   // should we make a copy here to be safe?
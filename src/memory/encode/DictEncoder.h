@@ -89,6 +89,11 @@ public:
     return dict_.read(offset, offset2 - offset);
   }
 
+  // number of items in dictionary
+  inline size_t size() const {
+    return items_;
+  }
+
   void seal() {
     // release the assitant data structure
     hashItems_ = nullptr;
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IntCodec.h"
+#include <algorithm>
+#include <atomic>
+#include <gflags/gflags.h>
+#include <limits>
+#include <unordered_map>
+#include "RleDecoder.h"
+#include "RleEncoder.h"
+
+DEFINE_bool(SEAL_ENCODING, true, "encode integer columns (bit packing or RLE) when a block is sealed");
+
+namespace nebula {
+namespace memory {
+namespace encode {
+
+using nebula::common::ExtendableSlice;
+
+namespace {
+// every encoded stream gets an unique id, slice address may be reused after release
+std::atomic<size_t> NEXT_ID{ 1 };
+
+// max number of streams with a decoded page cached per thread, a scan over multiple RLE columns of a block
+// reads them row by row interleaved, each column needs its own entry to avoid decoding a page per value.
+// the least recently used stream is evicted when all entries are taken.
+constexpr size_t PAGE_SLOTS = 256;
+constexpr size_t NO_PAGE = std::numeric_limits<size_t>::max();
+
+struct PageCache {
+  size_t page = NO_PAGE;
+  size_t used = 0;
+  std::vector<int64_t> values = std::vector<int64_t>(IntCodec::RLE_PAGE);
+};
+} // namespace
+
+template <typename T>
+size_t IntCodec::encode(ExtendableSlice& slice, size_t count) {
+  const auto raw = count * sizeof(T);
+  encoding_ = IntEncoding::RAW;
+  count_ = count;
+  if (!FLAGS_SEAL_ENCODING || count == 0) {
+    slice.seal(raw);
+    return raw;
+  }
+
+  // frame of reference on value range
+  int64_t min = slice.read<T>(0);
+  int64_t max = min;
+  for (size_t i = 1; i < count; ++i) {
+    const int64_t v = slice.read<T>(i * sizeof(T));
+    min = std::min(min, v);
+    max = std::max(max, v);
+  }
+
+  const auto range = (uint64_t)max - (uint64_t)min;
+  const uint32_t bits = range == 0 ? 0 : 64 - __builtin_clzll(range);
+
+  // padding one word so that reading last value never goes beyond the buffer
+  auto best = raw;
+  if (bits <= MAX_BITS) {
+    const auto packed = ((count * bits + 7) >> 3) + sizeof(uint64_t);
+    if (packed < best) {
+      best = packed;
+      encoding_ = IntEncoding::BITPACK;
+    }
+  }
+
+  // RLE pages, give up as soon as it can not beat current best
+  ExtendableSlice rle(std::max<size_t>(best, 1024));
+  std::vector<size_t> pages;
+  pages.reserve(count / RLE_PAGE + 1);
+  {
+    RleEncoder encoder(true, rle);
+    size_t i = 0;
+    while (i < count) {
+      pages.push_back(encoder.position());
+      const auto end = std::min(count, i + RLE_PAGE);
+      for (; i < end; ++i) {
+        encoder.write(slice.read<T>(i * sizeof(T)));
+      }
+
+      encoder.flush();
+      if (encoder.position() >= best) {
+        break;
+      }
+    }
+
+    if (i == count && encoder.position() < best) {
+      best = encoder.position();
+      encoding_ = IntEncoding::RLE;
+    }
+  }
+
+  if (encoding_ == IntEncoding::BITPACK) {
+    base_ = min;
+    bits_ = bits;
+    mask_ = bits == 0 ? 0 : (~0ULL >> (64 - bits));
+    std::vector<NByte> buffer(best, 0);
+    for (size_t i = 0; i < count; ++i) {
+      const auto pos = i * bits;
+      const auto delta = (uint64_t)(int64_t)slice.read<T>(i * sizeof(T)) - (uint64_t)min;
+      uint64_t word;
+      std::memcpy(&word, buffer.data() + (pos >> 3), sizeof(word));
+      word |= delta << (pos & 7);
+      std::memcpy(buffer.data() + (pos >> 3), &word, sizeof(word));
+    }
+
+    slice.write(0, buffer.data(), best);
+  } else if (encoding_ == IntEncoding::RLE) {
+    pages_ = std::move(pages);
+    id_ = NEXT_ID.fetch_add(1, std::memory_order_relaxed);
+    slice.write(0, rle.ptr(), best);
+  }
+
+  slice.seal(best);
+  return best;
+}
+
+const int64_t* IntCodec::page(const ExtendableSlice& slice, size_t page) const {
+  // keyed by the exact stream id, so streams never share an entry however many are read together
+  static thread_local std::unordered_map<size_t, PageCache> caches;
+  static thread_local size_t tick = 0;
+  auto it = caches.find(id_);
+  if (it == caches.end()) {
+    if (caches.size() < PAGE_SLOTS) {
+      it = caches.emplace(id_, PageCache{}).first;
+    } else {
+      // reuse the page buffer of the least recently used stream
+      auto lru = std::min_element(caches.begin(), caches.end(), [](const auto& a, const auto& b) {
+        return a.second.used < b.second.used;
+      });
+      auto node = caches.extract(lru);
+      node.key() = id_;
+      node.mapped().page = NO_PAGE;
+      it = caches.insert(std::move(node)).position;
+    }
+  }
+
+  auto& cache = it->second;
+  cache.used = ++tick;
+  if (cache.page != page) {
+    RleDecoder decoder(true, slice, pages_.at(page));
+    decoder.next(cache.values.data(), std::min(RLE_PAGE, count_ - page * RLE_PAGE));
+    cache.page = page;
+  }
+
+  return cache.values.data();
+}
+
+template size_t IntCodec::encode<int8_t>(ExtendableSlice&, size_t);
+template size_t IntCodec::encode<int16_t>(ExtendableSlice&, size_t);
+template size_t IntCodec::encode<int32_t>(ExtendableSlice&, size_t);
+template size_t IntCodec::encode<int64_t>(ExtendableSlice&, size_t);
+
+} // namespace encode
+} // namespace memory
+} // namespace nebula
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "common/Memory.h"
+
+namespace nebula {
+namespace memory {
+namespace encode {
+
+// encoding of a sealed integer column stream
+enum class IntEncoding : int8_t {
+  // plain values stored at type width
+  RAW = 0,
+  // frame of reference: (value - base) packed in fixed number of bits
+  BITPACK = 1,
+  // RLEv2 (short repeat, direct, patched base, delta) in pages of RLE_PAGE values
+  RLE = 2
+};
+
+/**
+ * Pick the most compact encoding for a sealed integer stream and serve reads from it.
+ * BITPACK supports O(1) random access,
+ * RLE decodes a whole page on first access and caches it per thread keyed by the stream,
+ * so sequential scan decodes every page only once even when multiple columns are read row by row.
+ */
+class IntCodec {
+public:
+  // number of values per RLE page, also the granularity of random access
+  static constexpr size_t RLE_PAGE = 1024;
+
+  // max bits supported by BITPACK so that one unaligned 8 bytes read covers a value
+  static constexpr size_t MAX_BITS = 57;
+
+  IntCodec() : encoding_{ IntEncoding::RAW }, count_{ 0 }, base_{ 0 }, bits_{ 0 }, mask_{ 0 }, id_{ 0 } {}
+  virtual ~IntCodec() = default;
+
+public:
+  // encode <count> values of type T stored raw in the slice,
+  // the slice is rewritten and sealed with encoded bytes if any encoding wins over RAW.
+  // return number of bytes the slice holds after encoding.
+  template <typename T>
+  size_t encode(nebula::common::ExtendableSlice&, size_t count);
+
+  inline IntEncoding encoding() const {
+    return encoding_;
+  }
+
+  // read value at given index from an encoded slice
+  inline int64_t read(const nebula::common::ExtendableSlice& slice, size_t index) const {
+    if (encoding_ == IntEncoding::BITPACK) {
+      const auto pos = index * bits_;
+      uint64_t word;
+      std::memcpy(&word, slice.ptr() + (pos >> 3), sizeof(word));
+      return (int64_t)((uint64_t)base_ + ((word >> (pos & 7)) & mask_));
+    }
+
+    return page(slice, index / RLE_PAGE)[index % RLE_PAGE];
+  }
+
+private:
+  // decode the page through thread local page cache
+  const int64_t* page(const nebula::common::ExtendableSlice&, size_t) const;
+
+private:
+  IntEncoding encoding_;
+  size_t count_;
+
+  // BITPACK: base value and bits per value
+  int64_t base_;
+  uint32_t bits_;
+  uint64_t mask_;
+
+  // RLE: start byte offset of each page
+  std::vector<size_t> pages_;
+  // unique id to identify this stream in page cache
+  size_t id_;
+};
+
+} // namespace encode
+} // namespace memory
+} // namespace nebula
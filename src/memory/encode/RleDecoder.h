@@ -32,10 +32,11 @@ static constexpr auto UNPACK_MAX = 256;
 // https://github.com/apache/orc/blob/master/c%2B%2B/src/RleDecoderV2.cc
 class RleDecoder {
 public:
-  RleDecoder(bool isSigned, nebula::common::ExtendableSlice& buffer)
+  // offset: byte position in buffer where the encoded stream starts
+  RleDecoder(bool isSigned, const nebula::common::ExtendableSlice& buffer, uint64_t offset = 0)
     : isSigned_{ isSigned },
       buffer_{ buffer },
-      cursor_(0),
+      cursor_(offset),
       firstByte_(0),
       runLength_(0),
       runRead_(0),
@@ -91,7 +92,7 @@ private:
 private:
   // basic input data to decode
   bool isSigned_;
-  nebula::common::ExtendableSlice& buffer_;
+  const nebula::common::ExtendableSlice& buffer_;
   uint64_t cursor_;
 
   // decoding state
@@ -70,6 +70,11 @@ public:
   // encode 8 bytes in
   void write(int64_t);
 
+  // number of bytes written to the buffer so far
+  inline size_t position() const {
+    return bufferPos_;
+  }
+
 private:
   void determineEncoding(EncodingOption& option);
   void computeZigZagLiterals(EncodingOption& option);
@@ -17,9 +17,12 @@
 #include "FlatBuffer.h"
 
 #include <gflags/gflags.h>
+#include <lz4.h>
+
 DEFINE_uint64(FB_MAIN_PAGE, 1024 * 1024, "Main memory page size");
 DEFINE_uint64(FB_DATA_PAGE, 4096 * 1024, "Data memory page size");
 DEFINE_uint64(FB_LIST_PAGE, 2048 * 1024, "List memory page size");
+DEFINE_uint64(SKETCH_LZ4_BYTES, 4096, "Compress serialized sketch with LZ4 if its size is not less than this, 0 to disable");
 
 namespace nebula {
 namespace memory {
@@ -30,6 +33,8 @@ using Range = nebula::common::PRange;
 using nebula::common::vector_reserve;
 using nebula::surface::ListData;
 using nebula::surface::RowData;
+using nebula::surface::eval::Reduce;
+using nebula::surface::eval::Reducer;
 using nebula::type::Kind;
 using nebula::type::ListType;
 using nebula::type::TypeNode;
@@ -40,6 +45,7 @@ void FlatBuffer::initSchema() noexcept {
   vector_reserve(cops_, numColumns_, "FlatBuffer::initSchema");
 
   // initialize keys and values
+  binary_ = true;
   for (size_t i = 0; i < numColumns_; ++i) {
     // if current column is aggregate column
     auto ia = fields_.at(i)->isAggregate();
@@ -51,12 +57,25 @@ void FlatBuffer::initSchema() noexcept {
     auto width = widthInMain(kind);
 
     // for aggregated columns we reserve space even it's null
+    // fixed width aggregation keeps its state inline which may be wider than the input value
+    auto reduce = Reduce::NONE;
     if (ia) {
       width = std::max(width, MAX_ALIGNMENT);
+      const auto inlineWidth = widthInline(*fields_.at(i));
+      if (inlineWidth > 0) {
+        width = std::max(width, inlineWidth);
+        reduce = fields_.at(i)->reduce();
+      }
+    }
+
+    if (kind == Kind::VARCHAR) {
+      strings_.push_back(i);
+    } else if (kind == Kind::ARRAY) {
+      binary_ = false;
     }
 
     // generate column parser for each column
-    cops_.emplace_back(genParser(f, i, kind), ia ? genSketcher(i) : nullptr, kind, width);
+    cops_.emplace_back(genParser(f, i, kind), ia ? genSketcher(i) : nullptr, kind, width, reduce);
   }
 }
 
@@ -74,17 +93,17 @@ FlatBuffer::FlatBuffer(const nebula::type::Schema& schema,
 }
 
 // initialize a read-only flat buffer with given serialized data
-// NOTE: This read-only object doesn't own the data buffer neither copy, it only references it.
-//       Hence external buffer holder needs to be live the same scope this object,
-//       We can improve this interface later.
+// NOTE: This read-only object takes over the data buffer allocated from default pool without copy,
+//       size is the allocated size which the pool needs to release the buffer in the same way it was allocated.
 FlatBuffer::FlatBuffer(const nebula::type::Schema& schema,
                        const nebula::surface::eval::Fields& fields,
-                       NByte* data)
+                       NByte* data,
+                       size_t size)
   : schema_{ schema },
     numColumns_{ schema->size() },
     fields_{ fields },
     chunk_{ data },
-    chunkSize_{ 0 } {
+    chunkSize_{ size } {
   // 1. initialize the column align property based on the meta blob
   this->initSchema();
 
@@ -125,9 +144,7 @@ FlatBuffer::FlatBuffer(const nebula::type::Schema& schema,
   list_ = std::make_unique<Buffer>(listSize, data + offset);
   offset += listSize;
 
-  // we know how big the chunk is now
-  // used for information only, may not be exactly the same memory chunk size.
-  chunkSize_ = offset;
+  N_ENSURE_LE(offset, chunkSize_, "serialized flat buffer beyond its chunk");
 
   // populate all rows properties
   vector_reserve(rows_, numRows, "FlatBuffer::FlatBuffer");
@@ -175,6 +192,38 @@ size_t FlatBuffer::widthInMain(Kind kind) noexcept {
 #undef SCALAR_WIDTH_DISTR
 }
 
+size_t FlatBuffer::widthInline(const nebula::surface::eval::ValueEval& f) noexcept {
+  const auto reduce = f.reduce();
+  const auto ot = f.outputType();
+  const auto it = f.inputType();
+  // string input is stored as range of data buffer
+  if (reduce == Reduce::NONE || it == Kind::VARCHAR || ot == Kind::VARCHAR) {
+    return 0;
+  }
+
+#define REDUCE_WIDTH(R, O, I) \
+  case Reduce::R: return Reducer<Reduce::R, Kind::O, Kind::I>::width;
+
+#define LOGIC_BY_IO(O, I)         \
+  case Kind::I: {                 \
+    switch (reduce) {             \
+      REDUCE_WIDTH(SUM, O, I)     \
+      REDUCE_WIDTH(COUNT, O, I)   \
+      REDUCE_WIDTH(MIN, O, I)     \
+      REDUCE_WIDTH(MAX, O, I)     \
+      REDUCE_WIDTH(AVG, O, I)     \
+    default: return 0;            \
+    }                             \
+  }
+
+  ITERATE_BY_IO(ot, it)
+
+#undef LOGIC_BY_IO
+#undef REDUCE_WIDTH
+
+  return 0;
+}
+
 size_t FlatBuffer::appendNull(bool isNull, nebula::type::Kind kind, Buffer& dest, size_t offset) {
   int8_t byte = (isNull ? HIGH6_1 : 0) | kind;
   return dest.slice.write<int8_t>(offset, byte);
@@ -362,6 +411,17 @@ size_t FlatBuffer::add(const nebula::surface::RowData& row) {
     const auto& cop = cops_.at(i);
     auto ia = cop.isAggregate();
     auto sketch = ia ? row.getAggregator(i) : nullptr;
+
+    // a sketch carried by the row is written as inline state if the column is reduced inline
+    if (sketch && cop.isInline()) {
+      auto& cp = columnProps.emplace_back(nv, main_->offset - rowOffset);
+      cp.reduced = true;
+      const auto offset = main_->offset;
+      main_->offset += main_->slice.writeAlign(offset, 0, cop.width);
+      sketch->serialize(main_->slice, offset);
+      continue;
+    }
+
     columnProps.emplace_back(nv, main_->offset - rowOffset, sketch);
     if (!nv) {
       cop.parser(row);
@@ -377,6 +437,62 @@ size_t FlatBuffer::add(const nebula::surface::RowData& row) {
   return rowOffset;
 }
 
+// copy a row from another flat buffer, the layout of the row in main is self-contained
+// (column offsets are relative to row offset), so main bytes are copied as a whole.
+size_t FlatBuffer::add(const FlatBuffer& src, size_t rowId) {
+  N_ENSURE(binary_ && sameLayout(src), "binary copy requires the same schema without list");
+  const auto& props = src.rows_.at(rowId);
+  const auto rowOffset = main_->offset;
+
+  // record current state before adding a new row - used for rollback
+  last_ = std::make_tuple(rowOffset, data_->offset, list_->offset);
+
+  // nulls and fixed width values of all columns
+  const auto size = src.rowSize(props);
+  main_->offset += main_->slice.write(rowOffset, src.main_->slice.ptr() + props.offset, size);
+
+  // strings reference data buffer of source, copy them over and rewrite their ranges
+  // a sketch is carried by column props rather than its serialized bytes in data buffer
+  for (auto i : strings_) {
+    const auto& cp = props.colProps.at(i);
+    if (!cp.isNull && cp.sketch == nullptr) {
+      auto str = src.read(props.offset, cp.offset);
+      auto len = data_->slice.write(data_->offset, (NByte*)str.data(), str.size());
+      Range::write(main_->slice, rowOffset + cp.offset, data_->offset, len);
+      data_->offset += len;
+    }
+  }
+
+  // column offsets stay the same, sketches are cloned as merges into this row update them in place
+  auto colProps = props.colProps;
+  for (size_t i = 0; i < numColumns_; ++i) {
+    auto& sketch = colProps.at(i).sketch;
+    if (sketch != nullptr) {
+      auto clone = cops_.at(i).sketcher();
+      clone->mix(*sketch);
+      sketch = std::move(clone);
+    }
+  }
+
+  rows_.emplace_back(rowOffset, std::move(colProps));
+
+  return rowOffset;
+}
+
+size_t FlatBuffer::rowSize(const RowProps& props) const noexcept {
+  // null bytes of all columns are always there
+  size_t size = numColumns_;
+  for (size_t i = 0; i < numColumns_; ++i) {
+    const auto& cp = props.colProps.at(i);
+    const auto& cop = cops_.at(i);
+    if (!cp.isNull || cop.isAggregate()) {
+      size = std::max<size_t>(size, cp.offset + cop.width);
+    }
+  }
+
+  return size;
+}
+
 // this method is used to pair partial add (when cols set is not empty)
 // scenario: when a new added row will need to be a new entry, we fullfil all columns rather than keys.
 // this fullfilment is only for last row, so we have to have sanity check
@@ -429,11 +545,18 @@ FlatColumnProps FlatBuffer::rebuildColumnProps(size_t rowOffset) {
     const auto& cop = cops_.at(i);
 
     // build column properties without sketch
+    // space of aggregated column is reserved even it's null, same as add
     auto& cp = colProps.emplace_back(nv, colOffset);
-    if (!nv) {
+    if (!nv || cop.isAggregate()) {
       colOffset += cop.width;
     }
 
+    // inline state is read in place
+    if (cop.isInline()) {
+      cp.reduced = true;
+      continue;
+    }
+
     // for aggregated fields, rebuild its sketch from the serialized binary
     if (cop.isAggregate()) {
       cp.sketch = cop.sketcher();
@@ -445,7 +568,7 @@ FlatColumnProps FlatBuffer::rebuildColumnProps(size_t rowOffset) {
         N_ENSURE(size <= cop.width, "sketch guranteed data size smaller than alignment");
       } else {
         auto r = Range::make(main_->slice, offset);
-        auto size = cp.sketch->load(data_->slice, r.offset);
+        auto size = readSketch(*cp.sketch, data_->slice, r.offset);
         N_ENSURE(size == r.size, "loaded size should be the same as it stored");
       }
     }
@@ -472,7 +595,7 @@ size_t FlatBuffer::serializeSketches() const {
           N_ENSURE(p.sketch->serialize(main_->slice, offset) <= cop.width,
                    "serialzied size should not out of space");
         } else {
-          auto len = p.sketch->serialize(data_->slice, data_->offset);
+          auto len = writeSketch(*p.sketch, data_->slice, data_->offset);
           // record the data offset and length for this binary in main
           Range::write(main_->slice, offset, data_->offset, len);
           // grow data size
@@ -488,6 +611,54 @@ size_t FlatBuffer::serializeSketches() const {
   return size;
 }
 
+size_t FlatBuffer::writeSketch(nebula::surface::eval::Sketch& sketch, ExtendableSlice& slice, size_t offset) {
+  if (!sketch.compressible()) {
+    return sketch.serialize(slice, offset);
+  }
+
+  // serialize in place after the frame header, compress the payload over itself if it pays off
+  const auto payload = offset + SKETCH_FRAME;
+  const auto raw = sketch.serialize(slice, payload);
+  auto codec = SKETCH_RAW;
+  auto size = raw;
+  if (FLAGS_SKETCH_LZ4_BYTES > 0 && raw >= FLAGS_SKETCH_LZ4_BYTES) {
+    std::vector<char> buffer(LZ4_compressBound(raw));
+    auto bytes = LZ4_compress_default((char*)slice.ptr() + payload, buffer.data(), raw, buffer.size());
+    if (bytes > 0 && (size_t)bytes < raw) {
+      slice.write(payload, buffer.data(), bytes);
+      codec = SKETCH_LZ4;
+      size = bytes;
+    }
+  }
+
+  slice.write(offset, codec);
+  slice.write(offset + 1, raw);
+  slice.write(offset + 1 + SIZET_SIZE, size);
+  return SKETCH_FRAME + size;
+}
+
+size_t FlatBuffer::readSketch(nebula::surface::eval::Sketch& sketch, ExtendableSlice& slice, size_t offset) {
+  if (!sketch.compressible()) {
+    return sketch.load(slice, offset);
+  }
+
+  const auto codec = slice.read<int8_t>(offset);
+  const auto raw = slice.read<size_t>(offset + 1);
+  const auto size = slice.read<size_t>(offset + 1 + SIZET_SIZE);
+  const auto payload = offset + SKETCH_FRAME;
+  if (codec == SKETCH_RAW) {
+    N_ENSURE_EQ(sketch.load(slice, payload), raw, "sketch loaded size mismatches.");
+    return SKETCH_FRAME + size;
+  }
+
+  N_ENSURE_EQ(codec, SKETCH_LZ4, "unknown sketch codec");
+  ExtendableSlice buffer(raw);
+  auto bytes = LZ4_decompress_safe((char*)slice.ptr() + payload, (char*)buffer.ptr(), size, raw);
+  N_ENSURE_EQ((size_t)bytes, raw, "raw data size mismatches.");
+  N_ENSURE_EQ(sketch.load(buffer, 0), raw, "sketch loaded size mismatches.");
+  return SKETCH_FRAME + size;
+}
+
 size_t FlatBuffer::serialize(NByte* buffer) const {
   auto offset = 0;
   // write size_t value
@@ -587,7 +758,15 @@ std::unique_ptr<nebula::surface::MapData> RowAccessor::readMap(const std::string
 }
 
 inline std::shared_ptr<nebula::surface::eval::Sketch> RowAccessor::getAggregator(IndexType index) const {
-  return rowProps_.colProps[index].sketch;
+  const auto& cp = rowProps_.colProps[index];
+  if (!cp.reduced) {
+    return cp.sketch;
+  }
+
+  // inline state is loaded into a sketch on demand, eg. finalize or merge through row interface
+  auto sketch = fb_.cops_[index].sketcher();
+  sketch->load(fb_.main_->slice, rowProps_.offset + cp.offset);
+  return sketch;
 }
 
 #define FORWARD_NAME_2_INDEX(TYPE, FUNC)                   \
@@ -54,6 +54,11 @@ static constexpr size_t MAGIC = 0x910928;
 // max column width as 8 bytes (4bytes + 4bytes)
 static constexpr size_t MAX_ALIGNMENT = 8;
 
+// a compressible sketch in data buffer is framed as [1 byte codec][raw size][stored size][payload]
+static constexpr int8_t SKETCH_RAW = 0;
+static constexpr int8_t SKETCH_LZ4 = 1;
+static constexpr size_t SKETCH_FRAME = 1 + SIZET_SIZE + SIZET_SIZE;
+
 class RowAccessor;
 
 struct Buffer {
@@ -70,11 +75,14 @@ struct ColumnProps {
   explicit ColumnProps(bool nv, uint32_t os)
     : ColumnProps(nv, os, nullptr) {}
   explicit ColumnProps(bool nv, uint32_t os, std::shared_ptr<nebula::surface::eval::Sketch> s)
-    : isNull{ nv }, offset{ os }, sketch{ s } {}
+    : isNull{ nv }, reduced{ false }, offset{ os }, sketch{ s } {}
 
   // whether it is a null value
   bool isNull;
 
+  // for inline aggregate column: whether the value in main is a reduced state or an input value
+  bool reduced;
+
   // its relative offset in current row in main buffer
   uint32_t offset;
 
@@ -102,11 +110,12 @@ using Parser = std::function<void(const nebula::surface::RowData&)>;
 using Sketcher = std::function<std::shared_ptr<nebula::surface::eval::Sketch>()>;
 
 struct ColumnOperations {
-  explicit ColumnOperations(Parser p, Sketcher s, nebula::type::Kind k, size_t w)
+  explicit ColumnOperations(Parser p, Sketcher s, nebula::type::Kind k, size_t w, nebula::surface::eval::Reduce r)
     : parser{ std::move(p) },
       sketcher{ std::move(s) },
       kind{ k },
-      width{ w } {}
+      width{ w },
+      reduce{ r } {}
 
   // function to parse a row data
   Parser parser;
@@ -120,9 +129,17 @@ struct ColumnOperations {
   // column width if not null or reserved for sketch
   size_t width;
 
+  // aggregate column with fixed width state reduced inline in main rather than a sketch object,
+  // its sketcher is only used to read the state through sketch interface.
+  nebula::surface::eval::Reduce reduce;
+
   inline bool isAggregate() const {
     return sketcher != nullptr;
   }
+
+  inline bool isInline() const {
+    return reduce != nebula::surface::eval::Reduce::NONE;
+  }
 };
 
 class FlatBuffer {
@@ -131,7 +148,8 @@ public:
              const nebula::surface::eval::Fields& fields);
   FlatBuffer(const nebula::type::Schema&,
              const nebula::surface::eval::Fields& fields,
-             NByte*);
+             NByte*,
+             size_t);
 
   virtual ~FlatBuffer() {
     if (chunk_) {
@@ -142,6 +160,16 @@ public:
   // add a row into current batch
   size_t add(const nebula::surface::RowData&);
 
+  // add a row of another flat buffer in the same schema by copying its binary,
+  // strings are re-homed into this buffer and sketches are cloned so the source is never touched.
+  // only valid when binary() is true.
+  size_t add(const FlatBuffer&, size_t);
+
+  // rows can be copied across flat buffers in binary if no list column in schema
+  inline bool binary() const noexcept {
+    return binary_;
+  }
+
   // this method only rollback last added row and the only one row only.
   bool rollback();
 
@@ -179,6 +207,10 @@ public:
     return chunk_;
   }
 
+  inline size_t chunkSize() const {
+    return chunkSize_;
+  }
+
 private:
   size_t appendNull(bool, nebula::type::Kind, Buffer&, size_t offset);
 
@@ -190,6 +222,9 @@ private:
 
   static size_t widthInMain(nebula::type::Kind) noexcept;
 
+  // width of inline state of given aggregate field, 0 if it can't be reduced inline
+  static size_t widthInline(const nebula::surface::eval::ValueEval&) noexcept;
+
   void initSchema() noexcept;
 
   Parser genParser(const nebula::type::TypeNode&, size_t, nebula::type::Kind) noexcept;
@@ -199,17 +234,25 @@ private:
   // build column properties of given row offset
   FlatColumnProps rebuildColumnProps(size_t);
 
+  // number of bytes a row takes in main buffer
+  size_t rowSize(const RowProps&) const noexcept;
+
   // the method is used to write all sketch into the data buffer
   // it is supposed to call once before flat buffer is serialized into wire
   // otherwise, we may end up multiple copies in the data buffer for each sketch
   size_t serializeSketches() const;
 
+  // write/read a sketch not fit in main buffer at given offset of a slice,
+  // compressible sketch is framed and compressed transparently if it's large.
+  static size_t writeSketch(nebula::surface::eval::Sketch&, nebula::common::ExtendableSlice&, size_t);
+  static size_t readSketch(nebula::surface::eval::Sketch&, nebula::common::ExtendableSlice&, size_t);
+
 protected:
   // schema and value evals - reference only
   const nebula::type::Schema schema_;
   const size_t numColumns_;
   const nebula::surface::eval::Fields& fields_;
-  // an owned data buffer passed in - need to free it in destructor
+  // an owned data buffer passed in - need to free it in destructor with its allocated size
   void* chunk_;
   size_t chunkSize_;
 
@@ -224,6 +267,10 @@ protected:
   // parsers are function pointers to parse row data of each column
   std::vector<ColumnOperations> cops_;
 
+  // string columns which reference data buffer by offset
+  std::vector<size_t> strings_;
+  bool binary_;
+
   // offset of last row used for supporting roll back
   std::tuple<size_t, size_t, size_t> last_;
 
@@ -239,6 +286,24 @@ protected:
     return cops_.at(col).isAggregate();
   }
 
+  // rows of the other flat buffer have the same binary layout as this one
+  inline bool sameLayout(const FlatBuffer& other) const noexcept {
+    if (numColumns_ != other.numColumns_) {
+      return false;
+    }
+
+    for (size_t i = 0; i < numColumns_; ++i) {
+      const auto& c1 = cops_.at(i);
+      const auto& c2 = other.cops_.at(i);
+      if (c1.kind != c2.kind || c1.width != c2.width || c1.reduce != c2.reduce
+          || c1.isAggregate() != c2.isAggregate()) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   // read a string from given row offset and col offset
   inline std::string_view read(size_t rowOffset, size_t colOffset) const noexcept {
     auto so = rowOffset + colOffset;
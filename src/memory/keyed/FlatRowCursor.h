@@ -39,6 +39,10 @@ public:
     return flat_->crow(index);
   }
 
+  inline const FlatBuffer& flat() const {
+    return *flat_;
+  }
+
   inline std::unique_ptr<nebula::memory::keyed::FlatBuffer> takeResult() {
     std::unique_ptr<FlatBuffer> temp = nullptr;
     std::swap(temp, flat_);
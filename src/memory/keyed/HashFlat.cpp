@@ -263,8 +263,16 @@ size_t HashFlat::hash(size_t rowId) const {
     auto len = keyHash_->size();
     std::memset(ptr, 0, len);
 
+    // dictionary encoded key is hashed on its code
+    const auto coded = coders_.size();
     for (size_t i = 0, size = keys_.size(); i < size; ++i) {
-      *(ptr + i) = ops_.at(keys_.at(i)).hasher(rowId);
+      const auto key = keys_.at(i);
+      if (coded > 0 && slots_[key] >= 0) {
+        *(ptr + i) = codes_[rowId * coded + slots_[key]];
+        continue;
+      }
+
+      *(ptr + i) = ops_.at(key).hasher(rowId);
     }
 
     return nebula::common::Hasher::hash64(ptr, len);
@@ -288,7 +296,16 @@ bool HashFlat::equal(size_t row1, size_t row2) const {
     return std::memcmp(ptr + kp1.first, ptr + kp2.first, kp1.second) == 0;
   }
 
+  const auto coded = coders_.size();
   for (auto index : keys_) {
+    if (coded > 0 && slots_[index] >= 0) {
+      if (codes_[row1 * coded + slots_[index]] != codes_[row2 * coded + slots_[index]]) {
+        return false;
+      }
+
+      continue;
+    }
+
     if (ops_.at(index).comparator(row1, row2) != 0) {
       return false;
     }
@@ -298,11 +315,77 @@ bool HashFlat::equal(size_t row1, size_t row2) const {
 }
 
 bool HashFlat::update(const nebula::surface::RowData& row) {
+  N_ENSURE(coders_.empty(), "coded keys require source row");
+
   // add a new row to the buffer may be expensive
   // if there are object values to be created such as customized aggregation
   // to have consistent way - we're taking this approach
   this->add(row);
+  return dedupe();
+}
+
+bool HashFlat::update(const FlatBuffer& flat, size_t row) {
+  N_ENSURE(coders_.empty(), "decode keys before merging rows");
+
+  // copy the row in binary, no row data access involved
+  this->add(flat, row);
+  return dedupe();
+}
+
+void HashFlat::encode(std::vector<Coder> coders) {
+  N_ENSURE_EQ(getRows(), 0, "keys can only be encoded in empty hash flat");
+  N_ENSURE_EQ(coders.size(), numColumns_, "every column expects a coder");
+
+  // optimal keys have no strings
+  if (optimal_) {
+    return;
+  }
+
+  slots_.assign(numColumns_, -1);
+  for (auto key : keys_) {
+    if (coders.at(key)) {
+      slots_[key] = coders_.size();
+      coders_.push_back(std::move(coders.at(key)));
+    }
+  }
+}
+
+bool HashFlat::update(const nebula::surface::RowData& row, size_t source) {
+  if (coders_.empty()) {
+    return update(row);
+  }
+
+  // codes of the new row are read before dedupe, and removed if it's merged
+  this->add(row);
+  for (const auto& coder : coders_) {
+    codes_.push_back(coder(source));
+  }
+
+  if (dedupe()) {
+    codes_.resize(codes_.size() - coders_.size());
+    return true;
+  }
+
+  return false;
+}
 
+void HashFlat::decode() {
+  if (coders_.empty()) {
+    return;
+  }
+
+  coders_.clear();
+  slots_.clear();
+  codes_.clear();
+
+  // codes are unique per value in a dictionary, so rows stay unique, just hash them on values
+  rowKeys_.clear();
+  for (size_t row = 0, rows = getRows(); row < rows; ++row) {
+    rowKeys_.insert(Key{ *this, row, hash(row) });
+  }
+}
+
+bool HashFlat::dedupe() {
   auto newRow = getRows() - 1;
   auto hValue = hash(newRow);
   Key key{ *this, newRow, hValue };
@@ -324,8 +407,14 @@ bool HashFlat::update(const nebula::surface::RowData& row) {
   rowKeys_.insert(key);
 
   // since this is a new row, create aggregator for all its value fields
+  // inline aggregate gets its state from its own value instead
   auto& rowProps = rows_.at(newRow);
   for (size_t i : values_) {
+    if (cops_.at(i).isInline()) {
+      ops_.at(i).copier(newRow, newRow);
+      continue;
+    }
+
     auto& sketch = rowProps.colProps.at(i).sketch;
     if (sketch == nullptr) {
       sketch = cops_.at(i).sketcher();
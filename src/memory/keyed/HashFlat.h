@@ -39,6 +39,9 @@ using Hasher = std::function<size_t(size_t)>;
 // Copier on one column from given row1 to row2 which using external updater
 using Copier = std::function<void(size_t, size_t)>;
 
+// Coder reads dictionary code of a key column at given row of the source block, -1 for null
+using Coder = std::function<int32_t(size_t)>;
+
 struct ColOps {
   explicit ColOps(Comparator c, Hasher h, Copier o)
     : comparator{ std::move(c) },
@@ -65,7 +68,7 @@ public:
 
   HashFlat(FlatBuffer* in,
            const nebula::surface::eval::Fields& fields)
-    : FlatBuffer(in->schema(), fields, (NByte*)in->chunk()),
+    : FlatBuffer(in->schema(), fields, (NByte*)in->chunk(), in->chunkSize()),
       keyHash_{ nullptr },
       optimal_{ false } {
     init();
@@ -83,6 +86,19 @@ public:
   // otherwise we get a new row, return false
   bool update(const nebula::surface::RowData&);
 
+  // update a row of another flat buffer through binary copy, see FlatBuffer::add
+  bool update(const FlatBuffer&, size_t);
+
+  // string keys read from dictionary encoded columns of a source block are hashed and compared
+  // on their codes rather than string bytes, coders are indexed by column and empty for others.
+  void encode(std::vector<Coder>);
+
+  // update a row read at given row of the source block, its key codes are read by the coders.
+  bool update(const nebula::surface::RowData&, size_t);
+
+  // drop codes and hash all rows on their key values, required before any other rows merged in.
+  void decode();
+
   struct Hash {
     inline size_t operator()(const Key& key) const noexcept {
       return std::get<2>(key);
@@ -100,6 +116,8 @@ public:
 
 private:
   void init();
+  // dedupe last added row by its keys, return true if it's merged into an existing row
+  bool dedupe();
   Comparator genComparator(size_t) noexcept;
   Hasher genHasher(size_t) noexcept;
   Copier genCopier(size_t) noexcept;
@@ -128,6 +146,38 @@ private:
     }
   }
 
+  // reduce row1 into inline state of row2 through typed kernels, no sketch involved.
+  // merging a row into itself turns its input value into state when the row is kept as a new group.
+  template <nebula::surface::eval::Reduce R, nebula::type::Kind O, nebula::type::Kind I>
+  inline void reduce(size_t row1, size_t row2, size_t i) noexcept {
+    using InputType = typename nebula::type::TypeTraits<I>::CppType;
+    using TReducer = nebula::surface::eval::Reducer<R, O, I>;
+    auto& slice = main_->slice;
+    auto& colProps1 = rows_[row1].colProps[i];
+    const auto offset1 = rows_[row1].offset + colProps1.offset;
+    if (row1 == row2) {
+      if (!colProps1.reduced) {
+        InputType value = slice.read<InputType>(offset1);
+        TReducer::init(slice, offset1);
+        if (!colProps1.isNull) {
+          TReducer::merge(slice, offset1, value);
+        }
+        colProps1.reduced = true;
+      }
+      return;
+    }
+
+    const auto offset2 = rows_[row2].offset + rows_[row2].colProps[i].offset;
+    if (colProps1.reduced) {
+      TReducer::mix(slice, offset2, offset1);
+      return;
+    }
+
+    if (N_LIKELY(!colProps1.isNull)) {
+      TReducer::merge(slice, offset2, slice.read<InputType>(offset1));
+    }
+  }
+
   template <nebula::type::Kind O>
   inline void merge_string(size_t row1, size_t row2, size_t i) noexcept {
     using TAggregator = typename nebula::surface::eval::Aggregator<O, nebula::type::Kind::VARCHAR>;
@@ -152,9 +202,28 @@ private:
 
   template <nebula::type::Kind O, nebula::type::Kind I>
   Copier bind(size_t col) {
+    using nebula::surface::eval::Reduce;
     if constexpr (I == nebula::type::Kind::VARCHAR) {
       return std::bind(&HashFlat::merge_string<O>, this, std::placeholders::_1, std::placeholders::_2, col);
     } else {
+      if constexpr (O != nebula::type::Kind::VARCHAR) {
+#define REDUCE_BIND(R)                                                                                      \
+  case Reduce::R:                                                                                           \
+    return std::bind(&HashFlat::reduce<Reduce::R, O, I>, this, std::placeholders::_1, std::placeholders::_2, col);
+
+        switch (cops_.at(col).reduce) {
+          REDUCE_BIND(SUM)
+          REDUCE_BIND(COUNT)
+          REDUCE_BIND(MIN)
+          REDUCE_BIND(MAX)
+          REDUCE_BIND(AVG)
+        default:
+          break;
+        }
+
+#undef REDUCE_BIND
+      }
+
       return std::bind(&HashFlat::merge<O, I>, this, std::placeholders::_1, std::placeholders::_2, col);
     }
   }
@@ -177,6 +246,12 @@ private:
 
   std::vector<ColOps> ops_;
 
+  // coders of dictionary encoded keys, slot of each column in codes of a row (-1 if not coded)
+  std::vector<Coder> coders_;
+  std::vector<int32_t> slots_;
+  // codes of all rows laid out row by row
+  std::vector<int32_t> codes_;
+
   // TODO(cao):
   // build error Undefined symbols for architecture x86_64: "folly::f14::detail::F14LinkCheck
   // https://engineering.fb.com/developer-tools/f14/
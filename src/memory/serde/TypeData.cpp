@@ -143,6 +143,22 @@ TYPE_ADD_PROXY(int128_t, i128d_)
 TYPE_ADD_PROXY(std::string_view, std_)
 #undef TYPE_ADD_PROXY
 
+#define TYPE_BULK_ADD_PROXY(TYPE, OBJ)                                                           \
+  template <>                                                                                    \
+  void TypeDataProxy::add(IndexType index, const TYPE* values, const bool* nulls, size_t size) { \
+    OBJ->add(index, values, nulls, size);                                                        \
+  }
+
+TYPE_BULK_ADD_PROXY(bool, bd_)
+TYPE_BULK_ADD_PROXY(int8_t, btd_)
+TYPE_BULK_ADD_PROXY(int16_t, sd_)
+TYPE_BULK_ADD_PROXY(int32_t, id_)
+TYPE_BULK_ADD_PROXY(int64_t, ld_)
+TYPE_BULK_ADD_PROXY(float, fd_)
+TYPE_BULK_ADD_PROXY(double, dd_)
+TYPE_BULK_ADD_PROXY(int128_t, i128d_)
+#undef TYPE_BULK_ADD_PROXY
+
 #define TYPE_PROBABLY_PROXY(TYPE, OBJ)             \
   template <>                                      \
   bool TypeDataProxy::probably(TYPE value) const { \
@@ -195,6 +211,23 @@ TYPE_READ_PROXY(int128_t, i128d_)
 
 #undef TYPE_READ_PROXY
 
+#define TYPE_BULK_READ_PROXY(TYPE, OBJ)                                              \
+  template <>                                                                        \
+  void TypeDataProxy::read(const uint32_t* rows, size_t size, TYPE* values) const { \
+    OBJ->read(rows, size, values);                                                   \
+  }
+
+TYPE_BULK_READ_PROXY(bool, bd_)
+TYPE_BULK_READ_PROXY(int8_t, btd_)
+TYPE_BULK_READ_PROXY(int16_t, sd_)
+TYPE_BULK_READ_PROXY(int32_t, id_)
+TYPE_BULK_READ_PROXY(int64_t, ld_)
+TYPE_BULK_READ_PROXY(float, fd_)
+TYPE_BULK_READ_PROXY(double, dd_)
+TYPE_BULK_READ_PROXY(int128_t, i128d_)
+
+#undef TYPE_BULK_READ_PROXY
+
 } // namespace serde
 } // namespace memory
 } // namespace nebula
\ No newline at end of file
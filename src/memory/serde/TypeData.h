@@ -22,6 +22,7 @@
 #include "common/BloomFilter.h"
 #include "common/Likely.h"
 #include "common/Memory.h"
+#include "memory/encode/IntCodec.h"
 #include "meta/Table.h"
 #include "type/Type.h"
 
@@ -76,6 +77,11 @@ class TypeDataImpl : public TypeData {
   using NType = typename nebula::type::TypeTraits<KIND>::CppType;
   static constexpr auto Scalar = nebula::type::TypeBase::isScalar(KIND);
   static constexpr auto Unit = Scalar ? nebula::type::TypeTraits<KIND>::width : 16;
+  // integer data can be encoded when sealed
+  static constexpr auto Encodable = KIND == nebula::type::Kind::TINYINT
+                                    || KIND == nebula::type::Kind::SMALLINT
+                                    || KIND == nebula::type::Kind::INTEGER
+                                    || KIND == nebula::type::Kind::BIGINT;
 
 public:
   TypeDataImpl(const nebula::meta::Column&, size_t);
@@ -93,14 +99,57 @@ public:
     }
   }
 
+  // bulk add contiguous values, values of null entries are expected to be void (0)
+  void add(IndexType index, const NType* values, const bool* nulls, size_t count) {
+    if constexpr (nebula::type::TypeTraits<KIND>::width > 0) {
+      static_assert(sizeof(NType) == Unit, "fixed width values are stored in native width");
+      size_ += slice_.write(size_, reinterpret_cast<const char*>(values), count * Unit);
+      if (N_UNLIKELY(bf_ != nullptr)) {
+        for (size_t i = 0; i < count && bf_ != nullptr; ++i) {
+          if ((nulls == nullptr || !nulls[i]) && !bf_->add(values[i])) {
+            bf_ = nullptr;
+            LOG(INFO) << "Failed to add value to bloom filter: " << size()
+                      << ",  type=" << nebula::type::TypeTraits<KIND>::name;
+          }
+        }
+      }
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        add(index + i, values[i]);
+      }
+    }
+  }
+
   void addVoid(IndexType) {
     size_ += slice_.write(size_, (NType)0);
   }
 
   NType read(IndexType index) const {
+    if constexpr (Encodable) {
+      if (codec_.encoding() != nebula::memory::encode::IntEncoding::RAW) {
+        return (NType)codec_.read(slice_, index);
+      }
+    }
+
     return slice_.template read<NType>(index * Unit);
   }
 
+  // bulk read values of given rows into a contiguous buffer
+  void read(const uint32_t* rows, size_t size, NType* values) const {
+    if constexpr (Encodable) {
+      if (codec_.encoding() != nebula::memory::encode::IntEncoding::RAW) {
+        for (size_t i = 0; i < size; ++i) {
+          values[i] = (NType)codec_.read(slice_, rows[i]);
+        }
+        return;
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = slice_.template read<NType>(rows[i] * Unit);
+    }
+  }
+
   inline std::string_view read(IndexType offset, IndexType size) {
     return slice_.read(offset, size);
   }
@@ -120,12 +169,19 @@ public:
   }
 
   inline virtual void seal() override {
-    slice_.seal(size_);
+    if constexpr (Encodable) {
+      // data size reflects encoded bytes after this point
+      size_ = codec_.encode<NType>(slice_, size_ / Unit);
+    } else {
+      slice_.seal(size_);
+    }
   }
 
 private:
   // memory chunk managed by paged slice
   nebula::common::ExtendableSlice slice_;
+  // encoding of sealed integer data, raw until sealed
+  nebula::memory::encode::IntCodec codec_;
   std::unique_ptr<nebula::common::BloomFilter<NType>> bf_;
 
   // default value of this data node
@@ -148,6 +204,10 @@ public:
   template <typename T>
   void add(IndexType, T);
 
+  // bulk add values of consecutive entries starting at given index
+  template <typename T>
+  void add(IndexType, const T*, const bool*, size_t);
+
   inline void addVoid(IndexType index) {
     if (N_LIKELY(void_ != nullptr)) {
       void_(index);
@@ -158,6 +218,9 @@ public:
   template <typename T>
   T read(IndexType) const;
 
+  template <typename T>
+  void read(const uint32_t*, size_t, T*) const;
+
   inline std::string_view read(IndexType offset, IndexType size) const {
     return std_->read(offset, size);
   }
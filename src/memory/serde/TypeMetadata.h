@@ -155,6 +155,10 @@ public:
     return dict_->get(index);
   }
 
+  inline size_t dictSize() const {
+    return dict_->size();
+  }
+
   inline void seal() {
     // release hash items for lookup
     if (dict_) {
@@ -17,6 +17,8 @@
 #include <fmt/format.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <numeric>
+#include <thread>
 #include <valarray>
 
 #include "common/Memory.h"
@@ -395,6 +397,176 @@ TEST(BatchTest, TestPartitionedBatch) {
   }
 }
 
+TEST(BatchTest, TestColumnarAppend) {
+  nebula::meta::ColumnProps props;
+  props.emplace("name", nebula::meta::Column{ false, true });
+  nebula::meta::Table table("columnar", TypeSerializer::from("ROW<id:int, name:string, weight:double>"), props, {});
+  Batch batch(table, 16);
+
+  // append two slices of rows column by column, weight is never appended
+  std::vector<int32_t> ids{ 1, 2, 3, 4, 5, 6 };
+  std::vector<std::string_view> names{ "a", "", "b", "a", "a", "b" };
+  bool nulls[] = { false, true, false, false, false, false };
+  batch.append<int32_t>("id", ids.data(), nullptr, 4);
+  batch.append<std::string_view>("name", names.data(), nulls, 4);
+  EXPECT_EQ(batch.commit(4), 4);
+  batch.append<int32_t>("id", ids.data() + 4, nullptr, 2);
+  batch.append<std::string_view>("name", names.data() + 4, nulls + 4, 2);
+  EXPECT_EQ(batch.commit(2), 6);
+
+  EXPECT_EQ(batch.getRows(), 6);
+
+  batch.seal();
+  auto accessor = batch.makeAccessor();
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const auto& r = accessor->seek(i);
+    EXPECT_EQ(r.readInt("id"), ids.at(i));
+    if (nulls[i]) {
+      EXPECT_FALSE(r.readString("name").has_value());
+    } else {
+      EXPECT_EQ(r.readString("name"), names.at(i));
+    }
+    EXPECT_FALSE(r.readDouble("weight").has_value());
+  }
+}
+
+TEST(BatchTest, TestOrdinalAccess) {
+  nebula::meta::TestTable test;
+  Batch batch(test, 16);
+  for (int32_t i = 0; i < 10; ++i) {
+    nebula::surface::StaticRow row{ i, i, "nebula", nullptr, i % 2 == 0, (char)i, 128, i * 1.5 };
+    batch.add(row);
+  }
+
+  batch.seal();
+
+  // accessor bound to a plan schema: reordered, and one column not in this batch
+  auto schema = TypeSerializer::from("ROW<weight:double, miss:bool, id:int, event:string, flag:bool>");
+  auto accessor = batch.makeAccessor(schema);
+  for (int32_t i = 0; i < 10; ++i) {
+    const auto& r = accessor->seek(i);
+    EXPECT_EQ(r.readDouble(0), r.readDouble("weight"));
+    EXPECT_FALSE(r.readBool(1).has_value());
+    EXPECT_EQ(r.readInt(2), i);
+    EXPECT_EQ(r.readString(3), "nebula");
+    EXPECT_EQ(r.readBool(4), i % 2 == 0);
+  }
+
+  // a copy shares bound columns but seeks on its own
+  RowAccessor copy(*accessor);
+  copy.seek(3);
+  EXPECT_EQ(accessor->seek(5).readInt(2), 5);
+  EXPECT_EQ(copy.readInt(2), 3);
+  EXPECT_EQ(copy.readString(3), "nebula");
+}
+
+TEST(BatchTest, TestZoneMaps) {
+  nebula::meta::Table table("zones", TypeSerializer::from("ROW<id:int, name:string, weight:double>"), {}, {});
+  Batch batch(table, 1024);
+
+  // ids are sorted, weights have nulls in last page only
+  constexpr size_t rows = 20000;
+  std::vector<int32_t> ids(rows);
+  std::vector<double> weights(rows);
+  auto nulls = std::make_unique<bool[]>(rows);
+  for (size_t i = 0; i < rows; ++i) {
+    ids[i] = i;
+    weights[i] = i * 0.5;
+    nulls[i] = i > 16384 && i % 100 == 0;
+  }
+
+  batch.append<int32_t>("id", ids.data(), nullptr, rows);
+  batch.append<double>("weight", weights.data(), nulls.get(), rows);
+  batch.commit(rows);
+  EXPECT_EQ(batch.numPages(), 0);
+
+  batch.seal();
+  const auto pageRows = batch.pageRows();
+  EXPECT_EQ(pageRows, 8192);
+  EXPECT_EQ(batch.numPages(), 3);
+
+  for (size_t p = 0; p < batch.numPages(); ++p) {
+    nebula::memory::PageBlock page(batch, p);
+    const auto begin = p * pageRows;
+    const auto size = std::min(pageRows, rows - begin);
+    EXPECT_EQ(page.getRows(), size);
+
+    auto ih = std::dynamic_pointer_cast<nebula::surface::eval::IntHistogram>(page.histogram("id"));
+    EXPECT_EQ(ih->count, size);
+    EXPECT_EQ(ih->min(), begin);
+    EXPECT_EQ(ih->max(), begin + size - 1);
+
+    auto rh = std::dynamic_pointer_cast<nebula::surface::eval::RealHistogram>(page.histogram("weight"));
+    EXPECT_EQ(rh->min(), begin * 0.5);
+    EXPECT_EQ(batch.dense(p), p < 2);
+  }
+
+  // string column has no zone map and falls back to block histogram
+  EXPECT_EQ(batch.histogram("name", 1), batch.histogram("name"));
+}
+
+TEST(BatchTest, TestLiveBatch) {
+  nebula::meta::Table table("live", TypeSerializer::from("ROW<id:int, weight:double>"), {}, {});
+  // small capacity to have buffers grow while being read
+  Batch batch(table, 16);
+
+  static constexpr size_t slices = 200;
+  static constexpr size_t sliceRows = 100;
+  std::atomic<bool> done{ false };
+  std::thread writer([&batch, &done]() {
+    std::vector<int32_t> ids(sliceRows);
+    std::vector<double> weights(sliceRows);
+    for (size_t s = 0; s < slices; ++s) {
+      for (size_t i = 0; i < sliceRows; ++i) {
+        ids[i] = s * sliceRows + i;
+        weights[i] = ids[i] * 0.5;
+      }
+
+      auto lock = batch.lock();
+      batch.append<int32_t>("id", ids.data(), nullptr, sliceRows);
+      batch.append<double>("weight", weights.data(), nullptr, sliceRows);
+      batch.commit(sliceRows);
+    }
+
+    auto lock = batch.lock();
+    batch.seal();
+    done = true;
+  });
+
+  // readers always see a consistent prefix of rows
+  auto read = [&batch, &done]() {
+    size_t last = 0;
+    while (!done) {
+      auto pin = batch.pin();
+      const auto rows = batch.getRows();
+      EXPECT_GE(rows, last);
+      EXPECT_EQ(rows % sliceRows, 0);
+      last = rows;
+
+      nebula::surface::eval::Selection selection(rows);
+      std::iota(selection.begin(), selection.end(), 0);
+      std::vector<int32_t> ids(rows);
+      std::vector<double> weights(rows);
+      auto nulls = std::make_unique<bool[]>(rows);
+      EXPECT_TRUE(batch.read("id", selection, ids.data(), nulls.get()));
+      EXPECT_TRUE(batch.read("weight", selection, weights.data(), nulls.get()));
+      for (size_t i = 0; i < rows; ++i) {
+        EXPECT_EQ(ids[i], (int32_t)i);
+        EXPECT_EQ(weights[i], i * 0.5);
+      }
+    }
+  };
+
+  std::thread r1(read);
+  std::thread r2(read);
+  writer.join();
+  r1.join();
+  r2.join();
+
+  EXPECT_TRUE(batch.sealed());
+  EXPECT_EQ(batch.getRows(), slices * sliceRows);
+}
+
 } // namespace test
 } // namespace memory
 } // namespace nebula
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "memory/DataNode.h"
 #include "memory/FlatRow.h"
 #include "memory/encode/DictEncoder.h"
+#include "memory/encode/IntCodec.h"
 #include "memory/encode/RleDecoder.h"
 #include "memory/encode/RleEncoder.h"
 #include "memory/encode/Utils.h"
@@ -181,6 +182,117 @@ TEST(DictTest, TestDictionary) {
   }
 }
 
+template <typename T>
+void testCodec(const std::vector<T>& values, nebula::memory::encode::IntEncoding expected) {
+  nebula::common::ExtendableSlice slice(1024);
+  for (size_t i = 0; i < values.size(); ++i) {
+    slice.write(i * sizeof(T), values[i]);
+  }
+
+  nebula::memory::encode::IntCodec codec;
+  auto bytes = codec.encode<T>(slice, values.size());
+  LOG(INFO) << "encoded " << values.size() * sizeof(T) << " bytes into " << bytes;
+  EXPECT_EQ(codec.encoding(), expected);
+
+  // sequential scan
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(codec.read(slice, i), values[i]);
+  }
+
+  // random access
+  auto r = nebula::common::Evidence::rand(0, values.size() - 1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto index = r();
+    ASSERT_EQ(codec.read(slice, index), values[index]);
+  }
+}
+
+TEST(IntCodecTest, TestBitPack) {
+  auto r = nebula::common::Evidence::rand(-1000, 1000);
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 10000; ++i) {
+    values.push_back((1L << 40) + r());
+  }
+
+  testCodec(values, nebula::memory::encode::IntEncoding::BITPACK);
+}
+
+TEST(IntCodecTest, TestRle) {
+  // time column in a block is mostly sorted with many repeats
+  std::vector<int64_t> values;
+  int64_t time = 1600000000;
+  for (auto i = 0; i < 10000; ++i) {
+    if (i % 7 == 0) {
+      time += 3;
+    }
+    values.push_back(time);
+  }
+
+  testCodec(values, nebula::memory::encode::IntEncoding::RLE);
+
+  std::vector<int32_t> ids;
+  for (auto i = 0; i < 5000; ++i) {
+    ids.push_back(i / 50 - 30);
+  }
+  testCodec(ids, nebula::memory::encode::IntEncoding::RLE);
+}
+
+TEST(IntCodecTest, TestRaw) {
+  auto r = nebula::common::Evidence::rand(std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max());
+  std::vector<int16_t> values;
+  for (auto i = 0; i < 3000; ++i) {
+    values.push_back(r());
+  }
+
+  testCodec(values, nebula::memory::encode::IntEncoding::RAW);
+}
+
+TEST(IntCodecTest, TestRleInterleaved) {
+  // a row scan reads multiple RLE columns of a block alternately, wide tables have dozens of them
+  constexpr auto columns = 40;
+  constexpr auto items = 5000;
+  std::vector<std::unique_ptr<nebula::common::ExtendableSlice>> slices;
+  std::vector<nebula::memory::encode::IntCodec> codecs(columns);
+  for (auto c = 0; c < columns; ++c) {
+    slices.push_back(std::make_unique<nebula::common::ExtendableSlice>(1024));
+    for (auto i = 0; i < items; ++i) {
+      slices[c]->write(i * sizeof(int64_t), (int64_t)(i / 10 * (c + 1)));
+    }
+
+    codecs[c].encode<int64_t>(*slices[c], items);
+    EXPECT_EQ(codecs[c].encoding(), nebula::memory::encode::IntEncoding::RLE);
+  }
+
+  for (auto i = 0; i < items; ++i) {
+    for (auto c = 0; c < columns; ++c) {
+      ASSERT_EQ(codecs[c].read(*slices[c], i), i / 10 * (c + 1));
+    }
+  }
+}
+
+TEST(TypeDataTest, TestSealEncoded) {
+  nebula::meta::Column column;
+  auto type = nebula::type::LongType::create("col");
+  auto b = nebula::memory::serde::TypeDataFactory::createData(type, column, 16);
+  constexpr auto items = 5000;
+  for (auto i = 0; i < items; ++i) {
+    b->add(i, 1000L + i % 100);
+  }
+
+  b->seal();
+  EXPECT_LT(b->size(), items * sizeof(int64_t));
+  for (auto i = 0; i < items; ++i) {
+    ASSERT_EQ(b->read<int64_t>(i), 1000L + i % 100);
+  }
+
+  uint32_t rows[] = { 4999, 0, 1234, 77 };
+  int64_t values[4];
+  b->read<int64_t>(rows, 4, values);
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_EQ(values[i], 1000L + rows[i] % 100);
+  }
+}
+
 #undef SIZE
 
 } // namespace test
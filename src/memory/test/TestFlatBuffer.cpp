@@ -168,7 +168,7 @@ TEST(FlatBufferTest, TestSerde) {
   EXPECT_EQ(size, fb.serialize(buffer));
 
   // deserialize this data into another flat buffer
-  FlatBuffer fb2(test.schema(), test.testFields(), buffer);
+  FlatBuffer fb2(test.schema(), test.testFields(), buffer, size);
 
   // check these two buffers are exactly the same
   EXPECT_EQ(fb2.getRows(), rows2test);
@@ -218,7 +218,7 @@ TEST(FlatBufferTest, TestHashFlatSerde) {
   EXPECT_EQ(size, hf.serialize(buffer));
 
   // deserialize this data into another flat buffer
-  FlatBuffer fb2(schema, f, buffer);
+  FlatBuffer fb2(schema, f, buffer, size);
 
   // check these two buffers are exactly the same
   EXPECT_EQ(fb2.getRows(), rows2test);
@@ -243,6 +243,91 @@ TEST(FlatBufferTest, TestHashFlatSerde) {
   }
 }
 
+TEST(FlatBufferTest, TestBinaryCopy) {
+  auto schema = TypeSerializer::from("ROW<id:int, event:string, flag:bool>");
+  nebula::surface::eval::Fields f;
+  f.reserve(3);
+  f.emplace_back(nebula::surface::eval::constant(1));
+  f.emplace_back(nebula::surface::eval::constant(2));
+  f.emplace_back(nebula::surface::eval::constant(3));
+
+  auto str = [](const RowData& r) {
+    return fmt::format("({0}, {1}, {2})",
+                       r.isNull(0) ? 0 : r.readInt(0),
+                       r.isNull(1) ? "NULL" : r.readString(1),
+                       r.isNull(2) ? true : r.readBool(2));
+  };
+
+  constexpr auto rows2test = 1053;
+  MockRowData row(Evidence::unix_timestamp());
+  FlatBuffer fb(schema, f);
+  for (auto i = 0; i < rows2test; ++i) {
+    fb.add(row);
+  }
+
+  // copy rows in reverse order
+  FlatBuffer copy(schema, f);
+  EXPECT_TRUE(copy.binary());
+  for (auto i = rows2test - 1; i >= 0; --i) {
+    copy.add(fb, i);
+  }
+
+  EXPECT_EQ(copy.getRows(), rows2test);
+  for (auto i = 0; i < rows2test; ++i) {
+    EXPECT_EQ(str(fb.row(i)), str(copy.row(rows2test - 1 - i)));
+  }
+
+  // copy from a deserialized buffer
+  auto size = copy.prepareSerde();
+  auto buffer = static_cast<NByte*>(nebula::common::Pool::getDefault().allocate(size));
+  EXPECT_EQ(size, copy.serialize(buffer));
+  FlatBuffer wire(schema, f, buffer, size);
+
+  // same rows merged in binary into hash flat are deduped by keys
+  HashFlat hf(schema, f);
+  for (size_t i = 0; i < wire.getRows(); ++i) {
+    hf.update(wire, i);
+  }
+
+  const auto unique = hf.getRows();
+  for (size_t i = 0; i < wire.getRows(); ++i) {
+    EXPECT_TRUE(hf.update(wire, i));
+  }
+
+  EXPECT_EQ(hf.getRows(), unique);
+  EXPECT_EQ(str(hf.row(0)), str(fb.row(rows2test - 1)));
+}
+
+TEST(FlatBufferTest, TestChunkFreedBySize) {
+  auto schema = TypeSerializer::from("ROW<id:int, event:string>");
+  nebula::surface::eval::Fields f;
+  f.reserve(2);
+  f.emplace_back(nebula::surface::eval::constant(1));
+  f.emplace_back(nebula::surface::eval::constant(2));
+
+  MockRowData row(Evidence::unix_timestamp());
+  FlatBuffer fb(schema, f);
+  for (auto i = 0; i < 10; ++i) {
+    fb.add(row);
+  }
+
+  // a small result received into a large chunk is served by mapped pages,
+  // it has to be released by its allocated size rather than the serialized size
+  auto& pool = nebula::common::Pool::getDefault();
+  const auto live = pool.live();
+  auto size = fb.prepareSerde();
+  EXPECT_LT(size, nebula::common::Pool::LARGE_CHUNK);
+  auto buffer = static_cast<NByte*>(pool.allocate(nebula::common::Pool::LARGE_CHUNK));
+  EXPECT_EQ(size, fb.serialize(buffer));
+  {
+    FlatBuffer wire(schema, f, buffer, nebula::common::Pool::LARGE_CHUNK);
+    EXPECT_EQ(wire.getRows(), 10);
+    EXPECT_EQ(wire.chunkSize(), nebula::common::Pool::LARGE_CHUNK);
+  }
+
+  EXPECT_EQ(pool.live(), live);
+}
+
 } // namespace test
 } // namespace memory
 } // namespace nebula
\ No newline at end of file
@@ -522,7 +522,13 @@ void ClusterInfo::load(const std::string& file, CreateMetaDB createDb) {
 
     for (size_t i = 0, size = nodes.size(); i < size; ++i) {
       const auto& node = nodes[i]["node"];
-      nodeSet.emplace(NRole::NODE, node["host"].as<std::string>(), node["port"].as<size_t>());
+      NNode n{ NRole::NODE, node["host"].as<std::string>(), node["port"].as<size_t>() };
+
+      // optional memory capacity (GB) weights how many specs the node hosts
+      if (node["memory"]) {
+        n.memory = node["memory"].as<size_t>() * 1024;
+      }
+      nodeSet.emplace(std::move(n));
     }
 
     // add current server as a node if option says so
@@ -36,6 +36,9 @@ struct BlockState {
   // serialized histograms of each column
   // (assuming all blocks share the same schama, otherwise we may need mapping)
   nebula::surface::eval::HistVector histograms;
+
+  // block of a batch still being built, its metadata is behind the data
+  bool live = false;
 };
 
 struct BlockSignature {
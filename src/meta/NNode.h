@@ -40,14 +40,17 @@ struct NNode {
   // data size on the node
   size_t size;
 
+  // memory capacity of the node in MB, 0 if unknown
+  size_t memory;
+
   NNode(NRole r, std::string h, size_t p)
-    : role{ r }, server{ std::move(h) }, port{ p }, state{ NState::ACTIVE }, size{ 0 } {}
+    : role{ r }, server{ std::move(h) }, port{ p }, state{ NState::ACTIVE }, size{ 0 }, memory{ 0 } {}
 
   NNode(const NNode& n)
-    : role{ n.role }, server{ n.server }, port{ n.port }, state{ n.state }, size{ n.size } {}
+    : role{ n.role }, server{ n.server }, port{ n.port }, state{ n.state }, size{ n.size }, memory{ n.memory } {}
 
   NNode(NNode&& n)
-    : role{ n.role }, server{ std::move(n.server) }, port{ n.port }, state{ n.state }, size{ n.size } {}
+    : role{ n.role }, server{ std::move(n.server) }, port{ n.port }, state{ n.state }, size{ n.size }, memory{ n.memory } {}
 
   NNode& operator=(const NNode& n) noexcept {
     role = n.role;
@@ -55,6 +58,7 @@ struct NNode {
     port = n.port;
     state = n.state;
     size = n.size;
+    memory = n.memory;
     return *this;
   }
 
@@ -64,6 +68,7 @@ struct NNode {
     port = n.port;
     state = n.state;
     size = n.size;
+    memory = n.memory;
     return *this;
   }
 
@@ -110,7 +115,7 @@ struct NNode {
     return INVALID;
   }
 
-  MSGPACK_DEFINE(role, server, port, state, size)
+  MSGPACK_DEFINE(role, server, port, state, size, memory)
 }; // namespace meta
 
 struct NodeHash {
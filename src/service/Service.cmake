@@ -86,6 +86,7 @@ add_library(${NEBULA_SERVICE} STATIC
     ${NEBULA_SRC}/service/node/TaskExecutor.cpp
     ${NEBULA_SRC}/service/server/LoadHandler.cpp
     ${NEBULA_SRC}/service/server/NodeSync.cpp
+    ${NEBULA_SRC}/service/server/QueryCache.cpp
     ${NEBULA_SRC}/service/server/QueryHandler.cpp
     ${nproto_srcs}
     ${ngrpc_srcs}
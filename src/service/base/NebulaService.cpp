@@ -57,11 +57,14 @@ using nebula::execution::PlanPtr;
 using nebula::execution::QueryContext;
 using nebula::execution::QueryStats;
 using nebula::execution::QueryWindow;
+using nebula::execution::io::BatchBlock;
 using nebula::ingest::BlockExpire;
 using nebula::ingest::IngestSpec;
 using nebula::memory::keyed::FlatBuffer;
 using nebula::memory::keyed::FlatRowCursor;
 using nebula::meta::AccessSpec;
+using nebula::meta::BlockSignature;
+using nebula::meta::BlockState;
 using nebula::meta::Column;
 using nebula::meta::ColumnProps;
 using nebula::meta::DataSource;
@@ -69,6 +72,7 @@ using nebula::meta::DataSpec;
 using nebula::meta::DBType;
 using nebula::meta::MetaConf;
 using nebula::meta::MetaDb;
+using nebula::meta::NNode;
 using nebula::meta::SpecState;
 using nebula::meta::TableSpec;
 using nebula::meta::TimeSpec;
@@ -76,6 +80,11 @@ using nebula::meta::TimeType;
 using nebula::surface::EmptyRowCursor;
 using nebula::surface::RowCursorPtr;
 using nebula::surface::RowData;
+using nebula::surface::eval::BoolHistogram;
+using nebula::surface::eval::Histogram;
+using nebula::surface::eval::HistVector;
+using nebula::surface::eval::IntHistogram;
+using nebula::surface::eval::RealHistogram;
 using nebula::type::Kind;
 using nebula::type::Schema;
 
@@ -213,18 +222,24 @@ flatbuffers::grpc::Message<QueryPlan> QuerySerde::serialize(const Query& q, cons
   }
 
   std::vector<uint32_t> sorts;
+  std::vector<uint8_t> descs;
   vector_reserve(sorts, q.sorts_.size(), "QuerySerde.serialize.sorts");
+  vector_reserve(descs, q.sortTypes_.size(), "QuerySerde.serialize.descs");
   for (auto i : q.sorts_) {
     sorts.push_back(i);
   }
 
+  for (auto t : q.sortTypes_) {
+    descs.push_back(t == SortType::DESC);
+  }
+
   auto tbl = q.table_->name();
   auto filter = Serde::serialize(*q.filter_);
   // customs serialization
   auto customs = Serde::serialize(q.customs_);
   auto request_offset = CreateQueryPlanDirect(
     mb, id.c_str(), tbl.c_str(), version.c_str(), filter.c_str(), customs.c_str(), &fields, &groups, &sorts,
-    q.sortType_ == SortType::DESC, q.limit_, window.first, window.second);
+    !descs.empty() && descs.front(), q.limit_, window.first, window.second, &descs);
   mb.Finish(request_offset);
   return mb.ReleaseMessage<QueryPlan>();
 }
@@ -286,8 +301,18 @@ nebula::api::dsl::Query QuerySerde::deserialize(
     q.sorts_ = std::move(sorts);
   }
 
-  // sort type
-  q.sortType_ = plan->desc() ? SortType::DESC : SortType::ASC;
+  // sort type of each sort column, falls back to single order if not present
+  {
+    auto ds = plan->descs();
+    const auto size = q.sorts_.size();
+    std::vector<SortType> types;
+    vector_reserve(types, size, "QuerySerde.deserialize.descs");
+    for (uint32_t i = 0; i < size; ++i) {
+      auto desc = (ds && i < ds->size()) ? ds->Get(i) : plan->desc();
+      types.push_back(desc ? SortType::DESC : SortType::ASC);
+    }
+    q.sortTypes_ = std::move(types);
+  }
 
   // set limit
   q.limit_ = plan->limit();
@@ -311,6 +336,10 @@ PlanPtr QuerySerde::from(Query& q, size_t start, size_t end, const std::string&
 }
 
 flatbuffers::grpc::Message<BatchRows> BatchSerde::serialize(const FlatBuffer& fb, const PlanPtr plan) {
+  return serialize(fb, plan->ctx().stats());
+}
+
+flatbuffers::grpc::Message<BatchRows> BatchSerde::serialize(const FlatBuffer& fb, const QueryStats& stats) {
   flatbuffers::grpc::MessageBuilder mb;
   auto schema = mb.CreateString(nebula::type::TypeSerializer::to(fb.schema()));
   int8_t* buffer;
@@ -318,7 +347,6 @@ flatbuffers::grpc::Message<BatchRows> BatchSerde::serialize(const FlatBuffer& fb
   auto bytes = mb.CreateUninitializedVector<int8_t>(size, &buffer);
   fb.serialize(buffer);
 
-  auto& stats = plan->ctx().stats();
   auto batch = CreateBatchRows(
     mb,
     schema,
@@ -337,6 +365,12 @@ RowCursorPtr BatchSerde::deserialize(const flatbuffers::grpc::Message<BatchRows>
   const auto schema = nebula::type::TypeSerializer::from(flatbuffers::GetString(ptr->schema()));
   N_ENSURE(ptr->type() == BatchType::BatchType_Flat, "only support flat for now");
 
+  // get stats of this compute node - threadsafe?
+  // blocks scanned without any row matched still count
+  auto nodeStats = ptr->stats();
+  stats.blocksScan += nodeStats->blocks_scan();
+  stats.rowsScan += nodeStats->rows_scan();
+
   // TODO(cao) - can we avoid this allocation?
   auto data = ptr->data();
   auto size = data->size();
@@ -349,13 +383,8 @@ RowCursorPtr BatchSerde::deserialize(const flatbuffers::grpc::Message<BatchRows>
   auto bytes = static_cast<NByte*>(Pool::getDefault().allocate(size));
   std::memcpy(bytes, data->data(), size);
 
-  // get stats of this compute node - threadsafe?
-  auto nodeStats = ptr->stats();
-  stats.blocksScan += nodeStats->blocks_scan();
-  stats.rowsScan += nodeStats->rows_scan();
-
   // TODO(cao) - It is not good, we're reference some data from batch but actually not owning it.
-  auto fb = std::make_unique<FlatBuffer>(schema, fields, bytes);
+  auto fb = std::make_unique<FlatBuffer>(schema, fields, bytes, size);
   return std::make_shared<FlatRowCursor>(std::move(fb));
 }
 
@@ -478,6 +507,73 @@ void globalExit() {
   curl_global_cleanup();
 }
 
+flatbuffers::Offset<DataBlock> StateSerde::serialize(flatbuffers::FlatBufferBuilder& fb, const BatchBlock& bb) {
+  // histogram in binary, column names are shared by all blocks
+  const auto& state = bb.state();
+  std::vector<flatbuffers::Offset<Hist>> bins;
+  vector_reserve(bins, state.histograms.size(), "StateSerde.serialize.bins");
+  for (const auto& h : state.histograms) {
+    auto name = fb.CreateSharedString(h->name);
+    if (auto ih = std::dynamic_pointer_cast<IntHistogram>(h)) {
+      bins.push_back(CreateHist(fb, HistType::HistType_Int, name, ih->count, 0, ih->v_min, ih->v_max, ih->v_sum));
+    } else if (auto rh = std::dynamic_pointer_cast<RealHistogram>(h)) {
+      bins.push_back(CreateHist(fb, HistType::HistType_Real, name, rh->count, 0, 0, 0, 0, rh->v_min, rh->v_max, rh->v_sum));
+    } else if (auto bh = std::dynamic_pointer_cast<BoolHistogram>(h)) {
+      bins.push_back(CreateHist(fb, HistType::HistType_Bool, name, bh->count, bh->trueValues));
+    } else {
+      bins.push_back(CreateHist(fb, HistType::HistType_Base, name, h->count));
+    }
+  }
+
+  return CreateDataBlockDirect(
+    fb, bb.table().c_str(), bb.version().c_str(), bb.getId(), bb.start(), bb.end(),
+    bb.spec().c_str(), bb.storage().c_str(), state.numRows, state.rawSize, nullptr, &bins, state.live);
+}
+
+std::shared_ptr<BatchBlock> StateSerde::deserialize(const DataBlock* db, const NNode& node) {
+  HistVector histograms;
+
+  // JSON histograms from nodes not upgraded yet
+  if (auto hists = db->hists()) {
+    vector_reserve(histograms, hists->size(), "StateSerde.deserialize.hists");
+    for (auto itr = hists->begin(); itr != hists->end(); ++itr) {
+      histograms.push_back(nebula::surface::eval::from(itr->str()));
+    }
+  }
+
+  if (auto bins = db->bins()) {
+    vector_reserve(histograms, bins->size(), "StateSerde.deserialize.bins");
+    for (auto itr = bins->begin(); itr != bins->end(); ++itr) {
+      auto name = itr->name()->str();
+      switch (itr->type()) {
+      case HistType::HistType_Int:
+        histograms.push_back(std::make_shared<IntHistogram>(name, itr->count(), itr->min(), itr->max(), itr->sum()));
+        break;
+      case HistType::HistType_Real:
+        histograms.push_back(std::make_shared<RealHistogram>(name, itr->count(), itr->dmin(), itr->dmax(), itr->dsum()));
+        break;
+      case HistType::HistType_Bool:
+        histograms.push_back(std::make_shared<BoolHistogram>(name, itr->count(), itr->trues()));
+        break;
+      default:
+        histograms.push_back(std::make_shared<Histogram>(name, itr->count()));
+        break;
+      }
+    }
+  }
+
+  return std::make_shared<BatchBlock>(
+    BlockSignature{
+      db->table()->str(),
+      db->version()->str(),
+      db->id(),
+      db->time_start(),
+      db->time_end(),
+      db->spec()->str() },
+    node,
+    BlockState{ db->rows(), db->raw_size(), std::move(histograms), db->live() });
+}
+
 } // namespace base
 } // namespace service
 } // namespace nebula
\ No newline at end of file
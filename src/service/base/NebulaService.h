@@ -24,6 +24,7 @@
 #include "api/dsl/Query.h"
 #include "common/Task.h"
 #include "execution/Context.h"
+#include "execution/io/BlockLoader.h"
 #include "ingest/IngestSpec.h"
 #include "memory/keyed/FlatBuffer.h"
 #include "meta/ClusterInfo.h"
@@ -161,6 +162,9 @@ class BatchSerde {
 public:
   static flatbuffers::grpc::Message<BatchRows> serialize(const nebula::memory::keyed::FlatBuffer&,
                                                          const nebula::execution::PlanPtr);
+  // serialize a partial result with stats of the blocks it covers
+  static flatbuffers::grpc::Message<BatchRows> serialize(const nebula::memory::keyed::FlatBuffer&,
+                                                         const nebula::execution::QueryStats&);
   static nebula::surface::RowCursorPtr deserialize(const flatbuffers::grpc::Message<BatchRows>*,
                                                    const nebula::surface::eval::Fields&,
                                                    nebula::execution::QueryStats&);
@@ -176,6 +180,18 @@ public:
   static nebula::common::Task deserialize(const flatbuffers::grpc::Message<TaskSpec>*);
 };
 
+/**
+ * A node state serde to transmit blocks of a node to server through flatbuffers,
+ * column histograms are encoded in binary.
+ */
+class StateSerde {
+public:
+  static flatbuffers::Offset<DataBlock> serialize(flatbuffers::FlatBufferBuilder&,
+                                                  const nebula::execution::io::BatchBlock&);
+  static std::shared_ptr<nebula::execution::io::BatchBlock> deserialize(const DataBlock*,
+                                                                        const nebula::meta::NNode&);
+};
+
 } // namespace base
 } // namespace service
 } // namespace nebula
\ No newline at end of file
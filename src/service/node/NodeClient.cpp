@@ -16,6 +16,8 @@
 
 #include "NodeClient.h"
 
+#include <fmt/format.h>
+
 #include "execution/BlockManager.h"
 
 /**
@@ -31,17 +33,18 @@ using nebula::common::vector_reserve;
 using nebula::execution::BlockManager;
 using nebula::execution::PhaseType;
 using nebula::execution::PlanPtr;
+using nebula::execution::QueryStats;
+using nebula::execution::SyncPoint;
+using nebula::execution::TableSpecSet;
 using nebula::execution::TableStates;
+using nebula::execution::core::Partial;
 using nebula::execution::io::BatchBlock;
-using nebula::meta::BlockSignature;
-using nebula::meta::BlockState;
 using nebula::service::base::BatchSerde;
 using nebula::service::base::QuerySerde;
+using nebula::service::base::StateSerde;
 using nebula::service::base::TaskSerde;
-using nebula::surface::EmptyRowCursor;
 using nebula::surface::RowCursorPtr;
 using nebula::surface::eval::Fields;
-using nebula::surface::eval::HistVector;
 
 void NodeClient::echo(const std::string& name) {
   // build request message through fb builder
@@ -119,18 +122,69 @@ folly::Future<RowCursorPtr> NodeClient::execute(const PlanPtr plan) {
       return;
     }
 
+    // a failed node is not counted as done
     LOG(ERROR) << "Node failure: " << status.error_message() << ". Node: " << addr;
-    // else return empty result set
-    p->setValue(EmptyRowCursor::instance());
+    p->setException(NException(fmt::format("node {0} failed: {1}", addr, status.error_message())));
+  });
+
+  return p->getFuture();
+}
+
+folly::Future<folly::Unit> NodeClient::stream(const PlanPtr plan, Partial sink) {
+  auto p = std::make_shared<folly::Promise<folly::Unit>>();
+  auto addr = node_.toString();
+
+  // same as execute, pass everything by value as the task outlives the client
+  pool_.add([p, addr, q = query_, plan, sink = std::move(sink)]() {
+    flatbuffers::grpc::Message<BatchRows> qr;
+
+    const auto& planId = plan->id();
+    const Fields& f = plan->fetch<PhaseType::PARTIAL>().fields();
+    auto qp = QuerySerde::serialize(*q, planId, plan->getWindow(), plan->tableVersion());
+    grpc::ClientContext context;
+    auto channel = ConnectionPool::init()->connection(addr);
+    N_ENSURE(channel != nullptr, "requires a valid channel");
+    auto stub = nebula::service::NodeServer::NewStub(channel);
+    LOG(INFO) << "Stream query remotely: node=" << addr << ", plan=" << planId;
+    auto reader = stub->QueryStream(&context, qp);
+
+    // every partial result carries stats of its own blocks
+    size_t batches = 0;
+    bool stopped = false;
+    while (reader->Read(&qr)) {
+      QueryStats stats;
+      auto fb = BatchSerde::deserialize(&qr, f, stats);
+      ++batches;
+      VLOG(1) << "Received partial batch as number of rows: " << fb->size();
+      if (!sink(fb, stats)) {
+        // receiver doesn't want more, let node stop computing too
+        context.TryCancel();
+        stopped = true;
+        break;
+      }
+    }
+
+    // a failed or incomplete node (eg. blocks timed out) is not done, its partial results are approximate
+    auto status = reader->Finish();
+    if (!status.ok() && !stopped) {
+      LOG(ERROR) << "Node failure: " << status.error_message() << ". Node: " << addr << ", batches: " << batches;
+      p->setException(NException(fmt::format("node {0} failed: {1}", addr, status.error_message())));
+      return;
+    }
+
+    p->setValue();
   });
 
   return p->getFuture();
 }
 
 void NodeClient::update() {
-  // build request message through fb builder
+  auto bm = BlockManager::init();
+
+  // build request message through fb builder, carrying our last sync point of this node
+  const auto sync = bm->sync(node_);
   flatbuffers::grpc::MessageBuilder mb;
-  mb.Finish(nebula::service::CreateNodeStateRequest(mb, 1));
+  mb.Finish(nebula::service::CreateNodeStateRequest(mb, 1, sync.first, sync.second));
   auto nsRequest = mb.ReleaseMessage<NodeStateRequest>();
 
   // a response message placeholder
@@ -138,51 +192,46 @@ void NodeClient::update() {
 
   grpc::ClientContext context;
   auto status = stub_->Poll(&context, nsRequest, &nsReply);
-  auto bm = BlockManager::init();
 
   if (status.ok()) {
     const NodeStateReply* response = nsReply.GetRoot();
     auto blocks = response->blocks();
     size_t size = blocks->size();
 
-    // update into current server block management
-    TableStates states;
-    for (size_t i = 0; i < size; ++i) {
-      const DataBlock* db = blocks->Get(i);
-      // convert serialized histograms
-      auto hists = db->hists();
-      auto histSize = hists->size();
-      HistVector histograms;
-      if (histSize > 0) {
-        vector_reserve(histograms, histSize, "NodeClient.udpate");
-        std::transform(hists->begin(), hists->end(),
-                       std::back_inserter(histograms),
-                       [](auto h) { return nebula::surface::eval::from(h->str()); });
-      }
-      auto block = std::make_shared<BatchBlock>(
-        BlockSignature{
-          db->table()->str(),
-          db->version()->str(),
-          db->id(),
-          db->time_start(),
-          db->time_end(),
-          db->spec()->str() },
-        node_,
-        BlockState{ db->rows(), db->raw_size(), std::move(histograms) });
-
-      // add this block in the new states
-      BlockManager::addBlock(states, block);
-    }
-
     // append empty spec from this node
     auto emptySpecs = response->emptySpecs();
     for (auto itr = emptySpecs->begin(); itr != emptySpecs->end(); ++itr) {
       bm->recordEmptySpec(itr->str());
     }
 
-    // TODO(cao): only swap when there is change?
-    // swap the new states in
-    bm->swap(node_, states);
+    const SyncPoint point{ response->epoch(), response->generation() };
+
+    // apply changes since last sync in place
+    if (response->delta()) {
+      TableSpecSet removed;
+      if (auto specs = response->removed()) {
+        for (auto itr = specs->begin(); itr != specs->end(); ++itr) {
+          removed.emplace(itr->tbl()->str(), itr->spec()->str());
+        }
+      }
+
+      std::vector<std::shared_ptr<BatchBlock>> added;
+      vector_reserve(added, size, "NodeClient.update");
+      for (size_t i = 0; i < size; ++i) {
+        added.push_back(StateSerde::deserialize(blocks->Get(i), node_));
+      }
+
+      bm->apply(node_, removed, added, point);
+      return;
+    }
+
+    // full snapshot, swap the new states in
+    TableStates states;
+    for (size_t i = 0; i < size; ++i) {
+      BlockManager::addBlock(states, StateSerde::deserialize(blocks->Get(i), node_));
+    }
+
+    bm->swap(node_, states, point);
     return;
   }
 
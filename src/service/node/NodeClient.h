@@ -60,6 +60,10 @@ public:
   // execute a plan on remote node
   virtual folly::Future<nebula::surface::RowCursorPtr> execute(const nebula::execution::PlanPtr plan) override;
 
+  // execute a plan on remote node and receive its partial results as they are streamed back
+  virtual folly::Future<folly::Unit> stream(const nebula::execution::PlanPtr plan,
+                                            nebula::execution::core::Partial sink) override;
+
   // pull node state
   virtual void update() override;
 
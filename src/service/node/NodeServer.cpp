@@ -31,6 +31,7 @@
 #include "execution/core/NodeExecutor.h"
 #include "execution/serde/RowCursorSerde.h"
 #include "service/client/NebulaClient.h"
+#include "storage/kafka/KafkaTopic.h"
 #include "surface/DataSurface.h"
 
 DEFINE_int32(MAX_MSG_SIZE, 1073741824, "max message size sending between node and server, default to 1G");
@@ -49,11 +50,13 @@ using nebula::common::TaskType;
 using nebula::common::vector_reserve;
 using nebula::execution::BlockManager;
 using nebula::execution::PhaseType;
+using nebula::execution::QueryStats;
 using nebula::execution::core::NodeExecutor;
 using nebula::execution::io::BatchBlock;
 using nebula::memory::keyed::FlatBuffer;
 using nebula::service::base::BatchSerde;
 using nebula::service::base::QuerySerde;
+using nebula::service::base::StateSerde;
 using nebula::service::base::TaskSerde;
 using nebula::surface::RowCursorPtr;
 
@@ -109,9 +112,7 @@ grpc::Status NodeServerImpl::Echos(
   return grpc::Status::OK;
 }
 
-// TODO(cao) - we may want to change this endpoint as streaming
-// So that we don't need to do aggregation here, instead push all block executor results to server for aggregation.
-// Single aggregation - perf?
+// Single aggregation of all blocks - see QueryStream for partial results pushed as blocks finish.
 grpc::Status NodeServerImpl::Query(
   grpc::ServerContext*,
   const flatbuffers::grpc::Message<QueryPlan>* query,
@@ -143,6 +144,40 @@ grpc::Status NodeServerImpl::Query(
   return grpc::Status::OK;
 }
 
+// streaming query - every group of finished blocks is merged and sent back as a partial result
+// so that server can merge them progressively rather than waiting for the slowest block.
+grpc::Status NodeServerImpl::QueryStream(
+  grpc::ServerContext* ctx,
+  const flatbuffers::grpc::Message<QueryPlan>* query,
+  grpc::ServerWriter<flatbuffers::grpc::Message<BatchRows>>* writer) {
+  try {
+    auto r = query->GetRoot();
+    auto q = QuerySerde::deserialize(tableService_, query);
+    auto plan = QuerySerde::from(q, r->tstart(), r->tend(), flatbuffers::GetString(r->version()));
+
+    NodeExecutor executor(BlockManager::init());
+    const auto& phase = plan->fetch<PhaseType::PARTIAL>();
+    auto complete = executor.stream(threadPool_, plan, [ctx, writer, &phase](RowCursorPtr cursor, const QueryStats& stats) {
+      // server returned already, no need to send more
+      if (ctx->IsCancelled()) {
+        return false;
+      }
+
+      const auto& buffer = nebula::execution::serde::asBuffer(*cursor, phase.outputSchema(), phase.fields());
+      return writer->Write(BatchSerde::serialize(*buffer, stats));
+    });
+
+    // results sent are approximate, tell server not to take this node as done
+    if (!complete) {
+      return grpc::Status(grpc::StatusCode::ABORTED, "incomplete results: blocks failed or timed out");
+    }
+  } catch (const std::exception& exp) {
+    return grpc::Status(grpc::StatusCode::INTERNAL, exp.what());
+  }
+
+  return grpc::Status::OK;
+}
+
 // poll block status of a node
 grpc::Status NodeServerImpl::Poll(
   grpc::ServerContext*,
@@ -163,24 +198,17 @@ grpc::Status NodeServerImpl::Poll(
   const auto bm = BlockManager::init();
   flatbuffers::grpc::MessageBuilder mb;
   std::vector<flatbuffers::Offset<DataBlock>> db;
-  vector_reserve(db, bm->numBlocks(), "NodeServer.Poll");
-  const auto& states = bm->states();
-  for (const auto& s : states) {
-    s.second->iterate([&mb, &db](const BatchBlock& bb) {
-      const auto& state = bb.state();
-      // serialize histograms
-      std::vector<flatbuffers::Offset<flatbuffers::String>> hists;
-      vector_reserve(hists, state.histograms.size(), "NodeServer.Poll.Hists");
-      std::transform(state.histograms.begin(), state.histograms.end(),
-                     std::back_inserter(hists),
-                     [&mb](auto h) {
-                       return mb.CreateString(h->toString());
-                     });
-      db.push_back(CreateDataBlockDirect(
-        mb, bb.table().c_str(), bb.version().c_str(), bb.getId(), bb.start(), bb.end(),
-        bb.spec().c_str(), bb.storage().c_str(), state.numRows, state.rawSize, &hists));
+  std::vector<flatbuffers::Offset<Spec>> removed;
+
+  // only changes since last sync of the requester if the node still has them
+  auto result = bm->visit(
+    { request->epoch(), request->generation() },
+    [&mb, &removed](const std::string& table, const std::string& spec) {
+      removed.push_back(CreateSpecDirect(mb, table.c_str(), spec.c_str()));
+    },
+    [&mb, &db](const BatchBlock& bb) {
+      db.push_back(StateSerde::serialize(mb, bb));
     });
-  }
 
   // empty specs
   const auto& specSet = bm->emptySpecs();
@@ -190,7 +218,8 @@ grpc::Status NodeServerImpl::Poll(
     specs.push_back(mb.CreateString(spec));
   }
 
-  mb.Finish(CreateNodeStateReplyDirect(mb, &db, &specs));
+  const auto& sync = result.first;
+  mb.Finish(CreateNodeStateReplyDirect(mb, &db, &specs, sync.first, sync.second, result.second, &removed));
 
   // The `ReleaseMessage<T>()` function detaches the message from the
   // builder, so we can transfer the resopnse to gRPC while simultaneously
@@ -289,6 +318,9 @@ void RunServer() {
   auto shutdownHandler = [&server, &taskScheduler]() {
     LOG(INFO) << "Shutting down current node...";
 
+    // release threads waiting on live kafka segments
+    nebula::storage::kafka::KafkaTopic::stopTail();
+
     // stop scheduler
     taskScheduler.stop();
 
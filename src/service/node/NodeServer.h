@@ -49,6 +49,12 @@ class NodeServerImpl final : public NodeServer::Service {
     flatbuffers::grpc::Message<BatchRows>*)
     override;
 
+  virtual grpc::Status QueryStream(
+    grpc::ServerContext*,
+    const flatbuffers::grpc::Message<QueryPlan>*,
+    grpc::ServerWriter<flatbuffers::grpc::Message<BatchRows>>*)
+    override;
+
   virtual grpc::Status Poll(
     grpc::ServerContext*,
     const flatbuffers::grpc::Message<NodeStateRequest>*,
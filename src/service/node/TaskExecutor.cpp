@@ -144,6 +144,11 @@ bool TaskExecutor::process(const Task& task) {
     // TODO(cao): need a way to differentiate empty data vs retryable failure.
     // process a new task - enroll its table if its first time
     const auto numBlocks = is->work();
+    if (is->retry()) {
+      LOG(WARNING) << "Spec not fully ingested, to be retried: " << specId;
+      return false;
+    }
+
     if (numBlocks == 0) {
       bm->recordEmptySpec(specId);
     }
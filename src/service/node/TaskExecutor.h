@@ -55,8 +55,9 @@ private:
   inline void setState(nebula::common::TaskType type,
                        const std::string& sign,
                        nebula::common::TaskState state) noexcept {
-    // expiration task can be issued repeatedly
-    if (type == nebula::common::TaskType::EXPIRATION) {
+    // expiration task can be issued repeatedly, so does a failed ingestion to be retried
+    if (type == nebula::common::TaskType::EXPIRATION
+        || (type == nebula::common::TaskType::INGESTION && state == nebula::common::TaskState::FAILED)) {
       state_.erase(sign);
       return;
     }
@@ -351,6 +351,23 @@ Status V1ServiceImpl::Query(ServerContext* ctx, const QueryRequest* request, Que
   }
 
   LOG(INFO) << "Compiled a query to table: " << tableName;
+
+  // serve from result cache if the same plan ran against the same block set
+  const auto cacheKey = QueryCache::key(*plan);
+  auto version = BlockManager::init()->version(tableName);
+  if (!cacheKey.empty()) {
+    auto cached = cache_.get(cacheKey, version);
+    if (cached) {
+      auto stats = reply->mutable_stats();
+      stats->CopyFrom(cached->stats);
+      stats->set_querytimems(tick.elapsedMs());
+      reply->set_type(DataType::JSON);
+      reply->set_data(cached->data);
+      LOG(INFO) << "[Query] user=" << user << ", table=" << tableName << ", cache hit";
+      return Status::OK;
+    }
+  }
+
   // create a remote connector and execute the query plan
   auto connector = std::make_shared<RemoteNodeConnector>(query);
   RowCursorPtr result = handler_.query(threadPool_, plan, connector, error);
@@ -368,11 +385,18 @@ Status V1ServiceImpl::Query(ServerContext* ctx, const QueryRequest* request, Que
   stats->set_rowsscanned(queryStats.rowsScan);
   stats->set_blocksscanned(queryStats.blocksScan);
   stats->set_rowsreturn(queryStats.rowsRet);
+  stats->set_nodesqueried(queryStats.nodesQuery);
+  stats->set_nodescompleted(queryStats.nodesDone);
   tick.reset();
 
   // User/client can specify what kind of format of result it expects
   reply->set_type(DataType::JSON);
   auto payload = ServiceProperties::jsonify(result, plan->getOutputSchema());
+  // approximate result returned before all nodes complete is not cached,
+  // a node failed or timed out is not done (see ServerExecutor).
+  if (!cacheKey.empty() && queryStats.nodesDone == queryStats.nodesQuery) {
+    cache_.put(cacheKey, std::move(version), *stats, payload);
+  }
   reply->set_data(std::move(payload));
 
   // ttime: transfer time = result serialization time
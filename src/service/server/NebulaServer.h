@@ -19,6 +19,7 @@
 #include <grpcpp/grpcpp.h>
 
 #include "LoadHandler.h"
+#include "QueryCache.h"
 #include "QueryHandler.h"
 #include "meta/TestTable.h"
 #include "nebula.grpc.pb.h"
@@ -59,6 +60,7 @@ private:
   grpc::Status replyError(nebula::service::base::ErrorCode, QueryResponse*, size_t) const;
   folly::CPUThreadPoolExecutor threadPool_;
   LoadHandler loadHandler_;
+  QueryCache cache_;
   std::function<void()> shutdownHandler_;
 };
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryCache.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <gflags/gflags.h>
+#include <vector>
+
+#include "type/Serde.h"
+
+/**
+ * Implement query result cache.
+ */
+DEFINE_uint32(QUERY_CACHE_ENTRIES, 256, "max number of query results cached in server, 0 to disable");
+DEFINE_uint32(QUERY_CACHE_MB, 256, "max memory in MB used by cached query results in server");
+
+namespace nebula {
+namespace service {
+namespace server {
+
+using nebula::execution::ExecutionPlan;
+using nebula::execution::PhaseType;
+
+QueryCache::QueryCache()
+  : QueryCache(FLAGS_QUERY_CACHE_ENTRIES, FLAGS_QUERY_CACHE_MB * 1024 * 1024ul) {}
+
+std::string QueryCache::key(const ExecutionPlan& plan) {
+  const auto& block = plan.fetch<PhaseType::COMPUTE>();
+
+  // script signature is only its column name, not the script itself
+  if (block.hasScript()) {
+    return {};
+  }
+
+  const auto& window = plan.getWindow();
+  auto key = fmt::format("{0}@{1}[{2},{3}]|F:{4}|S:",
+                         block.table(),
+                         plan.tableVersion(),
+                         window.first,
+                         window.second,
+                         block.filter().signature());
+
+  // select fields in order
+  for (const auto& f : block.fields()) {
+    key.append(f->signature()).append(",");
+  }
+
+  // keys, sorts with their orders and limit
+  key.append(fmt::format("|K:{0}|O:", nebula::execution::join(block.keys())));
+  const auto& sorts = block.sorts();
+  const auto& descs = block.descs();
+  for (size_t i = 0; i < sorts.size(); ++i) {
+    key.append(fmt::format("{0}{1},", sorts.at(i), descs.at(i) ? "-" : "+"));
+  }
+  key.append(fmt::format("|L:{0}", block.top()));
+
+  // output schema carries all alias names
+  key.append("|T:").append(nebula::type::TypeSerializer::to(plan.getOutputSchema()));
+
+  // access rules are applied by user groups, queries of different groups can't share results
+  const auto& groups = plan.ctx().groups();
+  std::vector<std::string> sorted{ groups.begin(), groups.end() };
+  std::sort(sorted.begin(), sorted.end());
+  key.append("|G:");
+  for (const auto& g : sorted) {
+    key.append(g).append(",");
+  }
+
+  return key;
+}
+
+std::shared_ptr<const CachedResult> QueryCache::get(const std::string& key, const BlockVersion& version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+
+  auto it = found->second;
+
+  // block set of the table changed since the result cached
+  if (it->second->version != version) {
+    erase(it);
+    return nullptr;
+  }
+
+  // move it to the front as most recently used
+  entries_.splice(entries_.begin(), entries_, it);
+  return it->second;
+}
+
+void QueryCache::put(const std::string& key, BlockVersion version, const Statistics& stats, const std::string& data) {
+  auto result = std::make_shared<const CachedResult>(std::move(version), stats, data);
+  const auto size = result->bytes();
+
+  // single result larger than whole cache is not worth it
+  if (capacity_ == 0 || size > maxBytes_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    erase(found->second);
+  }
+
+  // evict from the tail until new entry fits
+  while (!entries_.empty() && (index_.size() >= capacity_ || bytes_ + size > maxBytes_)) {
+    erase(std::prev(entries_.end()));
+  }
+
+  entries_.emplace_front(key, std::move(result));
+  index_[key] = entries_.begin();
+  bytes_ += size;
+}
+
+void QueryCache::erase(Entries::iterator it) {
+  bytes_ -= it->second->bytes();
+  index_.erase(it->first);
+  entries_.erase(it);
+}
+
+} // namespace server
+} // namespace service
+} // namespace nebula
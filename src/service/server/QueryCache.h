@@ -0,0 +1,99 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+
+#include "common/Hash.h"
+#include "execution/BlockManager.h"
+#include "execution/ExecutionPlan.h"
+#include "nebula.grpc.pb.h"
+
+/**
+ * A query result cache in server side.
+ * Dashboards keep sending the same queries over data that rarely changes,
+ * so we keep serialized results keyed by a normalized plan signature and
+ * validate every hit against the version of the table's block set,
+ * an entry is dropped once any node holding the table changes its blocks.
+ */
+namespace nebula {
+namespace service {
+namespace server {
+
+struct CachedResult {
+  explicit CachedResult(nebula::execution::BlockVersion v, const Statistics& s, const std::string& d)
+    : version{ std::move(v) }, stats{ s }, data{ d } {}
+
+  inline size_t bytes() const noexcept {
+    return data.size() + sizeof(CachedResult) + version.size() * sizeof(nebula::execution::BlockVersion::value_type);
+  }
+
+  // version of the table block set when the result is produced
+  nebula::execution::BlockVersion version;
+  Statistics stats;
+  std::string data;
+};
+
+class QueryCache final {
+  using Entry = std::pair<std::string, std::shared_ptr<const CachedResult>>;
+  using Entries = std::list<Entry>;
+
+public:
+  // bounds are configured by flags
+  QueryCache();
+  QueryCache(size_t capacity, size_t maxBytes)
+    : capacity_{ capacity }, maxBytes_{ maxBytes }, bytes_{ 0 } {}
+  virtual ~QueryCache() = default;
+
+  // build normalized cache key of a compiled plan,
+  // empty key means the plan is not cacheable (eg. custom scripts).
+  static std::string key(const nebula::execution::ExecutionPlan&);
+
+  // look up the cache, an entry of stale version is evicted and nullptr returned.
+  std::shared_ptr<const CachedResult> get(const std::string&, const nebula::execution::BlockVersion&);
+
+  // put a result into cache, evict least recently used ones to honor the bounds.
+  void put(const std::string&, nebula::execution::BlockVersion, const Statistics&, const std::string&);
+
+  inline size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+  }
+
+  inline size_t bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+private:
+  void erase(Entries::iterator);
+
+private:
+  const size_t capacity_;
+  const size_t maxBytes_;
+  size_t bytes_;
+  // front is the most recently used entry
+  Entries entries_;
+  nebula::common::unordered_map<std::string, Entries::iterator> index_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace server
+} // namespace service
+} // namespace nebula
@@ -14,9 +14,11 @@
  * limitations under the License.
  */
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <thread>
 
 #include "api/test/Test.hpp"
 #include "common/Folly.h"
@@ -28,11 +30,14 @@
 #include "meta/TestTable.h"
 #include "service/base/NebulaService.h"
 #include "service/node/RemoteNodeConnector.h"
+#include "service/server/QueryCache.h"
 #include "service/server/QueryHandler.h"
 #include "surface/DataSurface.h"
 #include "surface/MockSurface.h"
 #include "type/Serde.h"
 
+DECLARE_uint64(NODE_PRUNING_SYNC_MS);
+
 namespace nebula {
 namespace service {
 namespace test {
@@ -40,6 +45,7 @@ namespace test {
 using namespace nebula::api::dsl;
 using nebula::common::Cursor;
 using nebula::common::Evidence;
+using nebula::execution::BlockVersion;
 using nebula::execution::QueryContext;
 using nebula::execution::core::NodeConnector;
 using nebula::execution::core::ServerExecutor;
@@ -49,6 +55,7 @@ using nebula::meta::TestTable;
 using nebula::service::base::ErrorCode;
 using nebula::service::base::QuerySerde;
 using nebula::service::base::ServiceProperties;
+using nebula::service::server::QueryCache;
 using nebula::service::server::QueryHandler;
 using nebula::surface::EmptyRowCursor;
 using nebula::surface::RowCursorPtr;
@@ -370,6 +377,269 @@ TEST(ServiceTest, TestJsonifyEmptyCursor) {
   EXPECT_EQ(json, "[]");
 }
 
+TEST(ServiceTest, TestQueryCache) {
+  auto data = nebula::api::test::genData();
+  auto tableName = std::get<0>(data);
+  auto start = std::get<1>(data);
+  auto end = std::get<2>(data);
+
+  QueryHandler handler;
+  TestTable testTable;
+  auto compile = [&](const std::string& value, const std::string& version) {
+    QueryRequest request;
+    request.set_table(tableName);
+    request.set_start(start);
+    request.set_end(end);
+    auto expr = request.mutable_filtera()->add_expression();
+    expr->set_column("event");
+    expr->set_op(Operation::EQ);
+    expr->add_value(value);
+    request.add_dimension("event");
+    auto metric = request.add_metric();
+    metric->set_column("value");
+    metric->set_method(Rollup::COUNT);
+
+    ErrorCode err = ErrorCode::NONE;
+    auto query = handler.build(testTable, request, err);
+    auto plan = handler.compile(query, version, { start, end }, QueryContext::def(), err);
+    EXPECT_EQ(err, ErrorCode::NONE);
+    return QueryCache::key(*plan);
+  };
+
+  // same query gets the same key, any difference in plan or version changes it
+  auto k1 = compile("N1", "v1");
+  EXPECT_FALSE(k1.empty());
+  EXPECT_EQ(k1, compile("N1", "v1"));
+  auto k2 = compile("N2", "v1");
+  EXPECT_NE(k1, k2);
+  auto k3 = compile("N1", "v2");
+  EXPECT_NE(k1, k3);
+
+  // block set versions by node sync points
+  const BlockVersion v1{ { "10.0.0.1:9199", { 1, 1 } } };
+  const BlockVersion v2{ { "10.0.0.1:9199", { 1, 2 } } };
+
+  QueryCache cache(2, 1024 * 1024);
+  Statistics stats;
+  stats.set_rowsscanned(10);
+  cache.put(k1, v1, stats, "[1]");
+  cache.put(k2, v1, stats, "[2]");
+
+  // a hit returns cached payload and stats
+  auto r1 = cache.get(k1, v1);
+  EXPECT_NE(r1, nullptr);
+  EXPECT_EQ(r1->data, "[1]");
+  EXPECT_EQ(r1->stats.rowsscanned(), 10);
+
+  // k2 is least recently used and evicted by capacity
+  cache.put(k3, v1, stats, "[3]");
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.get(k2, v1), nullptr);
+
+  // block set changed, entry is invalidated
+  EXPECT_EQ(cache.get(k1, v2), nullptr);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_NE(cache.get(k3, v1), nullptr);
+
+  // byte bound is honored
+  QueryCache small(8, 2 * sizeof(nebula::service::server::CachedResult) + 10);
+  small.put(k1, v1, stats, std::string(8, 'a'));
+  small.put(k2, v1, stats, std::string(8, 'b'));
+  EXPECT_EQ(small.size(), 1);
+  EXPECT_NE(small.get(k2, v1), nullptr);
+}
+
+TEST(ServiceTest, TestNodeStateSync) {
+  using nebula::execution::BlockManager;
+  using nebula::execution::SyncPoint;
+  using nebula::execution::TableSpecSet;
+  using nebula::execution::io::BatchBlock;
+  using nebula::meta::BlockSignature;
+  using nebula::meta::NNode;
+  using nebula::meta::NRole;
+  using nebula::service::base::StateSerde;
+
+  auto bm = BlockManager::init();
+  TestTable testTable;
+  const auto table = testTable.name() + "_sync";
+
+  // visit changes since given sync point, only blocks of the test table are collected
+  TableSpecSet removed;
+  std::vector<std::shared_ptr<BatchBlock>> added;
+  NNode node{ NRole::NODE, "10.0.0.1", 9199 };
+  auto visit = [&](SyncPoint from) {
+    removed.clear();
+    added.clear();
+    flatbuffers::FlatBufferBuilder fb;
+    return bm->visit(
+      from,
+      [&](const std::string& t, const std::string& spec) {
+        removed.emplace(t, spec);
+      },
+      [&](const BatchBlock& bb) {
+        if (bb.table() == table) {
+          // round trip through node state serde
+          fb.Finish(StateSerde::serialize(fb, bb));
+          auto block = StateSerde::deserialize(flatbuffers::GetRoot<DataBlock>(fb.GetBufferPointer()), node);
+          EXPECT_EQ(block->spec(), bb.spec());
+          EXPECT_EQ(block->state().numRows, bb.state().numRows);
+          EXPECT_EQ(block->state().live, bb.state().live);
+          const auto& hists = bb.state().histograms;
+          EXPECT_EQ(block->state().histograms.size(), hists.size());
+          for (size_t i = 0; i < hists.size(); ++i) {
+            EXPECT_EQ(block->state().histograms.at(i)->toString(), hists.at(i)->toString());
+          }
+          added.push_back(block);
+          fb.Clear();
+        }
+      });
+  };
+
+  // a requester knowing nothing gets all blocks
+  auto s0 = visit({ 0, 0 });
+  EXPECT_FALSE(s0.second);
+  EXPECT_EQ(added.size(), 0);
+
+  bm->add(BlockSignature{ table, "v1", 1, 0, 10, "a" });
+  bm->add(BlockSignature{ table, "v1", 2, 0, 10, "b" });
+
+  // blocks added since last sync
+  auto s1 = visit(s0.first);
+  EXPECT_TRUE(s1.second);
+  EXPECT_EQ(removed.size(), 0);
+  EXPECT_EQ(added.size(), 2);
+  EXPECT_EQ(s1.first.first, s0.first.first);
+  EXPECT_GT(s1.first.second, s0.first.second);
+  bm->apply(node, removed, added, s1.first);
+  EXPECT_EQ(bm->sync(node), s1.first);
+  EXPECT_EQ(bm->query(table).size(), 2);
+
+  // version of the table block set moves with sync point of every node holding it
+  const auto v1 = bm->version(table);
+  EXPECT_NE(std::find(v1.begin(), v1.end(), std::make_pair(node.toString(), s1.first)), v1.end());
+
+  // a spec removed after added is only a removal in delta
+  bm->add(BlockSignature{ table, "v1", 3, 0, 10, "c" });
+  bm->removeBySpec(table, "a");
+  bm->removeBySpec(table, "c");
+  auto s2 = visit(s1.first);
+  EXPECT_TRUE(s2.second);
+  EXPECT_EQ(removed.size(), 2);
+  EXPECT_EQ(removed.count({ table, "a" }), 1);
+  EXPECT_EQ(removed.count({ table, "c" }), 1);
+  EXPECT_EQ(added.size(), 0);
+  bm->apply(node, removed, added, s2.first);
+  EXPECT_EQ(bm->sync(node), s2.first);
+  const auto v2 = bm->version(table);
+  EXPECT_NE(v2, v1);
+  EXPECT_NE(std::find(v2.begin(), v2.end(), std::make_pair(node.toString(), s2.first)), v2.end());
+
+  // nothing changed
+  auto s3 = visit(s2.first);
+  EXPECT_TRUE(s3.second);
+  EXPECT_EQ(s3.first, s2.first);
+  EXPECT_EQ(removed.size() + added.size(), 0);
+
+  // a different process or a future generation gets full snapshot
+  auto s4 = visit({ s2.first.first + 1, s2.first.second });
+  EXPECT_FALSE(s4.second);
+  EXPECT_EQ(added.size(), 1);
+  EXPECT_EQ(added.front()->spec(), "b");
+  EXPECT_FALSE(visit({ s2.first.first, s2.first.second + 1 }).second);
+
+  // last block of the table is removed from the node
+  bm->removeBySpec(table, "b");
+  visit(s2.first);
+  bm->apply(node, removed, added, s2.first);
+  for (const auto& n : bm->query(table)) {
+    EXPECT_NE(n.toString(), node.toString());
+  }
+  bm->removeNode(node.toString());
+  EXPECT_EQ(bm->sync(node), SyncPoint(0, 0));
+}
+
+TEST(ServiceTest, TestNodePruning) {
+  using nebula::execution::BlockManager;
+  using nebula::execution::io::BatchBlock;
+  using nebula::meta::BlockSignature;
+  using nebula::meta::BlockState;
+  using nebula::meta::NNode;
+  using nebula::meta::NRole;
+  using nebula::surface::eval::RealHistogram;
+
+  auto data = nebula::api::test::genData();
+  auto tableName = std::get<0>(data);
+  auto start = std::get<1>(data);
+  auto end = std::get<2>(data);
+
+  // remote nodes known by synced block metadata only
+  auto bm = BlockManager::init();
+  NNode low{ NRole::NODE, "10.0.0.2", 9199 };
+  NNode high{ NRole::NODE, "10.0.0.3", 9199 };
+  NNode past{ NRole::NODE, "10.0.0.4", 9199 };
+  NNode other{ NRole::NODE, "10.0.0.5", 9199 };
+  NNode tail{ NRole::NODE, "10.0.0.6", 9199 };
+  auto remote = [&](const NNode& node, const std::string& table, int64_t s, int64_t e, double min, double max, bool live) {
+    nebula::surface::eval::HistVector hists{ std::make_shared<RealHistogram>("weight", 10, min, max, 0) };
+    bm->add(std::make_shared<BatchBlock>(
+      BlockSignature{ table, "v1", 1, s, e, "remote" }, node, BlockState{ 10, 100, hists, live }));
+  };
+  remote(low, tableName, start, end, 0, 10, false);
+  remote(high, tableName, start, end, 100, 200, false);
+  remote(past, tableName, start - 1000, start - 1, 100, 200, false);
+  // the table may be ingested into a node since last sync
+  remote(other, tableName + "_other", start, end, 0, 10, false);
+  // a live block may get rows out of its synced window and histograms
+  remote(tail, tableName, start - 1000, start - 1, 0, 10, true);
+
+  QueryHandler handler;
+  TestTable testTable;
+  auto prune = [&](const std::string& value) {
+    QueryRequest request;
+    request.set_table(tableName);
+    request.set_start(start);
+    request.set_end(end);
+    auto expr = request.mutable_filtera()->add_expression();
+    expr->set_column("weight");
+    expr->set_op(Operation::MORE);
+    expr->add_value(value);
+    auto metric = request.add_metric();
+    metric->set_column("value");
+    metric->set_method(Rollup::COUNT);
+
+    ErrorCode err = ErrorCode::NONE;
+    auto query = handler.build(testTable, request, err);
+    auto plan = handler.compile(query, "v1", { start, end }, QueryContext::def(), err);
+    EXPECT_EQ(err, ErrorCode::NONE);
+
+    std::vector<std::string> nodes;
+    for (const auto& n : bm->prune(testTable, plan, { low, high, past, other, tail })) {
+      nodes.push_back(n.toString());
+    }
+
+    return nodes;
+  };
+
+  // node out of query window never shows up, node out of value range is skipped,
+  // node without state of the table or having live blocks is always kept
+  EXPECT_THAT(prune("50"), testing::ElementsAre(high.toString(), other.toString(), tail.toString()));
+  EXPECT_THAT(prune("5"), testing::ElementsAre(low.toString(), high.toString(), other.toString(), tail.toString()));
+  EXPECT_THAT(prune("500"), testing::ElementsAre(other.toString(), tail.toString()));
+
+  // node states not synced recently are not trusted
+  const auto age = FLAGS_NODE_PRUNING_SYNC_MS;
+  FLAGS_NODE_PRUNING_SYNC_MS = 0;
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  EXPECT_EQ(prune("500").size(), 5);
+  FLAGS_NODE_PRUNING_SYNC_MS = age;
+
+  bm->removeNode(low.toString());
+  bm->removeNode(high.toString());
+  bm->removeNode(past.toString());
+  bm->removeNode(other.toString());
+  bm->removeNode(tail.toString());
+}
+
 } // namespace test
 } // namespace service
 } // namespace nebula
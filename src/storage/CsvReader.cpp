@@ -16,6 +16,9 @@
 #include <sstream>
 
 #include "CsvReader.h"
+
+#include <cstring>
+
 #include "common/Errors.h"
 
 /**
@@ -145,5 +148,211 @@ std::istream& operator>>(std::istream& is, DevNull&) {
   return is;
 }
 
+std::vector<std::string> csvHeader(const std::vector<std::string>& raw) {
+  std::vector<std::string> names;
+  names.reserve(raw.size());
+  for (size_t i = 0, size = raw.size(); i < size; ++i) {
+    auto name = raw.at(i);
+    if (name.empty()) {
+      name = fmt::format("col_{0}", i);
+    }
+
+    names.emplace_back(nebula::common::normalize(name));
+  }
+
+  // dedup column names
+  dedup(names);
+  return names;
+}
+
+size_t csvColumns(const std::vector<std::string>& names,
+                  const std::vector<std::string>& columns,
+                  nebula::common::unordered_map<std::string, size_t>& map) {
+  const auto hasSchema = columns.size() > 0;
+  size_t numCols = 0;
+  for (size_t i = 0, size = names.size(); i < size; ++i) {
+    const auto& name = names.at(i);
+    // notes: columns could be partial of all data and it should be already deduped
+    // example:
+    // 1.a csv data has 10 columns, but only 5 columns are provided in the schema
+    if (!hasSchema || std::find(columns.begin(), columns.end(), name) != columns.end()) {
+      map[name] = i;
+
+      // update the column size
+      numCols = i + 1;
+    }
+  }
+
+  return numCols;
+}
+
+std::string& CsvViewRow::buffer(size_t index) {
+  while (buffers_.size() <= index) {
+    buffers_.emplace_back();
+  }
+
+  auto& buffer = buffers_.at(index);
+  buffer.clear();
+  return buffer;
+}
+
+// same rules as CsvRow::readNext but fields are views of the data
+const char* CsvViewRow::parse(const char* p, const char* end) {
+  fields_.clear();
+
+  // do not start with any LF/CR when there is no any fields yet (empty lines)
+  while (p < end && (*p == CR || *p == LF)) {
+    ++p;
+  }
+
+  if (p == end) {
+    return p;
+  }
+
+  size_t escapes = 0;
+  while (true) {
+    if (p < end && *p == DQ) {
+      // escaped field ends at a single DQ, a pair of DQ is an escaped DQ
+      const char* start = ++p;
+      const char* close = end;
+      std::string* unescaped = nullptr;
+      while (p < end) {
+        auto q = static_cast<const char*>(std::memchr(p, DQ, end - p));
+        if (q == nullptr) {
+          break;
+        }
+
+        if (q + 1 < end && *(q + 1) == DQ) {
+          if (unescaped == nullptr) {
+            unescaped = &buffer(escapes++);
+          }
+
+          unescaped->append(p, q + 1 - p);
+          p = q + 2;
+          continue;
+        }
+
+        close = q;
+        break;
+      }
+
+      if (unescaped != nullptr) {
+        unescaped->append(p, close - p);
+        fields_.emplace_back(*unescaped);
+      } else {
+        fields_.emplace_back(start, close - start);
+      }
+
+      p = close < end ? close + 1 : end;
+    } else {
+      // non-escaped field stops at delimiter, line break or end of data
+      const char* start = p;
+      while (p < end && *p != delimiter_ && *p != LF && *p != CR) {
+        ++p;
+      }
+
+      fields_.emplace_back(start, p - start);
+    }
+
+    if (p == end) {
+      return p;
+    }
+
+    // line break as CRLF or LF
+    if (*p == CR) {
+      ++p;
+      N_ENSURE(p < end && *p == LF, "end line as CRLF");
+      return p + 1;
+    }
+
+    if (*p == LF) {
+      return p + 1;
+    }
+
+    N_ENSURE(*p == delimiter_, "has to be delimeter");
+    ++p;
+  }
+}
+
+CsvChunkReader::CsvChunkReader(std::shared_ptr<MappedFile> file,
+                               const ByteRange& range,
+                               const nebula::meta::CsvProps& csv,
+                               const std::vector<std::string>& columns)
+  : nebula::surface::RowCursor(0),
+    file_{ file },
+    pos_{ nullptr },
+    end_{ nullptr },
+    numCols_{ 0 },
+    rows_{ { CsvViewRow(csv.delimiter.at(0), columns_, ordinals_), CsvViewRow(csv.delimiter.at(0), columns_, ordinals_) } },
+    current_{ 0 } {
+  const auto data = file_->view();
+  const char* begin = data.data();
+  const char* end = begin + data.size();
+
+  // skip BOM of the file
+  static constexpr std::string_view BOM = "\xEF\xBB\xBF";
+  if (data.substr(0, BOM.size()) == BOM) {
+    begin += BOM.size();
+  }
+
+  // scenarios of schema and header are the same as CsvReader
+  std::vector<std::string> names;
+  if (!csv.hasHeader) {
+    if (columns.empty()) {
+      throw NException("Can't figure out schema without header");
+    }
+
+    names = columns;
+  } else {
+    auto& header = rows_[0];
+    begin = header.parse(begin, end);
+    N_ENSURE(header.fields().size() > 0, "Failed to read csv header unexpectedly.");
+    const auto& fields = header.fields();
+    names = csvHeader(std::vector<std::string>(fields.begin(), fields.end()));
+  }
+
+  numCols_ = csvColumns(names, columns, columns_);
+
+  // skip the meta row
+  if (csv.hasMeta) {
+    auto lf = static_cast<const char*>(std::memchr(begin, LF, end - begin));
+    begin = lf == nullptr ? end : lf + 1;
+  }
+
+  // the chunk may start before data rows if it is the first chunk
+  pos_ = std::max(data.data() + range.first, begin);
+  end_ = std::max(data.data() + range.second, pos_);
+
+  // read one row ahead
+  if (read(rows_[current_])) {
+    size_ = 1;
+  }
+
+  LOG(INFO) << "Created csv chunk reader: [" << range.first << ", " << range.second << "), columns: " << numCols_;
+}
+
+bool CsvChunkReader::read(CsvViewRow& row) {
+  if (pos_ >= end_) {
+    return false;
+  }
+
+  pos_ = row.parse(pos_, end_);
+  const auto size = row.fields().size();
+
+  // nothing left but empty lines
+  if (size == 0) {
+    return false;
+  }
+
+  // we don't skip bad rows, same as CsvReader
+  if (size < numCols_) {
+    LOG(WARNING) << "CSV chunk reader stops at bad row number: " << size_ << ", fields: " << size;
+    pos_ = end_;
+    return false;
+  }
+
+  return true;
+}
+
 } // namespace storage
 } // namespace nebula
\ No newline at end of file
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
+#include "MappedFile.h"
 #include "SchemaHelper.h"
 #include "common/Compression.h"
 #include "common/Conv.h"
@@ -39,6 +43,37 @@ namespace storage {
 class DevNull {};
 std::istream& operator>>(std::istream&, DevNull&);
 
+// normalize and dedup column names read from a csv header
+std::vector<std::string> csvHeader(const std::vector<std::string>&);
+
+// map names of columns to read to their index in a csv row,
+// all names are read if no columns are given, return number of fields a valid row needs to have.
+size_t csvColumns(const std::vector<std::string>& names,
+                  const std::vector<std::string>& columns,
+                  nebula::common::unordered_map<std::string, size_t>&);
+
+// index of csv field for every column ordinal of a schema which rows are bound to,
+// so that rows serve index based reads without looking up column names.
+struct CsvOrdinals {
+  void bind(const nebula::type::Schema& s, const nebula::common::unordered_map<std::string, size_t>& columns) {
+    schema = s.get();
+    fields.clear();
+    fields.reserve(s->size());
+    for (size_t i = 0, size = s->size(); i < size; ++i) {
+      // column absent in csv fails the read as reading it by name
+      auto found = columns.find(s->childType(i)->name());
+      fields.push_back(found == columns.end() ? std::numeric_limits<size_t>::max() : found->second);
+    }
+  }
+
+  inline bool bound(const nebula::type::Schema& s) const {
+    return schema != nullptr && schema == s.get();
+  }
+
+  const nebula::type::RowType* schema = nullptr;
+  std::vector<size_t> fields;
+};
+
 class CsvRow : public nebula::surface::RowData {
 public:
   CsvRow(char delimiter) : delimiter_{ delimiter } {}
@@ -49,12 +84,9 @@ public:
     return false;
   }
 
-#define CONV_TYPE_INDEX(TYPE, FUNC)                      \
-  TYPE FUNC(const std::string& field) const override {   \
-    auto index = columnLookup_(field);                   \
-    auto& v = const_cast<std::string&>(data_.at(index)); \
-    nebula::common::unformat<TYPE>(v);                   \
-    return nebula::common::safe_to<TYPE>(v);             \
+#define CONV_TYPE_INDEX(TYPE, FUNC)                                  \
+  TYPE FUNC(const std::string& field) const override {               \
+    return nebula::common::unformat_to<TYPE>(data_.at(columnLookup_(field))); \
   }
 
   CONV_TYPE_INDEX(bool, readBool)
@@ -73,6 +105,35 @@ public:
 
 #undef CONV_TYPE_INDEX
 
+  // index based reads by column ordinals of bound schema
+  bool bound(const nebula::type::Schema& schema) const override {
+    return ordinals_ != nullptr && ordinals_->bound(schema);
+  }
+
+  bool isNull(nebula::surface::IndexType) const override {
+    return false;
+  }
+
+#define CONV_TYPE_ORDINAL(TYPE, FUNC)                                                \
+  TYPE FUNC(nebula::surface::IndexType index) const override {                       \
+    return nebula::common::unformat_to<TYPE>(data_.at(ordinals_->fields.at(index))); \
+  }
+
+  CONV_TYPE_ORDINAL(bool, readBool)
+  CONV_TYPE_ORDINAL(int8_t, readByte)
+  CONV_TYPE_ORDINAL(int16_t, readShort)
+  CONV_TYPE_ORDINAL(int32_t, readInt)
+  CONV_TYPE_ORDINAL(int64_t, readLong)
+  CONV_TYPE_ORDINAL(float, readFloat)
+  CONV_TYPE_ORDINAL(double, readDouble)
+  CONV_TYPE_ORDINAL(int128_t, readInt128)
+
+#undef CONV_TYPE_ORDINAL
+
+  std::string_view readString(nebula::surface::IndexType index) const override {
+    return data_.at(ordinals_->fields.at(index));
+  }
+
   // compound types
   std::unique_ptr<nebula::surface::ListData> readList(const std::string&) const override {
     throw NException("Array not supported yet.");
@@ -90,6 +151,10 @@ public:
     columnLookup_ = columnLookup;
   }
 
+  void setOrdinals(const CsvOrdinals* ordinals) {
+    ordinals_ = ordinals;
+  }
+
 public:
   // true if read a valid row, otherwise false
   bool readNext(std::istream&, const size_t);
@@ -102,23 +167,29 @@ private:
   // reference a line generated by reader
   std::vector<std::string> data_;
   std::function<size_t(std::string)> columnLookup_;
+  const CsvOrdinals* ordinals_ = nullptr;
 };
 
 class CsvReader : public nebula::surface::RowCursor {
 public:
   CsvReader(const std::string& file, const nebula::meta::CsvProps& csv, const std::vector<std::string>& columns)
+    : CsvReader(std::make_unique<std::ifstream>(file), file, csv, columns) {}
+
+  // read csv data from an input stream such as ranged reads on a remote object,
+  // file is used for logging only, compressed data is inflated from the stream too.
+  CsvReader(std::unique_ptr<std::istream> stream,
+            const std::string& file,
+            const nebula::meta::CsvProps& csv,
+            const std::vector<std::string>& columns)
     : nebula::surface::RowCursor(0),
-      fstream_{ file },
+      stream_{ std::move(stream) },
       row_{ csv.delimiter.at(0) },
       cacheRow_{ csv.delimiter.at(0) },
       numCols_{ 0 } {
-    // if the file is compressed, we decompress it first
+    // if the file is compressed, inflate it while reading
     if (csv.compression == "gz") {
-      LOG(INFO) << "Ungzip the csv file before reading: " << file;
-      auto localFs = nebula::storage::makeFS("local");
-      this->temp_ = localFs->temp();
-      nebula::common::ungzip(file, this->temp_);
-      this->fstream_ = std::ifstream(this->temp_);
+      LOG(INFO) << "Inflating gzip csv file while reading: " << file;
+      this->stream_ = std::make_unique<nebula::common::GzipStream>(std::move(this->stream_));
     }
 
     // a few scenarios need to be handled
@@ -130,7 +201,7 @@ public:
     // 2.b: csv has no header - fail, don't know how to process schema
     LOG(INFO) << "Reading csv file: " << file
               << ", delimiter: " << csv.delimiter
-              << ", size: " << fstream_.tellg();
+              << ", size: " << stream_->tellg();
     std::vector<std::string> names;
     const auto hasSchema = columns.size() > 0;
 
@@ -148,36 +219,14 @@ public:
       names = columns;
     } else {
       // read the header
-      N_ENSURE(row_.readNext(fstream_, 1), "Failed to read csv header unexpectedly.");
+      N_ENSURE(row_.readNext(*stream_, 1), "Failed to read csv header unexpectedly.");
 
       // extract all names
-      const auto& raw = row_.rawData();
-      for (size_t i = 0, size = raw.size(); i < size; ++i) {
-        auto name = raw.at(i);
-        if (name.empty()) {
-          name = fmt::format("col_{0}", i);
-        }
-
-        names.emplace_back(nebula::common::normalize(name));
-      }
-
-      // dedup column names
-      dedup(names);
+      names = csvHeader(row_.rawData());
     }
 
     // build the name to index map
-    for (size_t i = 0, size = names.size(); i < size; ++i) {
-      const auto name = names.at(i);
-      // notes: columns could be partial of all data and it should be already deduped
-      // example:
-      // 1.a csv data has 10 columns, but only 5 columns are provided in the schema
-      if (!hasSchema || std::find(columns.begin(), columns.end(), name) != columns.end()) {
-        columns_[name] = i;
-
-        // update the column size
-        numCols_ = i + 1;
-      }
-    }
+    numCols_ = csvColumns(names, columns, columns_);
 
     cacheRow_.setSchema([this](const std::string& name) -> size_t {
       return columns_.at(name);
@@ -187,16 +236,16 @@ public:
     DevNull devnull;
     // if data has meta in the second row, skip it too
     if (csv.hasMeta) {
-      fstream_ >> devnull;
+      *stream_ >> devnull;
     }
 
     // read one row
-    if (row_.readNext(fstream_, numCols_)) {
+    if (row_.readNext(*stream_, numCols_)) {
       size_ = 1;
     } else {
       auto buf = fmt::format("{}", fmt::join(row_.rawData(), ","));
       LOG(WARNING) << "Empty CSV reader due to invalid first row: " << file
-                   << ", read size: " << fstream_.gcount()
+                   << ", read size: " << stream_->gcount()
                    << ", first row: " << buf
                    << ", numCols: " << numCols_;
     }
@@ -205,11 +254,7 @@ public:
     LOG(INFO) << "Successfully created csv reader for file: " << file << ", columns: " << numCols_;
   }
 
-  virtual ~CsvReader() {
-    if (this->temp_.size() > 0) {
-      unlink(this->temp_.c_str());
-    }
-  }
+  virtual ~CsvReader() = default;
 
   // next row data of CsvRow
   virtual const nebula::surface::RowData& next() override {
@@ -218,11 +263,11 @@ public:
 
     // read next row
     // we should handle those to skip less rows
-    if (row_.readNext(fstream_, numCols_)) {
+    if (row_.readNext(*stream_, numCols_)) {
       size_ += 1;
     } else {
       // no more data or invalid row meets, we don't skip bad rows
-      if (fstream_.eof()) {
+      if (stream_->eof()) {
         LOG(INFO) << "Finish reading CSV file with total rows: " << size_;
       } else {
         LOG(WARNING) << "CSV reader stops at bad row number: " << size_;
@@ -237,32 +282,182 @@ public:
     throw NException("CSV Reader does not support random access by row number");
   }
 
+  // bind rows to a schema so that they are read by column ordinals of the schema
+  void bind(const nebula::type::Schema& schema) {
+    ordinals_.bind(schema, columns_);
+    cacheRow_.setOrdinals(&ordinals_);
+  }
+
 private:
   // ref: https://help.salesforce.com/s/articleView?id=000383918&type=1
+  // peek first char rather than seeking back since a compressed stream is not seekable
   void skipBOM() {
     static const std::string BOM = "\xEF\xBB\xBF";
+    if (this->stream_->peek() != (unsigned char)BOM[0]) {
+      return;
+    }
+
     char c;
     for (size_t i = 0, size = BOM.size(); i < size; ++i) {
-      this->fstream_.get(c);
+      this->stream_->get(c);
       if (c != BOM[i]) {
-        this->fstream_.seekg(0, std::ios_base::beg);
+        LOG(WARNING) << "Invalid BOM in csv data, rewinding to the beginning.";
+        this->stream_->clear();
+        this->stream_->seekg(0, std::ios_base::beg);
         return;
       }
     }
-
-    // skip the BOM
-    this->fstream_.seekg(3, std::ios_base::beg);
   }
 
 private:
-  std::string temp_;
-  std::ifstream fstream_;
+  std::unique_ptr<std::istream> stream_;
   CsvRow row_;
   CsvRow cacheRow_;
 
   // numCols is unnecessary to be the same as size of columns_
   size_t numCols_;
   nebula::common::unordered_map<std::string, size_t> columns_;
+  CsvOrdinals ordinals_;
+};
+
+// a csv row with fields as string views of the source data,
+// only escaped fields having double quotes in them are unescaped into buffers owned by the row.
+class CsvViewRow : public nebula::surface::RowData {
+public:
+  CsvViewRow(char delimiter,
+             const nebula::common::unordered_map<std::string, size_t>& columns,
+             const CsvOrdinals& ordinals)
+    : delimiter_{ delimiter }, columns_{ columns }, ordinals_{ ordinals } {}
+  virtual ~CsvViewRow() = default;
+
+  bool isNull(const std::string&) const override {
+    return false;
+  }
+
+#define CONV_TYPE_INDEX(TYPE, FUNC)                                        \
+  TYPE FUNC(const std::string& field) const override {                     \
+    return nebula::common::unformat_to<TYPE>(fields_.at(columns_.at(field))); \
+  }
+
+  CONV_TYPE_INDEX(bool, readBool)
+  CONV_TYPE_INDEX(int8_t, readByte)
+  CONV_TYPE_INDEX(int16_t, readShort)
+  CONV_TYPE_INDEX(int32_t, readInt)
+  CONV_TYPE_INDEX(int64_t, readLong)
+  CONV_TYPE_INDEX(float, readFloat)
+  CONV_TYPE_INDEX(double, readDouble)
+  CONV_TYPE_INDEX(int128_t, readInt128)
+
+#undef CONV_TYPE_INDEX
+
+  std::string_view readString(const std::string& field) const override {
+    return fields_.at(columns_.at(field));
+  }
+
+  // index based reads by column ordinals of bound schema
+  bool bound(const nebula::type::Schema& schema) const override {
+    return ordinals_.bound(schema);
+  }
+
+  bool isNull(nebula::surface::IndexType) const override {
+    return false;
+  }
+
+#define CONV_TYPE_ORDINAL(TYPE, FUNC)                                                 \
+  TYPE FUNC(nebula::surface::IndexType index) const override {                        \
+    return nebula::common::unformat_to<TYPE>(fields_.at(ordinals_.fields.at(index))); \
+  }
+
+  CONV_TYPE_ORDINAL(bool, readBool)
+  CONV_TYPE_ORDINAL(int8_t, readByte)
+  CONV_TYPE_ORDINAL(int16_t, readShort)
+  CONV_TYPE_ORDINAL(int32_t, readInt)
+  CONV_TYPE_ORDINAL(int64_t, readLong)
+  CONV_TYPE_ORDINAL(float, readFloat)
+  CONV_TYPE_ORDINAL(double, readDouble)
+  CONV_TYPE_ORDINAL(int128_t, readInt128)
+
+#undef CONV_TYPE_ORDINAL
+
+  std::string_view readString(nebula::surface::IndexType index) const override {
+    return fields_.at(ordinals_.fields.at(index));
+  }
+
+  std::unique_ptr<nebula::surface::ListData> readList(const std::string&) const override {
+    throw NException("Array not supported yet.");
+  }
+
+  std::unique_ptr<nebula::surface::MapData> readMap(const std::string&) const override {
+    throw NException("Map not supported yet.");
+  }
+
+public:
+  // parse a record following RFC4180 from given data, leading empty lines are skipped.
+  // return position right after the record.
+  const char* parse(const char*, const char*);
+
+  inline const std::vector<std::string_view>& fields() const {
+    return fields_;
+  }
+
+private:
+  // buffer to unescape n-th escaped field of current row, references are stable when it grows
+  std::string& buffer(size_t);
+
+private:
+  char delimiter_;
+  const nebula::common::unordered_map<std::string, size_t>& columns_;
+  const CsvOrdinals& ordinals_;
+  std::vector<std::string_view> fields_;
+  std::deque<std::string> buffers_;
+};
+
+// A csv reader parsing a chunk of lines of a memory mapped file in place.
+// Header of the file is parsed by every chunk reader to resolve columns,
+// so chunks of the same file can be read by different threads independently.
+class CsvChunkReader : public nebula::surface::RowCursor {
+public:
+  CsvChunkReader(std::shared_ptr<MappedFile>,
+                 const ByteRange&,
+                 const nebula::meta::CsvProps&,
+                 const std::vector<std::string>&);
+  virtual ~CsvChunkReader() = default;
+
+  virtual const nebula::surface::RowData& next() override {
+    auto& row = rows_[current_];
+    current_ ^= 1;
+    if (read(rows_[current_])) {
+      size_ += 1;
+    }
+
+    index_++;
+    return row;
+  }
+
+  virtual std::unique_ptr<nebula::surface::RowData> item(size_t) const override {
+    throw NException("CSV Reader does not support random access by row number");
+  }
+
+  // bind rows to a schema so that they are read by column ordinals of the schema
+  void bind(const nebula::type::Schema& schema) {
+    ordinals_.bind(schema, columns_);
+  }
+
+private:
+  // read next valid row into given row
+  bool read(CsvViewRow&);
+
+private:
+  std::shared_ptr<MappedFile> file_;
+  const char* pos_;
+  const char* end_;
+  nebula::common::unordered_map<std::string, size_t> columns_;
+  size_t numCols_;
+  CsvOrdinals ordinals_;
+
+  // current row returned to client and the next row read ahead
+  std::array<CsvViewRow, 2> rows_;
+  size_t current_;
 };
 
 } // namespace storage
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "JsonRow.h"
+#include "MappedFile.h"
 #include "storage/NFS.h"
 #include "surface/DataSurface.h"
 
@@ -45,13 +46,21 @@ public:
     nebula::type::Schema schema,
     const std::vector<std::string>& columns = {},
     bool nullDefault = true)
+    : LineJsonReader(std::make_unique<std::ifstream>(file), props, schema, columns, nullDefault) {}
+
+  LineJsonReader(
+    std::unique_ptr<std::istream> stream,
+    const nebula::meta::JsonProps& props,
+    nebula::type::Schema schema,
+    const std::vector<std::string>& columns = {},
+    bool nullDefault = true)
     : nebula::surface::RowCursor(0),
-      fstream_{ file },
+      stream_{ std::move(stream) },
       json_{ schema, props.columnsMap, columns, nullDefault },
       row_{ SLICE_SIZE } {
 
     // read first line to initialize cursor state
-    if (std::getline(fstream_, line_)) {
+    if (std::getline(*stream_, line_)) {
       ++size_;
     }
   }
@@ -67,7 +76,7 @@ public:
     json_.parse(line_.data(), line_.size(), row_);
 
     // read next row, if true, then it has data
-    if (std::getline(fstream_, line_)) {
+    if (std::getline(*stream_, line_)) {
       ++size_;
     }
 
@@ -79,12 +88,84 @@ public:
   }
 
 private:
-  std::ifstream fstream_;
+  std::unique_ptr<std::istream> stream_;
   JsonRow json_;
   nebula::memory::FlatRow row_;
   std::string line_;
 };
 
+// same as line json reader but parsing a chunk of lines of a memory mapped file in place,
+// chunks of the same file can be read by different threads independently.
+class JsonChunkReader : public nebula::surface::RowCursor {
+  static constexpr size_t SLICE_SIZE = 1024;
+
+public:
+  JsonChunkReader(
+    std::shared_ptr<MappedFile> file,
+    const ByteRange& range,
+    const nebula::meta::JsonProps& props,
+    nebula::type::Schema schema,
+    const std::vector<std::string>& columns = {},
+    bool nullDefault = true)
+    : nebula::surface::RowCursor(0),
+      file_{ file },
+      chunk_{ file->view(range) },
+      json_{ schema, props.columnsMap, columns, nullDefault },
+      row_{ SLICE_SIZE } {
+    if (readLine()) {
+      ++size_;
+    }
+  }
+  virtual ~JsonChunkReader() = default;
+
+public:
+  virtual const nebula::surface::RowData& next() override {
+    index_++;
+
+    // parser only reads the buffer (not in situ), mapped data is never written
+    row_.reset();
+    json_.parse(const_cast<char*>(line_.data()), line_.size(), row_);
+
+    if (readLine()) {
+      ++size_;
+    }
+
+    return row_;
+  }
+
+  virtual std::unique_ptr<nebula::surface::RowData> item(size_t) const override {
+    throw NException("stream-based JSON Reader does not support random access.");
+  }
+
+private:
+  // move to next non-empty line of the chunk
+  bool readLine() {
+    while (!chunk_.empty()) {
+      auto pos = chunk_.find('\n');
+      line_ = chunk_.substr(0, pos);
+      chunk_.remove_prefix(pos == std::string_view::npos ? chunk_.size() : pos + 1);
+
+      // drop CR of CRLF
+      if (!line_.empty() && line_.back() == '\r') {
+        line_.remove_suffix(1);
+      }
+
+      if (!line_.empty()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+private:
+  std::shared_ptr<MappedFile> file_;
+  std::string_view chunk_;
+  std::string_view line_;
+  JsonRow json_;
+  nebula::memory::FlatRow row_;
+};
+
 // Object json reader instead will parse the whole file as an JSON object
 // it is either an array, or it is an object
 class ObjectJsonReader : public nebula::surface::RowCursor {
@@ -98,6 +179,14 @@ public:
     nebula::type::Schema schema,
     const std::vector<std::string>& columns = {},
     bool nullDefault = true)
+    : ObjectJsonReader(std::make_unique<std::ifstream>(file), props, schema, columns, nullDefault) {}
+
+  ObjectJsonReader(
+    std::unique_ptr<std::istream> stream,
+    const nebula::meta::JsonProps& props,
+    nebula::type::Schema schema,
+    const std::vector<std::string>& columns = {},
+    bool nullDefault = true)
     : nebula::surface::RowCursor(0),
       json_{ schema, props.columnsMap, columns, nullDefault },
       row_{ SLICE_SIZE },
@@ -105,13 +194,7 @@ public:
     const auto& rf = props.rowsField;
     N_ENSURE(rf.size() > 0, "rows field has to be set.");
 
-    // these lines are used to make copy of the data file for diagnosis
-    // LOG(INFO) << "Reading JSON data from file: " << file;
-    // auto lfs = nebula::storage::makeFS("local");
-    // lfs->copy(file, "/tmp/data.json");
-
-    std::ifstream ifs{ file };
-    rapidjson::IStreamWrapper isw(ifs);
+    rapidjson::IStreamWrapper isw(*stream);
     if (doc_.ParseStream(isw).HasParseError()) {
       throw NException("Failed to parse the json document.");
     }
@@ -153,18 +236,27 @@ private:
 };
 
 std::unique_ptr<nebula::surface::RowCursor> makeJsonReader(
-  const std::string& file,
+  std::unique_ptr<std::istream> stream,
   const nebula::meta::JsonProps& props,
   nebula::type::Schema schema,
   const std::vector<std::string>& columns,
   bool nullDefault = true) {
   // empty rows field - every line of the file is a row object in json
   if (props.rowsField.size() == 0) {
-    return std::make_unique<LineJsonReader>(file, props, schema, columns, nullDefault);
+    return std::make_unique<LineJsonReader>(std::move(stream), props, schema, columns, nullDefault);
   } else {
-    return std::make_unique<ObjectJsonReader>(file, props, schema, columns, nullDefault);
+    return std::make_unique<ObjectJsonReader>(std::move(stream), props, schema, columns, nullDefault);
   }
 }
 
+std::unique_ptr<nebula::surface::RowCursor> makeJsonReader(
+  const std::string& file,
+  const nebula::meta::JsonProps& props,
+  nebula::type::Schema schema,
+  const std::vector<std::string>& columns,
+  bool nullDefault = true) {
+  return makeJsonReader(std::make_unique<std::ifstream>(file), props, schema, columns, nullDefault);
+}
+
 } // namespace storage
 } // namespace nebula
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/Errors.h"
+
+namespace nebula {
+namespace storage {
+
+MappedFile::MappedFile(const std::string& file) : data_{ nullptr }, size_{ 0 } {
+  auto fd = ::open(file.c_str(), O_RDONLY);
+  N_ENSURE(fd >= 0, fmt::format("failed to open file: {0}", file));
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw NException(fmt::format("failed to stat file: {0}", file));
+  }
+
+  size_ = st.st_size;
+  if (size_ > 0) {
+    auto p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    N_ENSURE(p != MAP_FAILED, fmt::format("failed to map file: {0}", file));
+
+    // every chunk is read from front to back
+    ::madvise(p, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(p);
+    return;
+  }
+
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+std::vector<ByteRange> MappedFile::lines(size_t parts, bool quoted) const {
+  std::vector<ByteRange> chunks;
+  if (size_ == 0) {
+    return chunks;
+  }
+
+  const auto step = size_ / std::max<size_t>(parts, 1) + 1;
+  size_t begin = 0;
+  // number of double quotes before scanned position, odd number means we're inside a quoted field
+  size_t quotes = 0;
+  size_t scanned = 0;
+  while (begin < size_) {
+    auto pos = std::min(begin + step, size_);
+    if (quoted) {
+      quotes += std::count(data_ + scanned, data_ + pos, '"');
+    }
+
+    // move to the first line break which is not quoted
+    while (pos < size_) {
+      const auto ch = data_[pos];
+      if (ch == '\n' && (quotes & 1) == 0) {
+        break;
+      }
+
+      if (quoted && ch == '"') {
+        ++quotes;
+      }
+
+      ++pos;
+    }
+
+    scanned = pos;
+    const auto end = std::min(pos + 1, size_);
+    chunks.emplace_back(begin, end);
+    begin = end;
+  }
+
+  return chunks;
+}
+
+} // namespace storage
+} // namespace nebula
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * A read only memory mapped local file.
+ * Text readers parse it in place without copying lines or fields,
+ * and different ingest threads can parse different chunks of it at the same time.
+ */
+namespace nebula {
+namespace storage {
+
+// range of bytes [first, second) in a file
+using ByteRange = std::pair<size_t, size_t>;
+
+class MappedFile {
+public:
+  explicit MappedFile(const std::string&);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  virtual ~MappedFile();
+
+  inline std::string_view view() const {
+    return { data_, size_ };
+  }
+
+  inline std::string_view view(const ByteRange& range) const {
+    return { data_ + range.first, range.second - range.first };
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+  // split the file into at most given number of chunks of about equal size,
+  // every chunk ends at a line break, line breaks inside double quotes are skipped if quoted (CSV).
+  std::vector<ByteRange> lines(size_t, bool quoted) const;
+
+private:
+  const char* data_;
+  size_t size_;
+};
+
+} // namespace storage
+} // namespace nebula
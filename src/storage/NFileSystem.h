@@ -59,6 +59,12 @@ public:
   // return file info of given file handler
   virtual FileInfo info(const std::string&) = 0;
 
+  // true if ranged read and info are supported,
+  // so that readers can stream an object rather than downloading it first
+  virtual bool ranged() const {
+    return false;
+  }
+
   // copy a file to an tmp file - most likely used for remote file download scenario
   // two path - from, to
   virtual bool copy(const std::string&, const std::string&) = 0;
@@ -25,6 +25,7 @@
 namespace nebula {
 namespace storage {
 
+using nebula::memory::Batch;
 using nebula::memory::FlatRow;
 using nebula::surface::RowData;
 using nebula::type::Kind;
@@ -48,6 +49,22 @@ void writeAsKind(Kind kind, FlatRow& row, const std::string& name, const T& valu
     KIND_CONVERT(BIGINT)
     KIND_CONVERT(REAL)
     KIND_CONVERT(DOUBLE)
+  case Kind::INT128: {
+    if constexpr (std::is_arithmetic_v<T>) {
+      row.write(name, static_cast<int128_t>(value));
+    } else {
+      row.write(name, nebula::common::safe_to<int128_t>(value));
+    }
+    break;
+  }
+  case Kind::VARCHAR: {
+    if constexpr (std::is_arithmetic_v<T>) {
+      row.write(name, nebula::common::safe_to<std::string>(value));
+    } else {
+      row.write(name, value);
+    }
+    break;
+  }
   default:
     // other types not supported - write NULL instead
     row.writeNull(name);
@@ -56,21 +73,146 @@ void writeAsKind(Kind kind, FlatRow& row, const std::string& name, const T& valu
 #undef KIND_CONVERT
 }
 
-const RowData& ParquetReader::next() {
-  // TODO build a flat row out of a reader
-  if (N_UNLIKELY(groupReader_ == nullptr) || cursorInGroup_ == groupRows_) {
-    groupReader_ = reader_->RowGroup(group_++);
-    cursorInGroup_ = 0;
-    groupRows_ = groupReader_->metadata()->num_rows();
+void ParquetReader::range(size_t begin, size_t end) {
+  N_ENSURE(groupReader_ == nullptr, "row group range should be set before reading");
+  N_ENSURE(begin <= end && end <= groups(), "row group range out of bound");
+
+  // total rows is the sum of all row groups in the range
+  group_ = begin;
+  size_ = 0;
+  for (auto i = begin; i < end; ++i) {
+    size_ += meta_->RowGroup(i)->num_rows();
+  }
+}
 
-    // initialize all column readers in the meta store
-    for (auto& item : this->columns_) {
-      item.second.reader = groupReader_->Column(item.second.columnIndex);
+// convert a parquet value to the target type defined in user schema
+template <typename T, typename V>
+T convert(const V& value) {
+  if constexpr (std::is_same_v<V, parquet::ByteArray>) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return std::string_view((const char*)value.ptr, (size_t)value.len);
+    } else {
+      return nebula::common::safe_to<T>(std::string((const char*)value.ptr, (size_t)value.len));
     }
+  } else if constexpr (std::is_same_v<T, V>) {
+    return value;
+  } else if constexpr (std::is_same_v<T, int128_t>) {
+    return static_cast<T>(value);
+  } else {
+    return nebula::common::safe_to<T>(value);
   }
+}
 
-  // read current data from current group reader and set it to current FlatRow
-  row_.reset();
+// spread dense values by definition levels and append them into the batch as target type
+// levels is nullptr if the column is required
+template <typename T, typename V>
+void spread(Batch& batch, const std::string& name,
+            const V* values, const int16_t* levels, int16_t maxLevel, size_t size) {
+  auto targets = std::make_unique<T[]>(size);
+  std::unique_ptr<bool[]> nulls = nullptr;
+  if (levels != nullptr) {
+    nulls = std::make_unique<bool[]>(size);
+  }
+
+  for (size_t i = 0, v = 0; i < size; ++i) {
+    if (levels != nullptr && levels[i] < maxLevel) {
+      nulls[i] = true;
+      continue;
+    }
+
+    targets[i] = convert<T>(values[v++]);
+  }
+
+  batch.append<T>(name, targets.get(), nulls.get(), size);
+}
+
+// spread dense values of a non byte array column by definition levels and append them as strings,
+// the strings are owned here until appended.
+template <typename V>
+void spreadString(Batch& batch, const std::string& name,
+                  const V* values, const int16_t* levels, int16_t maxLevel, size_t size) {
+  std::vector<std::string> strings(size);
+  std::vector<std::string_view> targets(size);
+  std::unique_ptr<bool[]> nulls = nullptr;
+  if (levels != nullptr) {
+    nulls = std::make_unique<bool[]>(size);
+  }
+
+  for (size_t i = 0, v = 0; i < size; ++i) {
+    if (levels != nullptr && levels[i] < maxLevel) {
+      nulls[i] = true;
+      continue;
+    }
+
+    strings[i] = nebula::common::safe_to<std::string>(values[v++]);
+    targets[i] = strings[i];
+  }
+
+  batch.append<std::string_view>(name, targets.data(), nulls.get(), size);
+}
+
+// decode next rows of a column in batches and append them into the batch as its kind
+template <typename R>
+void appendColumn(Batch& batch, const std::string& name, Kind kind, R* reader, size_t rows) {
+  using V = typename R::T;
+  const auto maxLevel = reader->descr()->max_definition_level();
+  std::vector<int16_t> levels(rows);
+  auto values = std::make_unique<V[]>(rows);
+
+  // every batch read stops at the end of a page, values of a byte array point to page memory
+  // so they need to be consumed before next read.
+  for (size_t done = 0; done < rows;) {
+    int64_t vread = 0;
+    const auto lread = reader->ReadBatch(rows - done, levels.data(), nullptr, values.get(), &vread);
+    N_ENSURE_GT(lread, 0, "column has less values than rows in the group");
+    const auto* defs = maxLevel > 0 ? levels.data() : nullptr;
+
+#define KIND_APPEND(K)                                                                                    \
+  case Kind::K: {                                                                                         \
+    spread<nebula::type::TypeTraits<Kind::K>::CppType>(batch, name, values.get(), defs, maxLevel, lread); \
+    break;                                                                                                \
+  }
+
+    switch (kind) {
+      KIND_APPEND(BOOLEAN)
+      KIND_APPEND(TINYINT)
+      KIND_APPEND(SMALLINT)
+      KIND_APPEND(INTEGER)
+      KIND_APPEND(BIGINT)
+      KIND_APPEND(REAL)
+      KIND_APPEND(DOUBLE)
+      KIND_APPEND(INT128)
+    case Kind::VARCHAR: {
+      // values of other types are converted to string
+      if constexpr (std::is_same_v<V, parquet::ByteArray>) {
+        spread<std::string_view>(batch, name, values.get(), defs, maxLevel, lread);
+      } else {
+        spreadString(batch, name, values.get(), defs, maxLevel, lread);
+      }
+      break;
+    }
+    default:
+      throw NException(fmt::format("Type not supported in columnar reading: {0}", kind));
+    }
+
+#undef KIND_APPEND
+
+    done += lread;
+  }
+}
+
+void ParquetReader::nextGroup() {
+  groupReader_ = reader_->RowGroup(group_++);
+  cursorInGroup_ = 0;
+  groupRows_ = groupReader_->metadata()->num_rows();
+
+  // initialize all column readers in the meta store
+  for (auto& item : this->columns_) {
+    item.second.reader = groupReader_->Column(item.second.columnIndex);
+  }
+}
+
+void ParquetReader::readValue(const std::string& name, const ColumnInfo& info) {
 #define TRANSFER_FROM_PARQUET(T, K, R)                         \
   case Kind::K: {                                              \
     auto reader = static_cast<parquet::R*>(info.reader.get()); \
@@ -89,47 +231,56 @@ const RowData& ParquetReader::next() {
     break;                                                     \
   }
 
-  for (auto itr = this->columns_.begin(), end = this->columns_.end(); itr != end; ++itr) {
-    auto name = itr->first;
-    auto info = itr->second;
-    // number of non-nulls read
-    int64_t vread = 0;
+  // number of non-nulls read
+  int64_t vread = 0;
 
-    // definition level - required in reader to able to skip nulls
-    int16_t defLevel;
+  // definition level - required in reader to able to skip nulls
+  int16_t defLevel;
 
-    // bool, int, long, float, double, string
-    switch (info.realKind) {
-      TRANSFER_FROM_PARQUET(bool, BOOLEAN, BoolReader)
-      // a bit obsecure: use int32 reader and data type to read SMALL int
-      TRANSFER_FROM_PARQUET(int32_t, TINYINT, Int32Reader)
-      TRANSFER_FROM_PARQUET(int32_t, SMALLINT, Int32Reader)
-      TRANSFER_FROM_PARQUET(int32_t, INTEGER, Int32Reader)
-      TRANSFER_FROM_PARQUET(int64_t, BIGINT, Int64Reader)
-      TRANSFER_FROM_PARQUET(float, REAL, FloatReader)
-      TRANSFER_FROM_PARQUET(double, DOUBLE, DoubleReader)
-    case Kind::VARCHAR: {
-      auto reader = static_cast<parquet::ByteArrayReader*>(info.reader.get());
-      parquet::ByteArray value;
-      reader->ReadBatch(1, &defLevel, nullptr, &value, &vread);
-      if (vread == 0) {
-        row_.writeNull(name);
+  // bool, int, long, float, double, string
+  switch (info.realKind) {
+    TRANSFER_FROM_PARQUET(bool, BOOLEAN, BoolReader)
+    // a bit obsecure: use int32 reader and data type to read SMALL int
+    TRANSFER_FROM_PARQUET(int32_t, TINYINT, Int32Reader)
+    TRANSFER_FROM_PARQUET(int32_t, SMALLINT, Int32Reader)
+    TRANSFER_FROM_PARQUET(int32_t, INTEGER, Int32Reader)
+    TRANSFER_FROM_PARQUET(int64_t, BIGINT, Int64Reader)
+    TRANSFER_FROM_PARQUET(float, REAL, FloatReader)
+    TRANSFER_FROM_PARQUET(double, DOUBLE, DoubleReader)
+  case Kind::VARCHAR: {
+    auto reader = static_cast<parquet::ByteArrayReader*>(info.reader.get());
+    parquet::ByteArray value;
+    reader->ReadBatch(1, &defLevel, nullptr, &value, &vread);
+    if (vread == 0) {
+      row_.writeNull(name);
+    } else {
+      std::string str((const char*)value.ptr, (size_t)value.len);
+      if (info.kind == Kind::VARCHAR) {
+        row_.write(name, str);
       } else {
-        std::string str((const char*)value.ptr, (size_t)value.len);
-        if (info.kind == Kind::VARCHAR) {
-          row_.write(name, str);
-        } else {
-          writeAsKind(info.kind, row_, name, str);
-        }
+        writeAsKind(info.kind, row_, name, str);
       }
-      break;
-    }
-    default:
-      throw NException("Type not supported yet");
     }
+    break;
+  }
+  default:
+    throw NException("Type not supported yet");
   }
 
 #undef TRANSFER_FROM_PARQUET
+}
+
+const RowData& ParquetReader::next() {
+  // TODO build a flat row out of a reader
+  if (N_UNLIKELY(groupReader_ == nullptr) || cursorInGroup_ == groupRows_) {
+    nextGroup();
+  }
+
+  // read current data from current group reader and set it to current FlatRow
+  row_.reset();
+  for (auto itr = this->columns_.begin(), end = this->columns_.end(); itr != end; ++itr) {
+    readValue(itr->first, itr->second);
+  }
 
   // row is ready to consume
   cursorInGroup_++;
@@ -137,5 +288,60 @@ const RowData& ParquetReader::next() {
   return row_;
 }
 
+size_t ParquetReader::read(Batch& batch, size_t max, const std::function<void(const RowData&)>& visit) {
+  if (!hasNext() || max == 0) {
+    return 0;
+  }
+
+  // skip empty row groups
+  while (N_UNLIKELY(groupReader_ == nullptr) || cursorInGroup_ == groupRows_) {
+    nextGroup();
+  }
+
+  const auto rows = std::min({ max, groupRows_ - cursorInGroup_, size_ - index_ });
+
+  // columns stored in the batch are decoded in bulk, others are decoded row by row
+#define COLUMN_APPEND(K, R)                                                                        \
+  case Kind::K: {                                                                                  \
+    appendColumn(batch, itr->first, info.kind, static_cast<parquet::R*>(info.reader.get()), rows); \
+    break;                                                                                         \
+  }
+
+  std::vector<decltype(columns_)::const_iterator> others;
+  for (auto itr = this->columns_.cbegin(), end = this->columns_.cend(); itr != end; ++itr) {
+    if (!batch.has(itr->first)) {
+      others.push_back(itr);
+      continue;
+    }
+
+    const auto& info = itr->second;
+    switch (info.realKind) {
+      COLUMN_APPEND(BOOLEAN, BoolReader)
+      COLUMN_APPEND(INTEGER, Int32Reader)
+      COLUMN_APPEND(BIGINT, Int64Reader)
+      COLUMN_APPEND(REAL, FloatReader)
+      COLUMN_APPEND(DOUBLE, DoubleReader)
+      COLUMN_APPEND(VARCHAR, ByteArrayReader)
+    default:
+      throw NException("Type not supported yet");
+    }
+  }
+
+#undef COLUMN_APPEND
+
+  for (size_t i = 0; i < rows; ++i) {
+    row_.reset();
+    for (const auto& itr : others) {
+      readValue(itr->first, itr->second);
+    }
+
+    visit(row_);
+  }
+
+  cursorInGroup_ += rows;
+  index_ += rows;
+  return rows;
+}
+
 } // namespace storage
 } // namespace nebula
\ No newline at end of file
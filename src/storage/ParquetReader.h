@@ -24,6 +24,7 @@
 #include <string>
 
 #include "common/Errors.h"
+#include "memory/Batch.h"
 #include "memory/FlatRow.h"
 #include "surface/DataSurface.h"
 #include "type/Type.h"
@@ -54,8 +55,20 @@ class ParquetReader : public nebula::surface::RowCursor {
 
 public:
   ParquetReader(const std::string& file, nebula::type::Schema schema, const std::vector<std::string>& columns = {})
+    : ParquetReader(parquet::ParquetFileReader::OpenFile(file, false), schema, columns) {}
+
+  // open a random access source such as ranged reads on a remote object,
+  // only footer and column chunks of requested columns will be fetched.
+  ParquetReader(std::shared_ptr<arrow::io::RandomAccessFile> source,
+                nebula::type::Schema schema,
+                const std::vector<std::string>& columns = {})
+    : ParquetReader(parquet::ParquetFileReader::Open(std::move(source)), schema, columns) {}
+
+  ParquetReader(std::unique_ptr<parquet::ParquetFileReader> reader,
+                nebula::type::Schema schema,
+                const std::vector<std::string>& columns)
     : nebula::surface::RowCursor(0),
-      reader_{ parquet::ParquetFileReader::OpenFile(file, false) },
+      reader_{ std::move(reader) },
       group_{ 0 },
       schema_{ schema },
       row_{ SLICE_SIZE } {
@@ -166,10 +179,32 @@ public:
   // next row data of CsvRow
   virtual const nebula::surface::RowData& next() override;
 
+  // number of row groups in the file
+  inline size_t groups() const {
+    return meta_->num_row_groups();
+  }
+
+  // limit this reader to row groups in range [begin, end) of the file,
+  // so that different ranges of the same file can be read independently.
+  void range(size_t begin, size_t end);
+
+  // columnar reading: decode up to `max` next rows column by column and append them into the batch.
+  // columns not stored in the batch (eg. source of time column) are served as a row to the visitor for each row.
+  // rows are appended only, caller is supposed to commit them in the batch.
+  // return number of rows read, which never crosses a row group.
+  size_t read(nebula::memory::Batch&, size_t max, const std::function<void(const nebula::surface::RowData&)>&);
+
   virtual std::unique_ptr<nebula::surface::RowData> item(size_t) const override {
     throw NException("Parquet Reader does not support random access by row number");
   }
 
+private:
+  // move to next row group which has rows
+  void nextGroup();
+
+  // read value of next row for given column into current row
+  void readValue(const std::string&, const ColumnInfo&);
+
 private:
   std::unique_ptr<parquet::ParquetFileReader> reader_;
   size_t group_;
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RangeReader.h"
+
+#include <algorithm>
+#include <arrow/buffer.h>
+#include <cstring>
+#include <fmt/format.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "common/Folly.h"
+
+DEFINE_uint32(RANGE_IO_THREADS, 8, "threads shared by all ranged reads to prefetch chunks, bounding fetches in flight");
+
+/**
+ * Readers on top of ranged reads of a file system object.
+ */
+namespace nebula {
+namespace storage {
+
+// prefetches of all range buffers run in a bounded pool rather than a thread per chunk
+static folly::CPUThreadPoolExecutor& ioPool() {
+  static folly::CPUThreadPoolExecutor pool{ std::max<uint32_t>(FLAGS_RANGE_IO_THREADS, 1) };
+  return pool;
+}
+
+RangeBuffer::RangeBuffer(std::shared_ptr<NFileSystem> fs, const std::string& path, size_t size, size_t chunk)
+  : fs_{ std::move(fs) },
+    path_{ path },
+    size_{ size },
+    chunk_{ chunk },
+    offset_{ 0 },
+    nextOffset_{ 0 } {
+  N_ENSURE_GT(chunk_, 0, "chunk size should be positive");
+  setg(nullptr, nullptr, nullptr);
+}
+
+RangeBuffer::~RangeBuffer() {
+  // wait for in-flight fetch since it references this buffer's file system
+  if (next_.valid()) {
+    next_.wait();
+  }
+}
+
+folly::Future<std::vector<char>> RangeBuffer::prefetch(size_t offset) {
+  nextOffset_ = offset;
+  return folly::via(&ioPool(), [fs = fs_, path = path_, offset, bytes = std::min(chunk_, size_ - offset)]() {
+    std::vector<char> data(bytes);
+    auto read = fs->read(path, offset, bytes, data.data());
+    // file systems return -1 as size_t on failure
+    data.resize(read > bytes ? 0 : read);
+    return data;
+  });
+}
+
+bool RangeBuffer::load(size_t offset) {
+  if (offset >= size_) {
+    return false;
+  }
+
+  // use the prefetched chunk if it is the one asked for, otherwise fetch it now
+  if (!next_.valid() || nextOffset_ != offset) {
+    if (next_.valid()) {
+      next_.wait();
+    }
+    next_ = prefetch(offset);
+  }
+
+  buffer_ = std::move(next_).get();
+  offset_ = offset;
+  if (buffer_.empty()) {
+    // fail loudly rather than ending the stream early with partial data
+    throw NException(fmt::format("Failed to read {0} at offset {1}", path_, offset));
+  }
+
+  // kick off next chunk to overlap download with parsing
+  const auto next = offset_ + buffer_.size();
+  if (next < size_) {
+    next_ = prefetch(next);
+  }
+
+  auto base = buffer_.data();
+  setg(base, base, base + buffer_.size());
+  return true;
+}
+
+RangeBuffer::int_type RangeBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+
+  if (!load(offset_ + buffer_.size())) {
+    return traits_type::eof();
+  }
+
+  return traits_type::to_int_type(*gptr());
+}
+
+RangeBuffer::pos_type RangeBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+  const auto current = offset_ + (gptr() - eback());
+  off_type target = off;
+  if (dir == std::ios_base::cur) {
+    target += current;
+  } else if (dir == std::ios_base::end) {
+    target += size_;
+  }
+
+  return seekpos(target, mode);
+}
+
+RangeBuffer::pos_type RangeBuffer::seekpos(pos_type pos, std::ios_base::openmode mode) {
+  const off_type target = pos;
+  if ((mode & std::ios_base::in) == 0 || target < 0 || (size_t)target > size_) {
+    return pos_type(off_type(-1));
+  }
+
+  // inside current chunk
+  if ((size_t)target >= offset_ && (size_t)target < offset_ + buffer_.size()) {
+    auto base = buffer_.data();
+    setg(base, base + (target - offset_), base + buffer_.size());
+    return pos;
+  }
+
+  // end of the object, next read hits eof
+  if ((size_t)target == size_) {
+    buffer_.clear();
+    offset_ = size_;
+    setg(nullptr, nullptr, nullptr);
+    return pos;
+  }
+
+  if (!load(target)) {
+    return pos_type(off_type(-1));
+  }
+
+  return pos;
+}
+
+arrow::Result<int64_t> RangeFile::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  if (position < 0 || position > size_) {
+    return arrow::Status::IOError(fmt::format("Invalid read position {0} of {1}", position, path_));
+  }
+
+  nbytes = std::min(nbytes, size_ - position);
+  if (nbytes <= 0) {
+    return 0;
+  }
+
+  auto read = fs_->read(path_, position, nbytes, static_cast<char*>(out));
+  if (read > (size_t)nbytes) {
+    return arrow::Status::IOError(fmt::format("Failed to read {0} at offset {1}", path_, position));
+  }
+
+  return (int64_t)read;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> RangeFile::ReadAt(int64_t position, int64_t nbytes) {
+  ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(nbytes));
+  ARROW_ASSIGN_OR_RAISE(auto read, ReadAt(position, nbytes, buffer->mutable_data()));
+  if (read < nbytes) {
+    ARROW_RETURN_NOT_OK(buffer->Resize(read));
+  }
+
+  return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+}
+
+arrow::Result<int64_t> RangeFile::Read(int64_t nbytes, void* out) {
+  ARROW_ASSIGN_OR_RAISE(auto read, ReadAt(position_, nbytes, out));
+  position_ += read;
+  return read;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> RangeFile::Read(int64_t nbytes) {
+  ARROW_ASSIGN_OR_RAISE(auto buffer, ReadAt(position_, nbytes));
+  position_ += buffer->size();
+  return buffer;
+}
+
+} // namespace storage
+} // namespace nebula
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/io/interfaces.h>
+#include <folly/futures/Future.h>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "NFileSystem.h"
+
+/**
+ * Readers on top of ranged reads of a file system object.
+ * They allow parsers to consume remote files while downloading them,
+ * without the need of copying the whole object to a local temp file first.
+ */
+namespace nebula {
+namespace storage {
+
+// A read-only stream buffer which fetches the object chunk by chunk.
+// Next chunk is prefetched in a shared IO pool while current one is being parsed.
+// Seek is supported by fetching the chunk covering the new position.
+class RangeBuffer : public std::streambuf {
+public:
+  RangeBuffer(std::shared_ptr<NFileSystem> fs, const std::string& path, size_t size, size_t chunk);
+  virtual ~RangeBuffer();
+
+protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override;
+  pos_type seekpos(pos_type, std::ios_base::openmode) override;
+
+private:
+  // fetch chunk at given offset of the object, return false if it is beyond the end
+  // throws if the chunk can not be fetched
+  bool load(size_t);
+  folly::Future<std::vector<char>> prefetch(size_t);
+
+private:
+  std::shared_ptr<NFileSystem> fs_;
+  std::string path_;
+  size_t size_;
+  size_t chunk_;
+
+  // object offset of current chunk in buffer
+  size_t offset_;
+  std::vector<char> buffer_;
+
+  // chunk being fetched in background and its object offset
+  size_t nextOffset_;
+  folly::Future<std::vector<char>> next_{ folly::Future<std::vector<char>>::makeEmpty() };
+};
+
+// input stream wrapper owning a range buffer
+class RangeStream : public std::istream {
+public:
+  RangeStream(std::shared_ptr<NFileSystem> fs, const std::string& path, size_t size, size_t chunk)
+    : std::istream(nullptr), buffer_{ std::move(fs), path, size, chunk } {
+    rdbuf(&buffer_);
+    // surface fetch errors to readers instead of a silent end of stream
+    exceptions(std::ios::badbit);
+  }
+  virtual ~RangeStream() = default;
+
+private:
+  RangeBuffer buffer_;
+};
+
+// Random access file for arrow/parquet readers.
+// Parquet reader reads footer and column chunks through ReadAt only,
+// so only the footer and selected columns are fetched from the object.
+class RangeFile : public arrow::io::RandomAccessFile {
+public:
+  RangeFile(std::shared_ptr<NFileSystem> fs, const std::string& path, size_t size)
+    : fs_{ std::move(fs) }, path_{ path }, size_{ (int64_t)size }, position_{ 0 }, closed_{ false } {}
+  virtual ~RangeFile() = default;
+
+public:
+  arrow::Status Close() override {
+    closed_ = true;
+    return arrow::Status::OK();
+  }
+
+  bool closed() const override {
+    return closed_;
+  }
+
+  arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  arrow::Status Seek(int64_t position) override {
+    position_ = position;
+    return arrow::Status::OK();
+  }
+
+  arrow::Result<int64_t> GetSize() override {
+    return size_;
+  }
+
+  arrow::Result<int64_t> Read(int64_t, void*) override;
+  arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t) override;
+  arrow::Result<int64_t> ReadAt(int64_t, int64_t, void*) override;
+  arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(int64_t, int64_t) override;
+
+private:
+  std::shared_ptr<NFileSystem> fs_;
+  std::string path_;
+  int64_t size_;
+  int64_t position_;
+  bool closed_;
+};
+
+} // namespace storage
+} // namespace nebula
@@ -4,8 +4,10 @@ set(NEBULA_STORAGE NStorage)
 # target_include_directories(${NEBULA_META} INTERFACE src/meta)
 add_library(${NEBULA_STORAGE} STATIC 
     ${NEBULA_SRC}/storage/CsvReader.cpp
+    ${NEBULA_SRC}/storage/MappedFile.cpp
     ${NEBULA_SRC}/storage/NFS.cpp
     ${NEBULA_SRC}/storage/ParquetReader.cpp
+    ${NEBULA_SRC}/storage/RangeReader.cpp
     ${NEBULA_SRC}/storage/ThriftReader.cpp
     ${NEBULA_SRC}/storage/aws/S3.cpp
     ${NEBULA_SRC}/storage/azure/DataLake.cpp
@@ -18,6 +18,7 @@
 
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/GetObjectRequest.h>
+#include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsV2Request.h>
 #include <aws/s3/model/PutObjectRequest.h>
 #include <cstdio>
@@ -131,6 +132,43 @@ size_t S3::read(const std::string& key, char* buf, size_t size) {
   return bytes;
 }
 
+size_t S3::read(const std::string& key, const size_t offset, const size_t size, char* buf) {
+  if (size == 0) {
+    return 0;
+  }
+
+  // fetch only the requested bytes through http range header (inclusive end)
+  Aws::S3::Model::GetObjectRequest req;
+  req.SetBucket(this->bucket_);
+  req.SetKey(key);
+  req.SetRange(fmt::format("bytes={0}-{1}", offset, offset + size - 1));
+
+  auto outcome = s3client().GetObject(req);
+  if (!outcome.IsSuccess()) {
+    LOG(ERROR) << "Error reading key: " << key << " at " << offset << ". " << outcome.GetError().GetMessage();
+    return -1;
+  }
+
+  auto& stream = outcome.GetResultWithOwnership().GetBody();
+  stream.read(buf, size);
+  return stream.gcount();
+}
+
+FileInfo S3::info(const std::string& key) {
+  Aws::S3::Model::HeadObjectRequest req;
+  req.SetBucket(this->bucket_);
+  req.SetKey(key);
+
+  auto outcome = s3client().HeadObject(req);
+  if (!outcome.IsSuccess()) {
+    LOG(ERROR) << "Error getting object info: " << key << ". " << outcome.GetError().GetMessage();
+    throw NException("Failed to get object metadata.");
+  }
+
+  const auto& result = outcome.GetResult();
+  return FileInfo(false, 0, result.GetContentLength(), key, bucket_);
+}
+
 bool uploadFile(const Aws::S3::S3Client& client,
                 const std::string& bucket,
                 const std::string& key,
@@ -41,15 +41,15 @@ public:
   virtual std::vector<FileInfo> list(const std::string&) override;
   void read(const std::string&, const std::string&);
   // read a file/object at given offset and length into buffer address provided
-  virtual size_t read(const std::string&, const size_t, const size_t, char*) override {
-    throw NException("Not implemented");
-  }
+  virtual size_t read(const std::string&, const size_t, const size_t, char*) override;
 
   // read a file/object fully into a memory buffer
   virtual size_t read(const std::string&, char*, size_t) override;
 
-  virtual FileInfo info(const std::string&) override {
-    throw NException("Not implemented");
+  virtual FileInfo info(const std::string&) override;
+
+  virtual inline bool ranged() const override {
+    return true;
   }
 
   // download a prefix to a local tmp file - `file to file` operation
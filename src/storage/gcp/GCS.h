@@ -56,6 +56,10 @@ public:
 
   virtual FileInfo info(const std::string&) override;
 
+  virtual inline bool ranged() const override {
+    return true;
+  }
+
   // download a prefix to a local tmp file
   virtual bool copy(const std::string&, const std::string&) override;
 
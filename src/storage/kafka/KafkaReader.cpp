@@ -134,7 +134,30 @@ std::unique_ptr<RdKafka::Message> KafkaReader::message() {
   }
 
   // when this message is consumed from queue, please delete it
-  std::unique_ptr<RdKafka::Message> msg(consumer_->consume(timeoutMs_));
+  // a live reader polls without waiting first, so that idle callback runs before it blocks.
+  std::unique_ptr<RdKafka::Message> msg(consumer_->consume(idle_ ? 0 : timeoutMs_));
+
+  // a live reader doesn't count empty polls, it waits for the segment to be filled up.
+  // the wait is bounded and stopped on shutdown, an incomplete segment is left to be retried.
+  if (idle_) {
+    size_t waited = 0;
+    while (!msg || msg->err() == RdKafka::ERR__TIMED_OUT || msg->err() == RdKafka::ERR__PARTITION_EOF) {
+      if (KafkaTopic::tailStopped() || waited >= KafkaTopic::tailWaitMs()) {
+        LOG(WARNING) << "Live segment not filled up: " << segment_.id() << ", consumed=" << this->size_;
+        incomplete_ = true;
+        return nullptr;
+      }
+
+      idle_();
+      msg.reset(consumer_->consume(timeoutMs_));
+      waited += timeoutMs_;
+    }
+
+    // the last message of the segment
+    if (msg->offset() >= max_ - 1) {
+      this->size_ = segment_.size - 1;
+    }
+  }
 
   // message may be empty
   if (msg && msg->len() > 0) {
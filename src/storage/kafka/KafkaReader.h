@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "KafkaProvider.h"
 #include "KafkaTopic.h"
 
@@ -38,13 +40,17 @@ class KafkaReader : public nebula::surface::RowCursor {
   static constexpr size_t SLICE_SIZE = 1024;
 
 public:
+  // a live reader (with idle callback) waits for messages until the segment is filled up,
+  // idle callback is invoked whenever it's about to wait for new messages.
   KafkaReader(nebula::meta::TableSpecPtr table,
               KafkaSegment segment,
-              size_t timeoutMs = 3000)
+              size_t timeoutMs = 3000,
+              std::function<void()> idle = nullptr)
     : nebula::surface::RowCursor(0),
       table_{ table },
       segment_{ std::move(segment) },
       timeoutMs_{ timeoutMs },
+      idle_{ std::move(idle) },
       row_{ SLICE_SIZE, true } {
     // initialize consumer and parser
     init();
@@ -66,6 +72,11 @@ public:
     throw NException("Kafka Reader does not support random access by row number");
   }
 
+  // a live reader stopped before its segment is filled up
+  inline bool incomplete() const {
+    return incomplete_;
+  }
+
 private:
   // load all messages in the repo
   void init();
@@ -77,6 +88,7 @@ private:
   nebula::meta::TableSpecPtr table_;
   KafkaSegment segment_;
   size_t timeoutMs_;
+  std::function<void()> idle_;
 
   // queue of messages, when reader starts it will pumping messages into this queue
   nebula::memory::FlatRow row_;
@@ -87,6 +99,7 @@ private:
   std::unique_ptr<RowParser> parser_;
   int64_t max_;
   size_t errors_;
+  bool incomplete_ = false;
   std::unique_ptr<RdKafka::Message> msg_;
 };
 
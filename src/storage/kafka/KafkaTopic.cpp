@@ -17,12 +17,16 @@
 #include "KafkaTopic.h"
 #include "KafkaConfig.h"
 
+#include <atomic>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "common/Evidence.h"
 #include "common/Wrap.h"
 
+DEFINE_uint64(KAFKA_TAIL_MS, 0, "interval in ms to publish rows of a kafka segment consumed live, 0 to wait for full segments");
+DEFINE_uint64(KAFKA_TAIL_WAIT_MS, 600000, "max ms a live kafka segment waits for new messages before it gives up to be retried");
+
 /**
  * Kafka topic wrapping topic metadata store.
  */
@@ -32,6 +36,26 @@ namespace kafka {
 
 using nebula::common::vector_reserve;
 
+namespace {
+std::atomic<bool> TAIL_STOPPED{ false };
+} // namespace
+
+size_t KafkaTopic::tailMs() noexcept {
+  return FLAGS_KAFKA_TAIL_MS;
+}
+
+size_t KafkaTopic::tailWaitMs() noexcept {
+  return FLAGS_KAFKA_TAIL_WAIT_MS;
+}
+
+void KafkaTopic::stopTail() noexcept {
+  TAIL_STOPPED.store(true, std::memory_order_relaxed);
+}
+
+bool KafkaTopic::tailStopped() noexcept {
+  return TAIL_STOPPED.load(std::memory_order_relaxed);
+}
+
 bool KafkaTopic::init(const std::unordered_map<std::string, std::string>& settings) noexcept {
   // set up the kafka configurations
 
@@ -175,6 +199,12 @@ std::list<KafkaSegment> KafkaTopic::segmentsByTimestamp(size_t timeMs, size_t wi
       segments.emplace_back(part, width * start++, width);
     }
 
+    // in live tail mode, the open band is consumed as messages arrive until it's filled up.
+    // it shares the same segment ID with its full band so it's never consumed twice.
+    if (tailMs() > 0 && highOffset > (int64_t)(width * end)) {
+      segments.emplace_back(part, width * end, width);
+    }
+
     // unassign
     consumer->unassign();
   }
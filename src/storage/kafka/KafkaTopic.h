@@ -77,6 +77,16 @@ public:
 public:
   std::list<KafkaSegment> segmentsByTimestamp(size_t, size_t) noexcept;
 
+  // interval in ms to publish rows of a segment consumed live, 0 if live tail is disabled
+  static size_t tailMs() noexcept;
+
+  // max time in ms a live segment waits without any new message
+  static size_t tailWaitMs() noexcept;
+
+  // signal all live segments to stop waiting (eg. node is shutting down)
+  static void stopTail() noexcept;
+  static bool tailStopped() noexcept;
+
   // raw pointer for reference only
   inline RdKafka::Conf* conf() const {
     return conf_.get();
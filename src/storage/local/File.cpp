@@ -91,6 +91,13 @@ FileInfo File::info(const std::string& file) {
     "");
 }
 
+size_t File::read(const std::string& file, const size_t offset, const size_t size, char* buf) {
+  std::ifstream fs(file, std::ios::binary);
+  fs.seekg(offset, std::ios::beg);
+  fs.read(buf, size);
+  return fs.gcount();
+}
+
 size_t File::read(const std::string& file, char* buf, size_t size) {
   std::ifstream fs(file);
   fs.seekg(0, std::ios::end);
@@ -34,9 +34,7 @@ public:
   virtual std::vector<FileInfo> list(const std::string& dir) override;
 
   // read a file/object at given offset and length into buffer address provided
-  virtual size_t read(const std::string&, const size_t, const size_t, char*) override {
-    throw NException("Not implemented");
-  }
+  virtual size_t read(const std::string&, const size_t, const size_t, char*) override;
 
   // read a file/object fully into a memory buffer
   virtual size_t read(const std::string&, char*, size_t) override;
@@ -44,6 +42,10 @@ public:
   // return file info of given file path
   virtual FileInfo info(const std::string&) override;
 
+  virtual inline bool ranged() const override {
+    return true;
+  }
+
   virtual inline bool copy(const std::string& from, const std::string& to) override {
     // TODO(cao): it doesn't copy anything if options specified (e.g replace_existing)
     using co = std::filesystem::copy_options;
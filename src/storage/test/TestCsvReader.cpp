@@ -14,12 +14,17 @@
  * limitations under the License.
  */
 
+#include <cstdio>
+#include <fstream>
 #include <fmt/format.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 #include <sstream>
 
 #include "storage/CsvReader.h"
+#include "storage/MappedFile.h"
+#include "storage/RangeReader.h"
+#include "storage/local/File.h"
 
 namespace nebula {
 namespace storage {
@@ -198,6 +203,100 @@ TEST(CsvTest, TestCsvReadSubFields) {
   EXPECT_EQ(lines, 267);
 }
 
+TEST(CsvTest, TestCsvStreaming) {
+  // tiny chunk to cross many chunk boundaries in a single row
+  constexpr auto file = "test/data/birthrate.csv";
+  constexpr auto chunk = 97;
+  std::shared_ptr<NFileSystem> fs = std::make_shared<nebula::storage::local::File>();
+  auto size = fs->info(file).size;
+
+  nebula::meta::CsvProps csv{ true, false, "," };
+  nebula::storage::CsvReader expected(file, csv, {});
+  nebula::storage::CsvReader reader(std::make_unique<RangeStream>(fs, file, size, chunk), file, csv, {});
+  auto lines = 0;
+  while (expected.hasNext()) {
+    ASSERT_TRUE(reader.hasNext());
+    auto e = std::string(expected.next().readString("country_name"));
+    EXPECT_EQ(reader.next().readString("country_name"), e);
+    ++lines;
+  }
+
+  EXPECT_FALSE(reader.hasNext());
+  EXPECT_EQ(lines, 267);
+}
+
+TEST(CsvTest, TestCsvChunks) {
+  constexpr auto file = "test/data/birthrate.csv";
+  nebula::meta::CsvProps csv{ true, false, "," };
+  auto mapped = std::make_shared<MappedFile>(file);
+  auto chunks = mapped->lines(5, true);
+  EXPECT_GT(chunks.size(), 1);
+  EXPECT_LE(chunks.size(), 5);
+  EXPECT_EQ(chunks.front().first, 0);
+  EXPECT_EQ(chunks.back().second, mapped->size());
+
+  // rows of all chunks in order should be the same as reading the whole file
+  nebula::storage::CsvReader expected(file, csv, {});
+  auto lines = 0;
+  for (const auto& chunk : chunks) {
+    nebula::storage::CsvChunkReader reader(mapped, chunk, csv, {});
+    while (reader.hasNext()) {
+      ASSERT_TRUE(expected.hasNext());
+      auto e = std::string(expected.next().readString("country_name"));
+      EXPECT_EQ(reader.next().readString("country_name"), e);
+      ++lines;
+    }
+  }
+
+  EXPECT_FALSE(expected.hasNext());
+  EXPECT_EQ(lines, 267);
+}
+
+TEST(CsvTest, TestCsvChunksQuoted) {
+  // line breaks inside quoted fields should never become a chunk boundary
+  auto file = "/tmp/nebula.test.chunks.csv";
+  {
+    std::ofstream out(file);
+    out << "id,text\n";
+    for (auto i = 0; i < 100; ++i) {
+      out << i << ",\"line\n\"\"" << i << "\"\"\nend\"\n";
+    }
+  }
+
+  nebula::meta::CsvProps csv{ true, false, "," };
+  auto mapped = std::make_shared<MappedFile>(file);
+  auto id = 0;
+  for (const auto& chunk : mapped->lines(7, true)) {
+    nebula::storage::CsvChunkReader reader(mapped, chunk, csv, {});
+    while (reader.hasNext()) {
+      const auto& row = reader.next();
+      EXPECT_EQ(row.readString("id"), std::to_string(id));
+      EXPECT_EQ(row.readString("text"), fmt::format("line\n\"{0}\"\nend", id));
+      ++id;
+    }
+  }
+
+  EXPECT_EQ(id, 100);
+  std::remove(file);
+}
+
+TEST(CsvTest, TestCsvGzipStreaming) {
+  nebula::meta::CsvProps csv{ true, false, ",", "gz" };
+  nebula::meta::CsvProps plain{ true, false, "," };
+  nebula::storage::CsvReader expected("test/data/test.csv", plain, {});
+  nebula::storage::CsvReader reader("test/data/test.csv.gz", csv, {});
+  auto lines = 0;
+  while (expected.hasNext()) {
+    ASSERT_TRUE(reader.hasNext());
+    auto e = std::string(expected.next().readString("uuid"));
+    EXPECT_EQ(reader.next().readString("uuid"), e);
+    ++lines;
+  }
+
+  EXPECT_FALSE(reader.hasNext());
+  EXPECT_GT(lines, 0);
+}
+
 TEST(CsvTest, TestCsvWithMeta) {
   nebula::meta::CsvProps csv{ true, true, "," };
   nebula::storage::CsvReader reader("test/data/meta.csv", csv, {});
@@ -24,7 +24,9 @@
 #include <parquet/types.h>
 
 #include "common/Evidence.h"
+#include "memory/Batch.h"
 #include "storage/ParquetReader.h"
+#include "storage/RangeReader.h"
 #include "storage/aws/S3.h"
 #include "storage/local/File.h"
 #include "type/Serde.h"
@@ -34,6 +36,7 @@ namespace storage {
 namespace test {
 
 // using ConvertedType = parquet::LogicalType::type;
+using nebula::memory::Batch;
 using nebula::surface::RowData;
 using nebula::type::TypeSerializer;
 using parquet::Repetition;
@@ -495,6 +498,137 @@ TEST(ParquetTest, TestReadThroughFlatRow) {
   }
 
   EXPECT_EQ(rows, numRows);
+
+  // read the same file through ranged reads should produce the same rows
+  std::shared_ptr<NFileSystem> fs = std::make_shared<nebula::storage::local::File>();
+  auto size = fs->info(readWriteSample).size;
+  ParquetReader local(readWriteSample, schema, {});
+  ParquetReader ranged(std::make_shared<RangeFile>(fs, readWriteSample, size), schema, {});
+  rows = 0;
+  while (local.hasNext()) {
+    EXPECT_TRUE(ranged.hasNext());
+    auto expected = toString(local.next());
+    EXPECT_EQ(toString(ranged.next()), expected);
+    rows++;
+  }
+
+  EXPECT_FALSE(ranged.hasNext());
+  EXPECT_EQ(rows, numRows);
+}
+
+TEST(ParquetTest, TestRowGroupRange) {
+  const char readWriteSample[] = "parquet_sample_file_row_group_range";
+  constexpr auto numRows = 259999;
+  EXPECT_TRUE(writeParquetFile(readWriteSample, numRows));
+
+  auto schema = TypeSerializer::from("ROW<int32_field:int, int64_field:long, ba_field:string>");
+  ParquetReader reader(readWriteSample, schema, {});
+  const auto groups = reader.groups();
+  LOG(INFO) << "Total row groups: " << groups;
+  EXPECT_GT(groups, 0);
+
+  // read every row group through its own reader should produce the same rows in order
+  size_t rows = 0;
+  for (size_t g = 0; g < groups; ++g) {
+    ParquetReader part(readWriteSample, schema, {});
+    part.range(g, g + 1);
+    while (part.hasNext()) {
+      EXPECT_TRUE(reader.hasNext());
+      const auto& expected = reader.next();
+      const auto& row = part.next();
+      EXPECT_EQ(row.readInt("int32_field"), expected.readInt("int32_field"));
+      EXPECT_EQ(row.readLong("int64_field"), expected.readLong("int64_field"));
+      EXPECT_EQ(row.isNull("ba_field"), expected.isNull("ba_field"));
+      ++rows;
+    }
+  }
+
+  EXPECT_FALSE(reader.hasNext());
+  EXPECT_EQ(rows, numRows);
+
+  // an empty range has nothing to read
+  ParquetReader empty(readWriteSample, schema, {});
+  empty.range(1, 1);
+  EXPECT_FALSE(empty.hasNext());
+}
+
+TEST(ParquetTest, TestColumnarRead) {
+  const char readWriteSample[] = "parquet_sample_file_columnar_read";
+  constexpr auto numRows = 25999;
+  EXPECT_TRUE(writeParquetFile(readWriteSample, numRows));
+
+  // boolean field is not stored in the batch so that it is visited by rows
+  auto schema = TypeSerializer::from(
+    "ROW<boolean_field:bool, int32_field:int, double_field:double, ba_field:string>");
+  nebula::meta::ColumnProps props;
+  props.emplace("ba_field", nebula::meta::Column{ false, true });
+  nebula::meta::Table table(
+    "parquet",
+    TypeSerializer::from("ROW<int32_field:int, double_field:double, ba_field:string>"),
+    props,
+    {});
+  Batch batch(table, numRows);
+
+  ParquetReader reader(readWriteSample, schema, {});
+  size_t visits = 0;
+  size_t trues = 0;
+  while (reader.hasNext()) {
+    const auto rows = reader.read(batch, 1000, [&visits, &trues](const RowData& row) {
+      ++visits;
+      trues += row.readBool("boolean_field");
+    });
+    EXPECT_GT(rows, 0);
+    EXPECT_EQ(batch.commit(rows), visits);
+  }
+
+  EXPECT_EQ(visits, numRows);
+  EXPECT_EQ(trues, (numRows + 1) / 2);
+  EXPECT_EQ(batch.getRows(), numRows);
+
+  // every row in the batch should be the same as read row by row
+  ParquetReader expected(readWriteSample, schema, {});
+  auto accessor = batch.makeAccessor();
+  for (size_t i = 0; expected.hasNext(); ++i) {
+    const auto& row = expected.next();
+    const auto& r = accessor->seek(i);
+    EXPECT_EQ(r.readInt("int32_field").value(), row.readInt("int32_field"));
+    EXPECT_EQ(r.readDouble("double_field").value(), row.readDouble("double_field"));
+    if (row.isNull("ba_field")) {
+      EXPECT_FALSE(r.readString("ba_field").has_value());
+    } else {
+      EXPECT_EQ(r.readString("ba_field").value(), row.readString("ba_field"));
+    }
+  }
+}
+
+TEST(ParquetTest, TestColumnarConvert) {
+  const char readWriteSample[] = "parquet_sample_file_columnar_convert";
+  constexpr auto numRows = 5999;
+  EXPECT_TRUE(writeParquetFile(readWriteSample, numRows));
+
+  // columns read as types different from their physical types are converted as in row reading
+  auto schema = TypeSerializer::from("ROW<int32_field:int128, float_field:string, double_field:string>");
+  nebula::meta::Table table("parquet", schema, {}, {});
+  Batch batch(table, numRows);
+
+  ParquetReader reader(readWriteSample, schema, {});
+  while (reader.hasNext()) {
+    batch.commit(reader.read(batch, 1000, [](const RowData&) {}));
+  }
+
+  EXPECT_EQ(batch.getRows(), numRows);
+
+  ParquetReader expected(readWriteSample, schema, {});
+  auto accessor = batch.makeAccessor();
+  for (size_t i = 0; expected.hasNext(); ++i) {
+    const auto& row = expected.next();
+    const auto& r = accessor->seek(i);
+    // int128 is not printable by gtest
+    EXPECT_TRUE(r.readInt128("int32_field").value() == (int128_t)i);
+    EXPECT_TRUE(r.readInt128("int32_field").value() == row.readInt128("int32_field"));
+    EXPECT_EQ(r.readString("float_field").value(), row.readString("float_field"));
+    EXPECT_EQ(r.readString("double_field").value(), row.readString("double_field"));
+  }
 }
 
 TEST(ParquetTest, DISABLED_TestRealParquetFile) {
@@ -99,6 +99,12 @@ public:
     return nullptr;
   }
 
+  // a row bound to a schema serves index based interfaces by column ordinals of the schema,
+  // writers like Batch::add check it once per row to read fields without name lookups.
+  virtual bool bound(const nebula::type::Schema&) const {
+    return false;
+  }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 #define NOT_IMPL_FUNC(TYPE, FUNC)                                 \
   virtual TYPE FUNC(IndexType) const {                            \
@@ -179,6 +185,25 @@ public:
   virtual std::optional<double> readDouble(const std::string&) const = 0;
   virtual std::optional<int128_t> readInt128(const std::string&) const = 0;
   virtual std::optional<std::string_view> readString(const std::string&) const = 0;
+
+  // read by column ordinal of the schema this accessor is bound to,
+  // expressions bound at plan time read columns through these interfaces.
+#define NOT_IMPL_FUNC(TYPE, FUNC)                                 \
+  virtual std::optional<TYPE> FUNC(IndexType) const {             \
+    throw NException(#FUNC " (IndexType index) not implemented"); \
+  }
+
+  NOT_IMPL_FUNC(bool, readBool)
+  NOT_IMPL_FUNC(int8_t, readByte)
+  NOT_IMPL_FUNC(int16_t, readShort)
+  NOT_IMPL_FUNC(int32_t, readInt)
+  NOT_IMPL_FUNC(int64_t, readLong)
+  NOT_IMPL_FUNC(float, readFloat)
+  NOT_IMPL_FUNC(double, readDouble)
+  NOT_IMPL_FUNC(int128_t, readInt128)
+  NOT_IMPL_FUNC(std::string_view, readString)
+
+#undef NOT_IMPL_FUNC
 };
 
 } // namespace surface
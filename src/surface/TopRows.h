@@ -17,52 +17,88 @@
 #pragma once
 
 #include <algorithm>
-#include <queue>
+#include <numeric>
 #include "DataSurface.h"
 #include "common/Cursor.h"
 
 /**
- * Implement a sorting and top cutoff wrapper for row cursor to return all values
+ * Implement a sorting and top cutoff wrapper for row cursor to return all values.
+ * Sort keys are typed columns extracted from source rows once, the top K rows are selected
+ * through a bounded heap of row indices, so comparisons allocate nothing and read no field by name.
  */
 namespace nebula {
 namespace surface {
-class TopRows : public RowCursor {
-  using Less = std::function<bool(const std::unique_ptr<RowData>&, const std::unique_ptr<RowData>&)>;
 
+// A sort key holds values of a sort column for all rows in the order of the source cursor
+class SortKey {
+public:
+  virtual ~SortKey() = default;
+
+  // compare two rows by their index, negative if left row goes first
+  virtual int compare(size_t, size_t) const = 0;
+};
+
+using SortKeys = std::vector<std::unique_ptr<SortKey>>;
+
+template <typename T>
+class TypedSortKey : public SortKey {
+public:
+  TypedSortKey(size_t rows, bool desc) : desc_{ desc } {
+    values_.reserve(rows);
+    nulls_.reserve(rows);
+  }
+  virtual ~TypedSortKey() = default;
+
+  template <typename V>
+  inline void add(bool isNull, V&& value) {
+    nulls_.push_back(isNull);
+    values_.emplace_back(std::forward<V>(value));
+  }
+
+  // null goes last in either order
+  virtual int compare(size_t left, size_t right) const override {
+    const bool ln = nulls_[left];
+    const bool rn = nulls_[right];
+    if (ln || rn) {
+      return ln == rn ? 0 : (ln ? 1 : -1);
+    }
+
+    const auto& lv = values_[left];
+    const auto& rv = values_[right];
+    if (lv == rv) {
+      return 0;
+    }
+
+    return (lv < rv) != desc_ ? -1 : 1;
+  }
+
+private:
+  std::vector<T> values_;
+  std::vector<bool> nulls_;
+  bool desc_;
+};
+
+class TopRows : public RowCursor {
 public:
-  // top rows will pick sorted top N rows, if max is 0, it means we don't apply limit and return all
-  TopRows(const RowCursorPtr& rows, size_t max, Less less)
+  // top rows will pick sorted top N rows, if max is 0, it means we don't apply limit and return all.
+  // keys hold values of all rows in source, without keys rows are returned as they are.
+  TopRows(const RowCursorPtr& rows, size_t max, SortKeys keys)
     : RowCursor(max == 0 ? rows->size() : std::min(max, rows->size())),
-      heap_(rows->size()),
-      rows_{ rows } {
-    // build heap / priority queue
-    if (less != nullptr) {
-      compare_ = [this, func = std::move(less)](size_t left, size_t right) -> bool {
-        return func(rows_->item(left), rows_->item(right));
-      };
-
-      // fill the vector with its index
-      std::iota(heap_.begin(), heap_.end(), 0);
-      std::make_heap(heap_.begin(), heap_.end(), compare_);
+      rows_{ rows },
+      keys_{ std::move(keys) } {
+    if (!keys_.empty()) {
+      select(rows_->size());
     }
   }
 
-  // TODO(cao) - might be too expensive if there are many items/rows to iterate on
   virtual const RowData& next() override {
-    // stop condition
-    index_++;
-
     // no need heap
-    if (!compare_) {
+    if (keys_.empty()) {
+      index_++;
       return rows_->next();
     }
 
-    // fetch the top one and return its value
-    std::pop_heap(heap_.begin(), heap_.end(), compare_);
-    auto top = heap_.back();
-    heap_.pop_back();
-
-    current_ = rows_->item(top);
+    current_ = rows_->item(order_.at(index_++));
     return *current_;
   }
 
@@ -70,13 +106,66 @@ public:
     throw NException("Top rows do not support random access.");
   }
 
+  // drain all remaining top rows as their indices in source cursor,
+  // so that a consumer can pick them from the source directly.
+  std::vector<size_t> indices() {
+    std::vector<size_t> result;
+    if (keys_.empty()) {
+      result.resize(size_ - index_);
+      std::iota(result.begin(), result.end(), index_);
+    } else {
+      result.assign(order_.begin() + index_, order_.begin() + size_);
+    }
+
+    index_ = size_;
+    return result;
+  }
+
+  inline const RowCursorPtr& rows() const {
+    return rows_;
+  }
+
+private:
+  // row of left index goes before row of right index,
+  // ties are broken by index to keep result stable
+  inline bool before(size_t left, size_t right) const {
+    for (const auto& key : keys_) {
+      auto c = key->compare(left, right);
+      if (c != 0) {
+        return c < 0;
+      }
+    }
+
+    return left < right;
+  }
+
+  // keep the best K rows in a max heap whose front is the worst one kept,
+  // every other row replaces it if it goes before, then sort the K rows.
+  void select(size_t rows) {
+    const auto less = [this](size_t left, size_t right) { return before(left, right); };
+    order_.reserve(size_);
+    for (size_t i = 0; i < rows; ++i) {
+      if (order_.size() < size_) {
+        order_.push_back(i);
+        std::push_heap(order_.begin(), order_.end(), less);
+      } else if (before(i, order_.front())) {
+        std::pop_heap(order_.begin(), order_.end(), less);
+        order_.back() = i;
+        std::push_heap(order_.begin(), order_.end(), less);
+      }
+    }
+
+    std::sort_heap(order_.begin(), order_.end(), less);
+  }
+
 private:
-  std::vector<size_t> heap_;
   RowCursorPtr rows_;
-  std::function<bool(size_t, size_t)> compare_;
+  SortKeys keys_;
 
+  // selected row indices in order
+  std::vector<size_t> order_;
   std::unique_ptr<RowData> current_;
-}; // namespace surface
+};
 
 } // namespace surface
-} // namespace nebula
\ No newline at end of file
+} // namespace nebula
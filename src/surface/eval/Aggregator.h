@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fmt/format.h>
+#include <limits>
 
 #include "common/Memory.h"
 #include "type/Type.h"
@@ -43,6 +45,12 @@ public:
   // deserialize from a given buffer, and offset, return total size consumed
   virtual size_t load(nebula::common::ExtendableSlice&, size_t) = 0;
 
+  // hint serde framework to compress serialized binary of this sketch when it's large,
+  // it only applies to sketch not fit in given storage, and should be constant per sketch type.
+  virtual bool compressible() const {
+    return false;
+  }
+
   // aggregate another sketch
   virtual void mix(const Sketch&) = 0;
 };
@@ -100,6 +108,129 @@ public:
   }
 };
 
+// Fixed width aggregations whose state can live inline in a row rather than in a sketch object.
+// The state is laid out exactly as the sketch of the same UDAF serializes itself,
+// so a sketch can always be loaded from an inline state and vice versa.
+enum class Reduce : int8_t {
+  NONE,
+  SUM,
+  COUNT,
+  MIN,
+  MAX,
+  AVG
+};
+
+// Typed kernels to update an inline state at given offset of a slice without virtual dispatch.
+// - width: number of bytes of the state
+// - init: reset the state as empty
+// - merge: aggregate an input value into the state
+// - mix: aggregate another state (at second offset) into the state
+template <Reduce R, nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer {
+  static constexpr size_t width = 0;
+};
+
+#define REDUCER_TYPES                                                   \
+  using InputType = typename nebula::type::TypeTraits<IK>::CppType;    \
+  using NativeType = typename nebula::type::TypeTraits<OK>::CppType;   \
+  static constexpr size_t width = sizeof(NativeType);
+
+template <nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer<Reduce::SUM, OK, IK> {
+  REDUCER_TYPES
+
+  static inline void init(nebula::common::ExtendableSlice& slice, size_t offset) {
+    slice.write(offset, NativeType(0));
+  }
+
+  static inline void merge(nebula::common::ExtendableSlice& slice, size_t offset, InputType v) {
+    slice.write(offset, NativeType(slice.read<NativeType>(offset) + v));
+  }
+
+  static inline void mix(nebula::common::ExtendableSlice& slice, size_t offset, size_t other) {
+    slice.write(offset, NativeType(slice.read<NativeType>(offset) + slice.read<NativeType>(other)));
+  }
+};
+
+template <nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer<Reduce::COUNT, OK, IK> {
+  REDUCER_TYPES
+
+  static inline void init(nebula::common::ExtendableSlice& slice, size_t offset) {
+    slice.write(offset, NativeType(0));
+  }
+
+  static inline void merge(nebula::common::ExtendableSlice& slice, size_t offset, InputType) {
+    slice.write(offset, NativeType(slice.read<NativeType>(offset) + 1));
+  }
+
+  static inline void mix(nebula::common::ExtendableSlice& slice, size_t offset, size_t other) {
+    slice.write(offset, NativeType(slice.read<NativeType>(offset) + slice.read<NativeType>(other)));
+  }
+};
+
+template <nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer<Reduce::MIN, OK, IK> {
+  REDUCER_TYPES
+
+  static inline void init(nebula::common::ExtendableSlice& slice, size_t offset) {
+    slice.write(offset, std::numeric_limits<NativeType>::max());
+  }
+
+  static inline void merge(nebula::common::ExtendableSlice& slice, size_t offset, InputType v) {
+    slice.write(offset, std::min<NativeType>(slice.read<NativeType>(offset), v));
+  }
+
+  static inline void mix(nebula::common::ExtendableSlice& slice, size_t offset, size_t other) {
+    merge(slice, offset, slice.read<NativeType>(other));
+  }
+};
+
+template <nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer<Reduce::MAX, OK, IK> {
+  REDUCER_TYPES
+
+  static inline void init(nebula::common::ExtendableSlice& slice, size_t offset) {
+    slice.write(offset, std::numeric_limits<NativeType>::lowest());
+  }
+
+  static inline void merge(nebula::common::ExtendableSlice& slice, size_t offset, InputType v) {
+    slice.write(offset, std::max<NativeType>(slice.read<NativeType>(offset), v));
+  }
+
+  static inline void mix(nebula::common::ExtendableSlice& slice, size_t offset, size_t other) {
+    merge(slice, offset, slice.read<NativeType>(other));
+  }
+};
+
+// state of avg is [sum, 4 bytes count]
+template <nebula::type::Kind OK, nebula::type::Kind IK>
+struct Reducer<Reduce::AVG, OK, IK> {
+  using InputType = typename nebula::type::TypeTraits<IK>::CppType;
+  using StoreType = typename std::conditional_t<std::is_floating_point_v<InputType>, double,
+                                                std::conditional_t<std::is_same_v<InputType, int128_t>, int128_t, int64_t>>;
+  static constexpr size_t width = sizeof(StoreType) + sizeof(int32_t);
+
+  static inline void init(nebula::common::ExtendableSlice& slice, size_t offset) {
+    slice.write(offset, StoreType(0));
+    slice.write(offset + sizeof(StoreType), int32_t(0));
+  }
+
+  static inline void merge(nebula::common::ExtendableSlice& slice, size_t offset, InputType v) {
+    slice.write(offset, StoreType(slice.read<StoreType>(offset) + v));
+    const auto co = offset + sizeof(StoreType);
+    slice.write(co, int32_t(slice.read<int32_t>(co) + 1));
+  }
+
+  static inline void mix(nebula::common::ExtendableSlice& slice, size_t offset, size_t other) {
+    slice.write(offset, StoreType(slice.read<StoreType>(offset) + slice.read<StoreType>(other)));
+    const auto co = offset + sizeof(StoreType);
+    slice.write(co, int32_t(slice.read<int32_t>(co) + slice.read<int32_t>(other + sizeof(StoreType))));
+  }
+};
+
+#undef REDUCER_TYPES
+
 /** BELOW two macro provides global templating for switch/case 
  * with full combination of input/output types
  * 
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017-present varchar.io
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "type/Type.h"
+
+/**
+ * Columnar interface to serve typed values of a column in bulk.
+ * Together with a selection vector, it enables batch evaluation of expressions
+ * by running tight typed loops over a slice of rows rather than a virtual dispatch per row.
+ */
+namespace nebula {
+namespace surface {
+namespace eval {
+
+// selection vector - row IDs (in a block) to be processed in current batch
+using Selection = std::vector<uint32_t>;
+
+class Columnar {
+public:
+  virtual ~Columnar() = default;
+
+  // read values of given column for all selected rows into values and nulls,
+  // both buffers are expected to have at least selection.size() slots.
+  // return false if the column can not be served in bulk (eg. partition column or unknown column),
+  // in which case caller is supposed to fall back to row by row evaluation.
+#define VECTOR_READ(TYPE) \
+  virtual bool read(const std::string&, const Selection&, TYPE*, bool*) const = 0;
+
+  VECTOR_READ(bool)
+  VECTOR_READ(int8_t)
+  VECTOR_READ(int16_t)
+  VECTOR_READ(int32_t)
+  VECTOR_READ(int64_t)
+  VECTOR_READ(float)
+  VECTOR_READ(double)
+  VECTOR_READ(int128_t)
+  VECTOR_READ(std::string_view)
+
+#undef VECTOR_READ
+
+  // dictionary of a string column: number of distinct values,
+  // 0 if the column is not served by dictionary codes.
+  virtual size_t dictSize(const std::string&) const = 0;
+
+  // distinct value of given code in the dictionary of a column
+  virtual std::string_view dictItem(const std::string&, int32_t) const = 0;
+
+  // read dictionary codes of selected rows, return false if the column is not served by dictionary codes.
+  virtual bool codes(const std::string&, const Selection&, int32_t*, bool*) const = 0;
+};
+
+// A vector kernel narrows the selection in place to rows matching a predicate.
+// The result selection is always a super set of the real matches,
+// return value indicates whether it is exact (true) or still needs row evaluation (false).
+using EvalVector = std::function<bool(const Columnar&, Selection&)>;
+
+// per thread scratch buffer with at least <size> slots, grown on demand and reused across batches.
+// kernels in a thread run one after another, a buffer is only held within a kernel call,
+// Slot tells apart buffers of the same type needed by one kernel at the same time.
+template <typename T, size_t Slot = 0>
+T* scratch(size_t size) {
+  static thread_local std::unique_ptr<T[]> buffer;
+  static thread_local size_t capacity = 0;
+  if (capacity < size) {
+    buffer = std::make_unique<T[]>(size);
+    capacity = size;
+  }
+
+  return buffer.get();
+}
+
+} // namespace eval
+} // namespace surface
+} // namespace nebula
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <functional>
 #include <glog/logging.h>
+#include <limits>
 
 #include <quickjs.h>
 extern "C" {
@@ -24,6 +26,7 @@ extern "C" {
 }
 
 #include "Block.h"
+#include "Columnar.h"
 #include "Operation.h"
 #include "Script.h"
 
@@ -61,6 +64,21 @@ inline BlockEval uncertain(const Block&) {
   return BlockEval::PARTIAL;
 }
 
+class ValueEval;
+
+// a column reference in an expression tree, resolved once at plan time (see BlockPhase::bind)
+// to either an ordinal of the plan input schema or a custom column shadowing the name.
+// evaluation reads an unbound column by its name.
+struct Binding {
+  static constexpr size_t UNBOUND = std::numeric_limits<size_t>::max();
+
+  explicit Binding(const std::string& n) : name{ n }, ordinal{ UNBOUND }, custom{ nullptr } {}
+
+  const std::string name;
+  size_t ordinal;
+  const ValueEval* custom;
+};
+
 // this is a tree, with each node to be either macro/value or operator
 // this is translated from expression.
 class ValueEval {
@@ -113,6 +131,36 @@ public:
   // evaluate the whole block of data and determine if process the block or not
   virtual BlockEval eval(const Block&) const = 0;
 
+  // vector kernel to filter a batch of rows in columnar way, could be empty if not supported.
+  inline const EvalVector& kernel() const {
+    return kernel_;
+  }
+
+  inline void kernel(EvalVector ev) {
+    kernel_ = std::move(ev);
+  }
+
+  // fixed width aggregation can be reduced inline without sketch objects, NONE if not supported.
+  inline Reduce reduce() const {
+    return reduce_;
+  }
+
+  inline void reduce(Reduce r) {
+    reduce_ = r;
+  }
+
+  // column reference of a column expression, nullptr for any other expression.
+  inline Binding* binding() const {
+    return binding_.get();
+  }
+
+  inline void binding(std::shared_ptr<Binding> b) {
+    binding_ = std::move(b);
+  }
+
+  // visit every expression of this tree including itself
+  virtual void walk(const std::function<void(ValueEval&)>&) = 0;
+
 public:
   // identify a unique value evaluation object in given query context
   // TODO(cao) - consider using number instead for fast hashing
@@ -142,6 +190,9 @@ protected:
   nebula::type::Kind input_;
   nebula::type::Kind output_;
   bool aggregate_;
+  EvalVector kernel_;
+  Reduce reduce_ = Reduce::NONE;
+  std::shared_ptr<Binding> binding_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -195,6 +246,13 @@ public:
     return eb_(b);
   }
 
+  virtual void walk(const std::function<void(ValueEval&)>& visitor) override {
+    visitor(*this);
+    for (auto& c : children_) {
+      c->walk(visitor);
+    }
+  }
+
 private:
   OPT op_;
   EvalBlock eb_;
@@ -281,10 +339,6 @@ public:
 
   template <typename T>
   inline std::optional<T> read(const std::string& col) {
-    // TODO(cao) - not ideal branching. we should be able to compile this before execution
-    // fast lookup - best to turn all column's value materialization into a function pointer - type agnostic?
-    // we exactly know what method to call for every single column
-
     // perf: we pay this check for every read
     if (N_UNLIKELY(scriptData_ != nullptr)) {
       ValueEval* ve = scriptData_->column(col);
@@ -293,55 +347,76 @@ public:
       }
     }
 
-    // return *row_;
-    // compile time branching based on template type T
-    // I think it's better than using template specialization for this case
+    return fetch<T>(col);
+  }
+
+  // read a column resolved at plan time, it avoids any lookup by name for every row
+  // as long as the row object serves reads by ordinal of the plan input schema.
+  template <typename T>
+  inline std::optional<T> read(const Binding& binding) {
+    if (N_UNLIKELY(binding.custom != nullptr)) {
+      return binding.custom->eval<T>(*this);
+    }
+
+    if (N_UNLIKELY(binding.ordinal == Binding::UNBOUND)) {
+      return read<T>(binding.name);
+    }
+
+    return fetch<T>(binding.ordinal);
+  }
+
+#undef NULL_CHECK
+
+  inline ScriptContext& script() const {
+    return *script_;
+  }
+
+private:
+  // read a column of current row by its name or ordinal
+  // compile time branching based on template type T
+  // I think it's better than using template specialization for this case
+  template <typename T, typename K>
+  inline std::optional<T> fetch(const K& key) const {
     if constexpr (std::is_same<T, bool>::value) {
-      return row_->readBool(col);
+      return row_->readBool(key);
     }
 
     if constexpr (std::is_same<T, int8_t>::value) {
-      return row_->readByte(col);
+      return row_->readByte(key);
     }
 
     if constexpr (std::is_same<T, int16_t>::value) {
-      return row_->readShort(col);
+      return row_->readShort(key);
     }
 
     if constexpr (std::is_same<T, int32_t>::value) {
-      return row_->readInt(col);
+      return row_->readInt(key);
     }
 
     if constexpr (std::is_same<T, int64_t>::value) {
-      return row_->readLong(col);
+      return row_->readLong(key);
     }
 
     if constexpr (std::is_same<T, float>::value) {
-      return row_->readFloat(col);
+      return row_->readFloat(key);
     }
 
     if constexpr (std::is_same<T, double>::value) {
-      return row_->readDouble(col);
+      return row_->readDouble(key);
     }
 
     if constexpr (std::is_same<T, int128_t>::value) {
-      return row_->readInt128(col);
+      return row_->readInt128(key);
     }
 
     if constexpr (std::is_same<T, std::string_view>::value) {
-      return row_->readString(col);
+      return row_->readString(key);
     }
 
     // TODO(cao): other types supported in DSL? for example: UDF on list or map
     throw NException("not supported template type");
   }
 
-#undef NULL_CHECK
-
-  inline ScriptContext& script() const {
-    return *script_;
-  }
-
 private:
   EvalContext(bool cache,
               std::shared_ptr<ScriptData> scriptData,
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <memory>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include <vector>
@@ -68,6 +69,16 @@ struct Histogram {
     count += other.count;
   }
 
+  // take out counters of a histogram merged before, value range is kept as is.
+  // it's only valid when the range is still covered, eg. the other is replaced by a grown one.
+  virtual inline void retract(const Histogram& other) {
+    count -= other.count;
+  }
+
+  virtual inline std::shared_ptr<Histogram> clone() const {
+    return std::make_shared<Histogram>(*this);
+  }
+
   std::string name;
   uint64_t count;
 };
@@ -92,6 +103,17 @@ struct BoolHistogram : public Histogram {
     trueValues += bh.trueValues;
   }
 
+  virtual inline void retract(const Histogram& other) override {
+    Histogram::retract(other);
+
+    auto bh = static_cast<const BoolHistogram&>(other);
+    trueValues -= bh.trueValues;
+  }
+
+  virtual inline std::shared_ptr<Histogram> clone() const override {
+    return std::make_shared<BoolHistogram>(*this);
+  }
+
   uint64_t trueValues;
 };
 
@@ -162,6 +184,18 @@ struct NumberHistogram : public Histogram {
     v_sum += nh.v_sum;
   }
 
+  virtual inline void retract(const Histogram& other) override {
+    N_ENSURE(name == other.name, "can not retract histogram for different field.");
+    Histogram::retract(other);
+
+    auto nh = static_cast<const NumberHistogram<T>&>(other);
+    v_sum -= nh.v_sum;
+  }
+
+  virtual inline std::shared_ptr<Histogram> clone() const override {
+    return std::make_shared<NumberHistogram<T>>(*this);
+  }
+
   T v_min;
   T v_max;
   T v_sum;
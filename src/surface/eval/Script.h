@@ -20,6 +20,7 @@
 
 #include "common/Finally.h"
 #include "common/Hash.h"
+#include "common/Likely.h"
 #include "surface/DataSurface.h"
 
 #include <quickjs.h>
@@ -198,6 +199,11 @@ public:
   }
 
   ~ScriptContext() {
+    // release all compiled function handles before the context goes away
+    for (auto& f : funcs_) {
+      JS_FreeValue(ctx_, f.second);
+    }
+
     // free the handlers
     js_std_free_handlers(rt_);
     JS_FreeContext(ctx_);
@@ -243,8 +249,61 @@ public: // API
     return true;
   }
 
+  // compile a function definition once and keep the function handle by its name,
+  // so that every invocation goes through JS_Call rather than parsing source text.
+  // a failed compile is recorded too, the name will not be compiled again.
+  bool compile(const std::string& name, const std::string& script) noexcept {
+    auto itr = funcs_.find(name);
+    if (itr != funcs_.end()) {
+      return JS_IsFunction(ctx_, itr->second);
+    }
+
+    // the definition could be var/let/const, evaluate its name to get the function object
+    JSValue func = JS_UNDEFINED;
+    if (evalDef(script)) {
+      func = eval_buf(ctx_, name);
+      if (JS_IsException(func)) {
+        js_std_dump_error(ctx_);
+        func = JS_UNDEFINED;
+      } else if (!JS_IsFunction(ctx_, func)) {
+        LOG(WARNING) << "Script does not define a function named: " << name;
+        JS_FreeValue(ctx_, func);
+        func = JS_UNDEFINED;
+      }
+    }
+
+    funcs_.emplace(name, func);
+    return JS_IsFunction(ctx_, func);
+  }
+
+  // invoke the function defined by given script without arguments and return the result
+  // the script is only compiled on first call
+  template <typename T>
+  std::optional<T> call(const std::string& name, const std::string& script) noexcept {
+    auto itr = funcs_.find(name);
+    if (N_UNLIKELY(itr == funcs_.end())) {
+      compile(name, script);
+      itr = funcs_.find(name);
+    }
+
+    if (N_UNLIKELY(!JS_IsFunction(ctx_, itr->second))) {
+      return std::nullopt;
+    }
+
+    JSValue val = JS_Call(ctx_, itr->second, JS_UNDEFINED, 0, nullptr);
+
+    // release this value to avoid leak
+    nebula::common::Finally onExit([ctx = ctx_, &val]() { JS_FreeValue(ctx, val); });
+
+    if (JS_IsException(val)) {
+      js_std_dump_error(ctx_);
+      return std::nullopt;
+    }
+
+    return convert<T>(val);
+  }
+
   // evaluate a script and return the result
-  // check its caller custom method in ValueEval.h
   template <typename T>
   std::optional<T> eval(const std::string& script) noexcept {
     JSValue val = eval_buf(ctx_, script);
@@ -257,6 +316,13 @@ public: // API
       return std::nullopt;
     }
 
+    return convert<T>(val);
+  }
+
+private:
+  // convert a JS value into desired native type
+  template <typename T>
+  std::optional<T> convert(const JSValue& val) noexcept {
 #define CONVERT_TYPE(DT, M)              \
   if constexpr (std::is_same_v<T, DT>) { \
     return (DT)M(val);                   \
@@ -296,6 +362,9 @@ private:
 
   // record if a script is already evaluated
   nebula::common::unordered_set<std::string> flags_;
+
+  // compiled function handles by name, JS_UNDEFINED if failed to compile
+  nebula::common::unordered_map<std::string, JSValue> funcs_;
   std::vector<std::string> strings_;
 };
 
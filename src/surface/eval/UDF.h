@@ -71,6 +71,17 @@ public:
       logic_{ std::move(logic) } {}
   virtual ~UDF() = default;
 
+  virtual void walk(const std::function<void(ValueEval&)>& visitor) override {
+    BaseType::walk(visitor);
+    expr_->walk(visitor);
+  }
+
+protected:
+  // the input expression of this UDF
+  inline const std::unique_ptr<nebula::surface::eval::ValueEval>& input() const {
+    return expr_;
+  }
+
 private:
   std::unique_ptr<nebula::surface::eval::ValueEval> expr_;
   Logic logic_;
@@ -112,6 +123,11 @@ public:
   }
   virtual ~UDAF() = default;
 
+  virtual void walk(const std::function<void(ValueEval&)>& visitor) override {
+    BaseType::walk(visitor);
+    expr_->walk(visitor);
+  }
+
 private:
   std::unique_ptr<ValueEval> expr_;
 };
@@ -16,6 +16,8 @@
 
 #include "ValueEval.h"
 
+#include <mutex>
+
 /**
  * This class is mostly placing all optimizations we can do at block level.
  * What do we have to support these fast decisions?
@@ -385,6 +387,82 @@ EvalBlock buildEvalBlock<LogicalOp::OR>(const std::unique_ptr<ValueEval>& left,
 
 #undef EvalBlock
 
+// match table of dictionary codes for every block, it's built once per block and shared by threads.
+// blocks are held by a query for its whole life, so a block address identifies a block in a kernel.
+class CodeMatches {
+  using Table = std::vector<uint8_t>;
+
+public:
+  std::shared_ptr<const Table> get(const Columnar& block,
+                                   const std::string& col,
+                                   const std::function<bool(std::string_view)>& pred) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto itr = tables_.find(&block);
+      if (itr != tables_.end()) {
+        return itr->second;
+      }
+    }
+
+    // evaluate every distinct value outside of the lock
+    const auto size = block.dictSize(col);
+    auto table = std::make_shared<Table>(size);
+    for (size_t code = 0; code < size; ++code) {
+      (*table)[code] = pred(block.dictItem(col, code));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tables_.emplace(&block, std::move(table)).first->second;
+  }
+
+private:
+  std::mutex mutex_;
+  nebula::common::unordered_map<const Columnar*, std::shared_ptr<const Table>> tables_;
+};
+
+EvalVector buildStringKernel(const std::unique_ptr<ValueEval>& expr, std::function<bool(std::string_view)> pred) {
+  if (expr->expressionType() != ExpressionType::COLUMN) {
+    return {};
+  }
+
+  // column expr signature is composed by "F:{col}"
+  std::string colName(expr->signature().substr(2));
+  return [name = std::move(colName), pred = std::move(pred), matches = std::make_shared<CodeMatches>()](
+           const Columnar& block, Selection& selection) -> bool {
+    const auto size = selection.size();
+    auto nulls = scratch<bool, 1>(size);
+    size_t count = 0;
+
+    // dictionary encoded column: filter rows by codes through the match table
+    if (block.dictSize(name) > 0) {
+      auto codes = scratch<int32_t>(size);
+      block.codes(name, selection, codes, nulls);
+      auto table = matches->get(block, name, pred);
+      const auto* match = table->data();
+      for (size_t i = 0; i < size; ++i) {
+        selection[count] = selection[i];
+        count += (!nulls[i]) & match[codes[i]];
+      }
+
+      selection.resize(count);
+      return true;
+    }
+
+    auto values = scratch<std::string_view>(size);
+    if (!block.read(name, selection, values, nulls)) {
+      return false;
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      selection[count] = selection[i];
+      count += !nulls[i] && pred(values[i]);
+    }
+
+    selection.resize(count);
+    return true;
+  };
+}
+
 } // namespace eval
 } // namespace surface
 } // namespace nebula
\ No newline at end of file
@@ -62,17 +62,22 @@ std::unique_ptr<ValueEval> constant(T v) {
 
 template <typename T>
 std::unique_ptr<ValueEval> column(const std::string& name) {
-  // this column name could be from custom result
-  return std::unique_ptr<ValueEval>(
+  // this column name could be from custom result, it's resolved by plan binding
+  auto binding = std::make_shared<Binding>(name);
+  auto ve = std::unique_ptr<ValueEval>(
     new TypeValueEval<T>(
       fmt::format("F:{0}", name),
       ExpressionType::COLUMN,
-      [name](EvalContext& ctx, const std::vector<std::unique_ptr<ValueEval>>&)
+      [b = binding.get()](EvalContext& ctx, const std::vector<std::unique_ptr<ValueEval>>&)
         -> std::optional<T> {
         // dedicate the read function to context as it knows how to handle special cases
-        return ctx.read<T>(name);
+        return ctx.read<T>(*b);
       },
       uncertain));
+
+  // the value eval owns the binding which outlives its lambda
+  ve->binding(std::move(binding));
+  return ve;
 }
 
 // run script to compute custom value
@@ -85,21 +90,12 @@ std::unique_ptr<ValueEval> custom(const std::string& name, const std::string& ex
       ExpressionType::SCRIPT,
       [name, expr](EvalContext& ctx, const std::vector<std::unique_ptr<ValueEval>>&)
         -> std::optional<T> {
-        // the first step is to evaluate the expression to ensure it works.
-        // an example is like "var {name} = () => nebula.column('x') + 2;"
-        // we don't need to evaluate this again and again - it should be cached
-        auto decl = ctx.script().evalDef(expr);
-
-        // only continue if current expression evaluated correctly
-        // expression evaluation will reutrn 0 and we don't check decl's value
-        // we are good as long as it's not nullopt
-        // next let's invote it ot get the value we want
-        if (decl) {
-          return ctx.script().eval<T>(fmt::format("{0}();", name));
-        }
-
-        // return the default value of this type
-        return std::nullopt;
+        // the expression defines a function named as the column, an example is like
+        // "var {name} = () => nebula.column('x') + 2;"
+        // it is compiled once per script context into a function handle,
+        // every row only invokes the handle rather than parsing any source text.
+        // NULL will be returned if the script fails to compile
+        return ctx.script().call<T>(name, expr);
       },
       uncertain));
 }
@@ -163,6 +159,108 @@ BEB_LOGICAL(OR)
 
 #undef BEB_LOGICAL
 
+// compare two values by given logical op
+template <LogicalOp op, typename T1, typename T2>
+inline bool compare(const T1& v1, const T2& v2) {
+  if constexpr (op == LogicalOp::EQ) {
+    return v1 == v2;
+  } else if constexpr (op == LogicalOp::NEQ) {
+    return v1 != v2;
+  } else if constexpr (op == LogicalOp::GT) {
+    return v1 > v2;
+  } else if constexpr (op == LogicalOp::GE) {
+    return v1 >= v2;
+  } else if constexpr (op == LogicalOp::LT) {
+    return v1 < v2;
+  } else if constexpr (op == LogicalOp::LE) {
+    return v1 <= v2;
+  } else if constexpr (op == LogicalOp::AND) {
+    return v1 && v2;
+  } else {
+    return v1 || v2;
+  }
+}
+
+// build vector kernel of a string predicate on a column expression, empty if the expression is not a column.
+// on a dictionary encoded column, the predicate runs once per distinct value and rows are filtered by codes.
+EvalVector buildStringKernel(const std::unique_ptr<ValueEval>&, std::function<bool(std::string_view)>);
+
+// build vector kernel based on left and right expression connected with logical op
+// "column op C" runs as a typed column kernel over the selection,
+// AND chains its children kernels, everything else falls back to row by row evaluation.
+template <LogicalOp op, typename T1, typename T2>
+EvalVector buildEvalVector(const std::unique_ptr<ValueEval>& left, const std::unique_ptr<ValueEval>& right) {
+  if constexpr (op == LogicalOp::AND) {
+    if (!left->kernel() && !right->kernel()) {
+      return {};
+    }
+
+    return [l = left.get(), r = right.get()](const Columnar& block, Selection& selection) -> bool {
+      // a child without kernel leaves the selection as is, so the result is not exact
+      bool exact = l->kernel() ? l->kernel()(block, selection) : false;
+      if (selection.empty()) {
+        return true;
+      }
+
+      return (r->kernel() ? r->kernel()(block, selection) : false) && exact;
+    };
+  } else if constexpr (op == LogicalOp::OR) {
+    return {};
+  } else {
+    if (left->expressionType() != ExpressionType::COLUMN
+        || right->expressionType() != ExpressionType::CONSTANT) {
+      return {};
+    }
+
+    // string column compares every distinct value once if it's dictionary encoded
+    if constexpr (std::is_same_v<T1, std::string_view>) {
+      EvalContext ctx{ false };
+      auto value = right->eval<T2>(ctx);
+      if (N_UNLIKELY(value == std::nullopt)) {
+        return [](const Columnar&, Selection& selection) -> bool {
+          selection.clear();
+          return true;
+        };
+      }
+
+      return buildStringKernel(left, [v = std::string(value.value())](std::string_view s) -> bool {
+        return compare<op>(s, std::string_view(v));
+      });
+    }
+
+    // compare with NULL constant never matches
+    EvalContext ctx{ false };
+    auto value = right->eval<T2>(ctx);
+    if (N_UNLIKELY(value == std::nullopt)) {
+      return [](const Columnar&, Selection& selection) -> bool {
+        selection.clear();
+        return true;
+      };
+    }
+
+    // column expr signature is composed by "F:{col}"
+    std::string colName(left->signature().substr(2));
+    return [name = std::move(colName), v = value.value()](const Columnar& block, Selection& selection) -> bool {
+      const auto size = selection.size();
+      auto values = scratch<T1>(size);
+      auto nulls = scratch<bool, 1>(size);
+      if (!block.read(name, selection, values, nulls)) {
+        return false;
+      }
+
+      // branch free compaction of the selection vector
+      size_t matches = 0;
+      for (size_t i = 0; i < size; ++i) {
+        selection[matches] = selection[i];
+        matches += (!nulls[i]) & compare<op>(values[i], v);
+      }
+
+      selection.resize(matches);
+      return true;
+    };
+  }
+}
+
 // TODO(cao) - merge with ARTHMETIC_VE since they are pretty much the same
 #define COMPARE_VE(NAME, SIGN, LOP)                                                               \
   template <typename T1, typename T2>                                                             \
@@ -170,11 +268,12 @@ BEB_LOGICAL(OR)
     const auto s1 = v1->signature();                                                              \
     const auto s2 = v2->signature();                                                              \
     auto eb = buildEvalBlock<LOP>(v1, v2);                                                        \
+    auto ev = buildEvalVector<LOP, T1, T2>(v1, v2);                                               \
     std::vector<std::unique_ptr<ValueEval>> branch;                                               \
     branch.reserve(2);                                                                            \
     branch.push_back(std::move(v1));                                                              \
     branch.push_back(std::move(v2));                                                              \
-    return std::unique_ptr<ValueEval>(                                                            \
+    auto ve = std::unique_ptr<ValueEval>(                                                         \
       new TypeValueEval<bool>(                                                                    \
         fmt::format("({0}{1}{2})", s1, #SIGN, s2),                                                \
         ExpressionType::LOGICAL,                                                                  \
@@ -190,6 +289,8 @@ BEB_LOGICAL(OR)
           return v1.value() SIGN v2.value();                                                      \
         }),                                                                                       \
         std::move(eb), {}, std::move(branch)));                                                   \
+    ve->kernel(std::move(ev));                                                                    \
+    return ve;                                                                                    \
   }
 
 COMPARE_VE(gt, >, LogicalOp::GT)
@@ -115,6 +115,38 @@ TEST(SurfaceTest, TestScriptContext) {
   }
 }
 
+TEST(SurfaceTest, TestScriptCompiledCall) {
+  const auto seed = Evidence::unix_timestamp();
+  nebula::surface::MockRowData mock(seed);
+  nebula::surface::MockAccessor mockA(seed);
+  nebula::surface::eval::ScriptContext script(
+    [&mockA]() -> const nebula::surface::Accessor& {
+      return mockA;
+    },
+    [](const std::string& col) -> auto {
+      if (col == "c") {
+        return nebula::type::Kind::INTEGER;
+      }
+
+      return nebula::type::Kind::INVALID;
+    });
+
+  // functions defined by var or const are both compiled into handles
+  const std::string x = "var x = () => nebula.column('c') - 100;";
+  const std::string z = "const z = () => nebula.column('c') + 1;";
+  EXPECT_TRUE(script.compile("x", x));
+  for (auto i = 0; i < 16; ++i) {
+    auto vx = script.call<int32_t>("x", x);
+    EXPECT_EQ(vx, mock.readInt("c") - 100);
+    auto vz = script.call<int32_t>("z", z);
+    EXPECT_EQ(vz, mock.readInt("c") + 1);
+  }
+
+  // not a function
+  EXPECT_FALSE(script.compile("w", "var w = 3;"));
+  EXPECT_EQ(script.call<int32_t>("w", "var w = 3;"), std::nullopt);
+}
+
 } // namespace test
 } // namespace surface
 } // namespace nebula
\ No newline at end of file